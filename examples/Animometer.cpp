@@ -159,7 +159,20 @@ void frame() {
     backbuffer.TransitionUsage(nxt::TextureUsageBit::Present);
     swapchain.Present(backbuffer);
     DoFlush();
-    fprintf(stderr, "frame %i\n", f);
+
+    static uint64_t lastIssued = 0;
+    static uint64_t lastSkipped = 0;
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+    if (GetBackendCallCounts(&issued, &skipped)) {
+        fprintf(stderr, "frame %i, state calls %llu (%llu skipped)\n", f,
+                static_cast<unsigned long long>(issued - lastIssued),
+                static_cast<unsigned long long>(skipped - lastSkipped));
+        lastIssued = issued;
+        lastSkipped = skipped;
+    } else {
+        fprintf(stderr, "frame %i\n", f);
+    }
 }
 
 int main(int argc, const char* argv[]) {
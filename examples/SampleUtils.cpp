@@ -15,6 +15,7 @@
 #include "SampleUtils.h"
 
 #include "common/Platform.h"
+#include "common/Trace.h"
 #include "utils/BackendBinding.h"
 #include "wire/TerribleCommandBuffer.h"
 
@@ -24,6 +25,7 @@
 #include "GLFW/glfw3.h"
 
 #include <cstring>
+#include <fstream>
 #include <iostream>
 
 void PrintDeviceError(const char* message, nxt::CallbackUserdata) {
@@ -59,6 +61,8 @@ static utils::BackendBinding* binding = nullptr;
 
 static GLFWwindow* window = nullptr;
 
+static std::ofstream traceFile;
+
 static nxt::wire::CommandHandler* wireServer = nullptr;
 static nxt::wire::CommandHandler* wireClient = nullptr;
 static nxt::wire::TerribleCommandBuffer* c2sBuf = nullptr;
@@ -128,6 +132,10 @@ nxt::TextureFormat GetPreferredSwapChainTextureFormat() {
     return static_cast<nxt::TextureFormat>(binding->GetPreferredSwapChainTextureFormat());
 }
 
+bool GetBackendCallCounts(uint64_t* issued, uint64_t* skipped) {
+    return binding->GetBackendCallCounts(issued, skipped);
+}
+
 nxt::SwapChain GetSwapChain(const nxt::Device &device) {
     return device.CreateSwapChainBuilder()
         .SetImplementation(GetSwapChainImplementation())
@@ -200,10 +208,24 @@ bool InitSample(int argc, const char** argv) {
             fprintf(stderr, "--command-buffer expects a command buffer name (none, terrible)\n");
             return false;
         }
+        if (std::string("-t") == argv[i] || std::string("--trace") == argv[i]) {
+            i++;
+            if (i < argc) {
+                traceFile.open(argv[i]);
+            }
+            if (!traceFile.is_open()) {
+                fprintf(stderr, "--trace expects a path to write the trace to\n");
+                return false;
+            }
+            traceFile << "[\n";
+            StartTracing();
+            continue;
+        }
         if (std::string("-h") == argv[i] || std::string("--help") == argv[i]) {
-            printf("Usage: %s [-b BACKEND] [-c COMMAND_BUFFER]\n", argv[0]);
+            printf("Usage: %s [-b BACKEND] [-c COMMAND_BUFFER] [-t TRACE_FILE]\n", argv[0]);
             printf("  BACKEND is one of: d3d12, metal, null, opengl, vulkan\n");
             printf("  COMMAND_BUFFER is one of: none, terrible\n");
+            printf("  TRACE_FILE receives a trace of the frames for chrome://tracing\n");
             return false;
         }
     }
@@ -215,6 +237,9 @@ void DoFlush() {
         c2sBuf->Flush();
         s2cBuf->Flush();
     }
+    if (traceFile.is_open()) {
+        FlushTraceEvents(traceFile);
+    }
     glfwPollEvents();
 }
 
@@ -25,6 +25,7 @@ struct GLFWwindow* GetGLFWWindow();
 nxt::Device CreateCppNXTDevice();
 uint64_t GetSwapChainImplementation();
 nxt::TextureFormat GetPreferredSwapChainTextureFormat();
+bool GetBackendCallCounts(uint64_t* issued, uint64_t* skipped);
 nxt::SwapChain GetSwapChain(const nxt::Device& device);
 nxt::TextureView CreateDefaultDepthStencilView(const nxt::Device& device);
 void GetNextRenderPassDescriptor(const nxt::Device& device,
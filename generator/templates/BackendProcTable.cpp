@@ -17,8 +17,11 @@
 
 #include "common/Assert.h"
 
+#include "backend/ProcProfiler.h"
 #include "backend/{{namespace}}/GeneratedCodeIncludes.h"
 
+#include <chrono>
+
 namespace backend {
 namespace {{namespace}} {
 
@@ -119,8 +122,8 @@ namespace {{namespace}} {
                     return true;
                 }
 
-                //* Entry point with validation
-                {{as_backendType(method.return_type)}} Validating{{suffix}}(
+                //* All the validation of the entry point, returns whether the call can be forwarded
+                bool Validate{{suffix}}(
                     {{-as_backendType(type)}} self
                     {%- for arg in method.arguments -%}
                         , {{as_annotated_backendType(arg)}}
@@ -156,26 +159,73 @@ namespace {{namespace}} {
                         }
                     {% endif %}
 
+                    return valid;
+                }
+
+                //* Entry point with validation
+                {{as_backendType(method.return_type)}} Validating{{suffix}}(
+                    {{-as_backendType(type)}} self
+                    {%- for arg in method.arguments -%}
+                        , {{as_annotated_backendType(arg)}}
+                    {%- endfor -%}
+                ) {
+                    bool valid = Validate{{suffix}}(self
+                        {%- for arg in method.arguments -%}
+                            , {{as_varName(arg.name)}}
+                        {%- endfor -%}
+                    );
+
                     {% if method.return_type.name.canonical_case() == "void" %}
                         if (!valid) return;
                     {% else %}
                         if (!valid) {
                             return {};
                         }
-                        auto result =
-                    {%- endif %}
-                    self->{{method.name.CamelCase()}}(
+                    {% endif %}
+                    return NonValidating{{suffix}}(self
                         {%- for arg in method.arguments -%}
-                            {%- if not loop.first %}, {% endif -%}
-                            {%- if arg.type.category in ["enum", "bitmask"] -%}
-                                static_cast<nxt::{{as_cppType(arg.type.name)}}>({{as_varName(arg.name)}})
-                            {%- else -%}
-                                {{as_varName(arg.name)}}
-                            {%- endif -%}
+                            , {{as_varName(arg.name)}}
                         {%- endfor -%}
                     );
-                    {% if method.return_type.name.canonical_case() != "void" %}
-                        return reinterpret_cast<{{as_backendType(method.return_type)}}>(result);
+                }
+
+                //* Entry point with validation that records its call count, validation failures
+                //* and CPU time in a profile.
+                {{as_backendType(method.return_type)}} Profiling{{suffix}}(
+                    {{-as_backendType(type)}} self
+                    {%- for arg in method.arguments -%}
+                        , {{as_annotated_backendType(arg)}}
+                    {%- endfor -%}
+                ) {
+                    static EntryPointProfile* profile = RegisterEntryPointProfile("{{as_cMethod(type.name, method.name)}}");
+                    auto callStart = std::chrono::steady_clock::now();
+
+                    bool valid = Validate{{suffix}}(self
+                        {%- for arg in method.arguments -%}
+                            , {{as_varName(arg.name)}}
+                        {%- endfor -%}
+                    );
+
+                    {% if method.return_type.name.canonical_case() == "void" %}
+                        if (valid) {
+                            NonValidating{{suffix}}(self
+                                {%- for arg in method.arguments -%}
+                                    , {{as_varName(arg.name)}}
+                                {%- endfor -%}
+                            );
+                        }
+                        profile->RecordCall(callStart, !valid);
+                    {% else %}
+                        {{as_backendType(method.return_type)}} result = {};
+                        if (valid) {
+                            result = NonValidating{{suffix}}(self
+                                {%- for arg in method.arguments -%}
+                                    , {{as_varName(arg.name)}}
+                                {%- endfor -%}
+                            );
+                        }
+                        profile->RecordCall(callStart, !valid);
+                        return result;
                     {% endif %}
                 }
             {% endfor %}
@@ -201,5 +251,15 @@ namespace {{namespace}} {
         {% endfor %}
         return table;
     }
+
+    nxtProcTable GetProfilingProcs() {
+        nxtProcTable table;
+        {% for type in by_category["object"] %}
+            {% for method in native_methods(type) %}
+                table.{{as_varName(type.name, method.name)}} = reinterpret_cast<{{as_cProc(type.name, method.name)}}>(Profiling{{as_MethodSuffix(type.name, method.name)}});
+            {% endfor %}
+        {% endfor %}
+        return table;
+    }
 }
 }
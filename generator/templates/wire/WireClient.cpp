@@ -267,7 +267,8 @@ namespace wire {
                         {% elif arg.type.category == "object" %}
                             auto {{argName}}Storage = reinterpret_cast<uint32_t*>(allocCmd->GetPtr_{{argName}}());
                             for (size_t i = 0; i < {{as_varName(arg.length.name)}}; i++) {
-                                {{argName}}Storage[i] = {{argName}}[i]->id;
+                                //* nullptr elements are sent as the reserved ID 0
+                                {{argName}}Storage[i] = {{argName}}[i] != nullptr ? {{argName}}[i]->id : 0;
                             }
                         {% else %}
                             memcpy(allocCmd->GetPtr_{{argName}}(), {{argName}}, {{as_varName(arg.length.name)}} * sizeof(*{{argName}}));
@@ -16,6 +16,7 @@
 #include "wire/WireCmd.h"
 
 #include "common/Assert.h"
+#include "common/Trace.h"
 
 #include <cstring>
 #include <vector>
@@ -206,6 +207,7 @@ namespace wire {
                 }
 
                 const uint8_t* HandleCommands(const uint8_t* commands, size_t size) override {
+                    NXT_TRACE_SCOPE("WireServer::HandleCommands");
                     mProcs.deviceTick(mKnownDevice.Get(1)->handle);
 
                     while (size > sizeof(WireCmd)) {
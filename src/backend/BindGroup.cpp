@@ -35,6 +35,10 @@ namespace backend {
         return mLayout.Get();
     }
 
+    BindGroupLayoutBase* BindGroupBase::GetLayout() {
+        return mLayout.Get();
+    }
+
     nxt::BindGroupUsage BindGroupBase::GetUsage() const {
         return mUsage;
     }
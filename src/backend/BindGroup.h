@@ -19,6 +19,7 @@
 #include "backend/Builder.h"
 #include "backend/Forward.h"
 #include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
 #include "common/Constants.h"
 
 #include "nxt/nxtcpp.h"
@@ -29,11 +30,14 @@
 
 namespace backend {
 
-    class BindGroupBase : public RefCounted {
+    class BindGroupBase : public RefCounted, public SlabAllocated<BindGroupBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "BindGroup";
+
         BindGroupBase(BindGroupBuilder* builder);
 
         const BindGroupLayoutBase* GetLayout() const;
+        BindGroupLayoutBase* GetLayout();
         nxt::BindGroupUsage GetUsage() const;
         BufferViewBase* GetBindingAsBufferView(size_t binding);
         SamplerBase* GetBindingAsSampler(size_t binding);
@@ -14,6 +14,7 @@
 
 #include "backend/BindGroupLayout.h"
 
+#include "backend/BindGroup.h"
 #include "backend/Device.h"
 #include "common/BitSetIterator.h"
 #include "common/HashUtils.h"
@@ -71,6 +72,38 @@ namespace backend {
         return mDevice;
     }
 
+    BindGroupBase* BindGroupLayoutBase::CreateBindGroup(nxt::BindGroupUsage usage,
+                                                        uint32_t bindingCount,
+                                                        BufferViewBase* const* bufferViews,
+                                                        SamplerBase* const* samplers,
+                                                        TextureViewBase* const* textureViews) {
+        // The builder is only used to share the validation with the builder path and doesn't
+        // need to be heap allocated.
+        BindGroupBuilder builder(mDevice);
+        builder.SetLayout(this);
+        builder.SetUsage(usage);
+
+        if (bindingCount > kMaxBindingsPerGroup) {
+            builder.HandleError("Binding count over maximum number of bindings");
+        }
+
+        // Bindings are set one at a time, stopping at the first error because setters must not
+        // be called on a builder that has an error.
+        for (uint32_t binding = 0; binding < bindingCount && builder.CanBeUsed(); ++binding) {
+            if (bufferViews[binding] != nullptr) {
+                builder.SetBufferViews(binding, 1, &bufferViews[binding]);
+            }
+            if (samplers[binding] != nullptr && builder.CanBeUsed()) {
+                builder.SetSamplers(binding, 1, &samplers[binding]);
+            }
+            if (textureViews[binding] != nullptr && builder.CanBeUsed()) {
+                builder.SetTextureViews(binding, 1, &textureViews[binding]);
+            }
+        }
+
+        return builder.TryGetResult();
+    }
+
     // BindGroupLayoutBuilder
 
     BindGroupLayoutBuilder::BindGroupLayoutBuilder(DeviceBase* device) : Builder(device) {
@@ -24,6 +24,7 @@
 
 #include <array>
 #include <bitset>
+#include <type_traits>
 
 namespace backend {
 
@@ -41,6 +42,29 @@ namespace backend {
 
         DeviceBase* GetDevice() const;
 
+        // NXT API
+        // Creates a bind group using this layout without allocating a builder. Binding i is set
+        // with element i of whichever array has a non-null element there.
+        template <typename BV, typename S, typename TV>
+        BindGroupBase* CreateBindGroup(nxt::BindGroupUsage usage,
+                                       uint32_t bindingCount,
+                                       BV* const* bufferViews,
+                                       S* const* samplers,
+                                       TV* const* textureViews) {
+            static_assert(std::is_base_of<BufferViewBase, BV>::value, "");
+            static_assert(std::is_base_of<SamplerBase, S>::value, "");
+            static_assert(std::is_base_of<TextureViewBase, TV>::value, "");
+            return CreateBindGroup(usage, bindingCount,
+                                   reinterpret_cast<BufferViewBase* const*>(bufferViews),
+                                   reinterpret_cast<SamplerBase* const*>(samplers),
+                                   reinterpret_cast<TextureViewBase* const*>(textureViews));
+        }
+        BindGroupBase* CreateBindGroup(nxt::BindGroupUsage usage,
+                                       uint32_t bindingCount,
+                                       BufferViewBase* const* bufferViews,
+                                       SamplerBase* const* samplers,
+                                       TextureViewBase* const* textureViews);
+
       private:
         DeviceBase* mDevice;
         LayoutBindingInfo mBindingInfo;
@@ -42,6 +42,14 @@ namespace backend {
         return new BufferViewBuilder(mDevice, this);
     }
 
+    BufferViewBase* BufferBase::CreateBufferView(uint32_t offset, uint32_t size) {
+        // The builder is only used to share the validation with the builder path and doesn't
+        // need to be heap allocated.
+        BufferViewBuilder builder(mDevice, this);
+        builder.SetExtent(offset, size);
+        return builder.TryGetResult();
+    }
+
     DeviceBase* BufferBase::GetDevice() const {
         return mDevice;
     }
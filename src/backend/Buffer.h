@@ -18,13 +18,16 @@
 #include "backend/Builder.h"
 #include "backend/Forward.h"
 #include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
 
 #include "nxt/nxtcpp.h"
 
 namespace backend {
 
-    class BufferBase : public RefCounted {
+    class BufferBase : public RefCounted, public SlabAllocated<BufferBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "Buffer";
+
         BufferBase(BufferBuilder* builder);
         ~BufferBase();
 
@@ -41,6 +44,7 @@ namespace backend {
 
         // NXT API
         BufferViewBuilder* CreateBufferViewBuilder();
+        BufferViewBase* CreateBufferView(uint32_t offset, uint32_t size);
         void SetSubData(uint32_t start, uint32_t count, const uint8_t* data);
         void MapReadAsync(uint32_t start,
                           uint32_t size,
@@ -104,8 +108,10 @@ namespace backend {
         int mPropertiesSet = 0;
     };
 
-    class BufferViewBase : public RefCounted {
+    class BufferViewBase : public RefCounted, public SlabAllocated<BufferViewBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "BufferView";
+
         BufferViewBase(BufferViewBuilder* builder);
 
         BufferBase* GetBuffer();
@@ -17,6 +17,8 @@
 
 #include "backend/Forward.h"
 #include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
+#include "common/Assert.h"
 
 #include "nxt/nxtcpp.h"
 
@@ -35,8 +37,10 @@ namespace backend {
     // builder "set" function performance validation inline. Because of this we have to store the
     // status in the builder and defer calling the callback to GetResult.
 
-    class BuilderBase : public RefCounted {
+    class BuilderBase : public RefCounted, public SlabAllocated<BuilderBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "Builder";
+
         // Used by the auto-generated validation to prevent usage of the builder
         // after GetResult or an error.
         bool CanBeUsed() const;
@@ -83,6 +87,11 @@ namespace backend {
         // NXT API
         T* GetResult();
 
+        // Used by the builder-free creation entry points that drive a builder on the stack. Like
+        // GetResult but also handles errors that happened while setting the properties, which
+        // the autogenerated validation does for GetResult.
+        T* TryGetResult();
+
       protected:
         using BuilderBase::BuilderBase;
 
@@ -102,6 +111,16 @@ namespace backend {
         }
     }
 
+    template <typename T>
+    T* Builder<T>::TryGetResult() {
+        if (!CanBeUsed()) {
+            bool shouldBeFalse = HandleResult(nullptr);
+            ASSERT(shouldBeFalse == false);
+            return nullptr;
+        }
+        return GetResult();
+    }
+
 }  // namespace backend
 
 #endif  // BACKEND_BUILDER_H_
@@ -24,6 +24,7 @@
 #include "backend/PipelineLayout.h"
 #include "backend/RenderPipeline.h"
 #include "backend/Texture.h"
+#include "common/Trace.h"
 
 #include <cstring>
 #include <map>
@@ -354,6 +355,7 @@ namespace backend {
     }
 
     bool CommandBufferBuilder::ValidateGetResult() {
+        NXT_TRACE_SCOPE("CommandBufferBuilder::ValidateGetResult");
         MoveToIterator();
 
         Command type;
@@ -20,6 +20,7 @@
 #include "backend/Builder.h"
 #include "backend/CommandAllocator.h"
 #include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
 
 #include <memory>
 #include <set>
@@ -38,8 +39,10 @@ namespace backend {
 
     class CommandBufferBuilder;
 
-    class CommandBufferBase : public RefCounted {
+    class CommandBufferBase : public RefCounted, public SlabAllocated<CommandBufferBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "CommandBuffer";
+
         CommandBufferBase(CommandBufferBuilder* builder);
         bool ValidateResourceUsagesImmediate();
 
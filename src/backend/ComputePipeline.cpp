@@ -15,6 +15,7 @@
 #include "backend/ComputePipeline.h"
 
 #include "backend/Device.h"
+#include "common/Trace.h"
 
 namespace backend {
 
@@ -35,6 +36,7 @@ namespace backend {
     }
 
     ComputePipelineBase* ComputePipelineBuilder::GetResultImpl() {
+        NXT_TRACE_SCOPE("ComputePipelineBuilder::GetResult");
         return mDevice->CreateComputePipeline(this);
     }
 
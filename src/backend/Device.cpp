@@ -30,7 +30,9 @@
 #include "backend/ShaderModule.h"
 #include "backend/SwapChain.h"
 #include "backend/Texture.h"
+#include "common/Trace.h"
 
+#include <mutex>
 #include <unordered_set>
 
 namespace backend {
@@ -41,11 +43,62 @@ namespace backend {
     // to compare the value of the objects, instead of the pointers.
     using BindGroupLayoutCache = std::
         unordered_set<BindGroupLayoutBase*, BindGroupLayoutCacheFuncs, BindGroupLayoutCacheFuncs>;
+    using PipelineLayoutCache = std::
+        unordered_set<PipelineLayoutBase*, PipelineLayoutCacheFuncs, PipelineLayoutCacheFuncs>;
 
+    // The caches can be used from multiple threads so they are protected by a mutex. The
+    // objects are looked up and created while holding it so that two threads creating the same
+    // object get the same one.
     struct DeviceBase::Caches {
+        std::mutex mutex;
         BindGroupLayoutCache bindGroupLayouts;
+        PipelineLayoutCache pipelineLayouts;
+
+        // The layout of pipelines created without one, kept alive for the lifetime of the device.
+        std::once_flag defaultPipelineLayoutOnce;
+        Ref<PipelineLayoutBase> defaultPipelineLayout;
     };
 
+    namespace {
+
+        // Returns the object of the cache equal to the blueprint with an added external
+        // reference, or nullptr if there is none. Must be called with the cache mutex held.
+        template <typename T, typename Cache>
+        T* FindInCache(Cache* cache, const T* blueprint) {
+            // The blueprint is only used to search in the cache and is not modified. However
+            // cached objects can be modified, and unordered_set cannot search for a const pointer
+            // in a non const pointer set. That's why we do a const_cast here, but the blueprint
+            // won't be modified.
+            auto iter = cache->find(const_cast<T*>(blueprint));
+            if (iter == cache->end()) {
+                return nullptr;
+            }
+
+            T* cachedObj = *iter;
+            if (cachedObj->TryReferenceInternal()) {
+                cachedObj->Reference();
+                cachedObj->ReleaseInternal();
+                return cachedObj;
+            }
+
+            // The last reference to the cached object was released on another thread which is
+            // about to uncache it. Remove it so that it is replaced with a new object.
+            cache->erase(iter);
+            return nullptr;
+        }
+
+        // Must be called with the cache mutex held.
+        template <typename T, typename Cache>
+        void RemoveFromCache(Cache* cache, T* obj) {
+            // The object might have been replaced in the cache already, see FindInCache.
+            auto iter = cache->find(obj);
+            if (iter != cache->end() && *iter == obj) {
+                cache->erase(iter);
+            }
+        }
+
+    }  // anonymous namespace
+
     // DeviceBase
 
     DeviceBase::DeviceBase() {
@@ -75,14 +128,11 @@ namespace backend {
     BindGroupLayoutBase* DeviceBase::GetOrCreateBindGroupLayout(
         const BindGroupLayoutBase* blueprint,
         BindGroupLayoutBuilder* builder) {
-        // The blueprint is only used to search in the cache and is not modified. However cached
-        // objects can be modified, and unordered_set cannot search for a const pointer in a non
-        // const pointer set. That's why we do a const_cast here, but the blueprint won't be
-        // modified.
-        auto iter = mCaches->bindGroupLayouts.find(const_cast<BindGroupLayoutBase*>(blueprint));
-        if (iter != mCaches->bindGroupLayouts.end()) {
-            (*iter)->Reference();
-            return *iter;
+        std::lock_guard<std::mutex> lock(mCaches->mutex);
+
+        BindGroupLayoutBase* cachedObj = FindInCache(&mCaches->bindGroupLayouts, blueprint);
+        if (cachedObj != nullptr) {
+            return cachedObj;
         }
 
         BindGroupLayoutBase* backendObj = CreateBindGroupLayout(builder);
@@ -91,7 +141,38 @@ namespace backend {
     }
 
     void DeviceBase::UncacheBindGroupLayout(BindGroupLayoutBase* obj) {
-        mCaches->bindGroupLayouts.erase(obj);
+        std::lock_guard<std::mutex> lock(mCaches->mutex);
+        RemoveFromCache(&mCaches->bindGroupLayouts, obj);
+    }
+
+    PipelineLayoutBase* DeviceBase::GetOrCreatePipelineLayout(const PipelineLayoutBase* blueprint,
+                                                              PipelineLayoutBuilder* builder) {
+        std::lock_guard<std::mutex> lock(mCaches->mutex);
+
+        PipelineLayoutBase* cachedObj = FindInCache(&mCaches->pipelineLayouts, blueprint);
+        if (cachedObj != nullptr) {
+            return cachedObj;
+        }
+
+        PipelineLayoutBase* backendObj = CreatePipelineLayout(builder);
+        mCaches->pipelineLayouts.insert(backendObj);
+        return backendObj;
+    }
+
+    void DeviceBase::UncachePipelineLayout(PipelineLayoutBase* obj) {
+        std::lock_guard<std::mutex> lock(mCaches->mutex);
+        RemoveFromCache(&mCaches->pipelineLayouts, obj);
+    }
+
+    PipelineLayoutBase* DeviceBase::GetDefaultPipelineLayout() {
+        std::call_once(mCaches->defaultPipelineLayoutOnce, [this]() {
+            PipelineLayoutBuilder* builder = CreatePipelineLayoutBuilder();
+            mCaches->defaultPipelineLayout = builder->GetResult();
+            // Remove the external ref objects are created with
+            mCaches->defaultPipelineLayout->Release();
+            builder->Release();
+        });
+        return mCaches->defaultPipelineLayout.Get();
     }
 
     BindGroupBuilder* DeviceBase::CreateBindGroupBuilder() {
@@ -144,18 +225,33 @@ namespace backend {
     }
 
     void DeviceBase::Tick() {
+        NXT_TRACE_SCOPE("Device::Tick");
         TickImpl();
     }
 
+    Serial DeviceBase::GetLastSubmittedSerial() const {
+        return 0;
+    }
+
+    Serial DeviceBase::GetCompletedSerial() const {
+        return 0;
+    }
+
+    bool DeviceBase::WaitForSerial(Serial serial, uint64_t) {
+        return serial <= GetCompletedSerial();
+    }
+
     void DeviceBase::Reference() {
         ASSERT(mRefCount != 0);
-        mRefCount++;
+        mRefCount.fetch_add(1, std::memory_order_relaxed);
     }
 
     void DeviceBase::Release() {
         ASSERT(mRefCount != 0);
-        mRefCount--;
-        if (mRefCount == 0) {
+        if (mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Objects kept alive by the device must be destroyed while the backend device still
+            // exists.
+            mCaches->defaultPipelineLayout = nullptr;
             delete this;
         }
     }
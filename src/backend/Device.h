@@ -17,13 +17,36 @@
 
 #include "backend/Forward.h"
 #include "backend/RefCounted.h"
+#include "common/Serial.h"
 
 #include "nxt/nxtcpp.h"
 
+#include <atomic>
+
 namespace backend {
 
     using ErrorCallback = void (*)(const char* errorMessage, void* userData);
 
+    // Threading model: the device, queue, swapchains and the resources whose state changes
+    // (buffers and textures, with their usage transitions and mapping) must be used from a single
+    // thread at a time, usually the one submitting, called the device thread below. The following
+    // can be used from any thread:
+    //  - Adding and removing references to all objects, except removing the last reference.
+    //    Destroying an object runs backend code that uses device-wide state, for example the
+    //    Vulkan FencedDeleter, framebuffer cache and descriptor set recycling, so the last
+    //    reference must be released on the device thread. The exceptions are builders and
+    //    command buffers whose destruction only releases references to the objects they use.
+    //    Objects used on other threads must stay referenced by the device thread until the other
+    //    threads are done with them.
+    //  - Creating builders from the device.
+    //  - Builders, each one being used by a single thread at a time. This makes it possible to
+    //    record a CommandBufferBuilder per thread, as long as the resources it uses don't change
+    //    usage or get mapped on another thread while it records and validates.
+    //  - Once created, the objects that are immutable: bind group layouts, bind groups, blend
+    //    states, depth stencil states, input states, pipeline layouts, pipelines, samplers,
+    //    shader modules, buffer views, texture views and command buffers.
+    // Backends might have stricter requirements for the creation of objects other than command
+    // buffers, as it can use device-wide state such as the Vulkan render pass cache.
     class DeviceBase {
       public:
         DeviceBase();
@@ -57,6 +80,14 @@ namespace backend {
 
         virtual void TickImpl() = 0;
 
+        // Every submit to the queue is associated with an increasing serial. The defaults are
+        // for backends that don't track GPU progress and report all the work as completed.
+        virtual Serial GetLastSubmittedSerial() const;
+        virtual Serial GetCompletedSerial() const;
+        // Blocks until the work of the submit with the given serial has completed on the GPU
+        // or until timeoutNs nanoseconds have passed. Returns whether the serial completed.
+        virtual bool WaitForSerial(Serial serial, uint64_t timeoutNs);
+
         // Many NXT objects are completely immutable once created which means that if two
         // builders are given the same arguments, they can return the same object. Reusing
         // objects will help make comparisons between objects by a single pointer comparison.
@@ -74,6 +105,13 @@ namespace backend {
         BindGroupLayoutBase* GetOrCreateBindGroupLayout(const BindGroupLayoutBase* blueprint,
                                                         BindGroupLayoutBuilder* builder);
         void UncacheBindGroupLayout(BindGroupLayoutBase* obj);
+        PipelineLayoutBase* GetOrCreatePipelineLayout(const PipelineLayoutBase* blueprint,
+                                                      PipelineLayoutBuilder* builder);
+        void UncachePipelineLayout(PipelineLayoutBase* obj);
+
+        // The empty pipeline layout used by pipelines created without a layout. It is created on
+        // first use and lives as long as the device.
+        PipelineLayoutBase* GetDefaultPipelineLayout();
 
         // NXT API
         BindGroupBuilder* CreateBindGroupBuilder();
@@ -106,7 +144,7 @@ namespace backend {
 
         nxt::DeviceErrorCallback mErrorCallback = nullptr;
         nxt::CallbackUserdata mErrorUserdata = 0;
-        uint32_t mRefCount = 1;
+        std::atomic<uint32_t> mRefCount{1};
     };
 
 }  // namespace backend
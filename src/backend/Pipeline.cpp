@@ -27,12 +27,7 @@ namespace backend {
     PipelineBase::PipelineBase(PipelineBuilder* builder)
         : mStageMask(builder->mStageMask), mLayout(std::move(builder->mLayout)) {
         if (!mLayout) {
-            mLayout = builder->GetParentBuilder()
-                          ->GetDevice()
-                          ->CreatePipelineLayoutBuilder()
-                          ->GetResult();
-            // Remove the external ref objects are created with
-            mLayout->Release();
+            mLayout = builder->GetParentBuilder()->GetDevice()->GetDefaultPipelineLayout();
         }
 
         auto FillPushConstants = [](const ShaderModuleBase* module, PushConstantInfo* info) {
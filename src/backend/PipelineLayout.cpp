@@ -17,13 +17,27 @@
 #include "backend/BindGroupLayout.h"
 #include "backend/Device.h"
 #include "common/Assert.h"
+#include "common/HashUtils.h"
+#include "common/Math.h"
 
 namespace backend {
 
     // PipelineLayoutBase
 
-    PipelineLayoutBase::PipelineLayoutBase(PipelineLayoutBuilder* builder)
-        : mBindGroupLayouts(std::move(builder->mBindGroupLayouts)), mMask(builder->mMask) {
+    // The bind group layouts are copied instead of moved because the blueprint is created from
+    // the builder before the backend object.
+    PipelineLayoutBase::PipelineLayoutBase(PipelineLayoutBuilder* builder, bool blueprint)
+        : mBindGroupLayouts(builder->mBindGroupLayouts),
+          mMask(builder->mMask),
+          mDevice(builder->mDevice),
+          mIsBlueprint(blueprint) {
+    }
+
+    PipelineLayoutBase::~PipelineLayoutBase() {
+        // Do not register the actual cached object if we are a blueprint
+        if (!mIsBlueprint) {
+            mDevice->UncachePipelineLayout(this);
+        }
     }
 
     const BindGroupLayoutBase* PipelineLayoutBase::GetBindGroupLayout(size_t group) const {
@@ -41,6 +55,13 @@ namespace backend {
     }
 
     uint32_t PipelineLayoutBase::GroupsInheritUpTo(const PipelineLayoutBase* other) const {
+        // Pipeline layouts are deduplicated so identical layouts are the same object, that
+        // inherits all its groups up to the first one that isn't set.
+        if (other == this) {
+            return mMask.all() ? kMaxBindGroups + 1
+                               : ScanForward(static_cast<uint32_t>(~mMask.to_ulong()));
+        }
+
         for (uint32_t i = 0; i < kMaxBindGroups; ++i) {
             if (!mMask[i] || mBindGroupLayouts[i].Get() != other->mBindGroupLayouts[i].Get()) {
                 return i;
@@ -67,7 +88,8 @@ namespace backend {
             }
         }
 
-        return mDevice->CreatePipelineLayout(this);
+        PipelineLayoutBase blueprint(this, true);
+        return mDevice->GetOrCreatePipelineLayout(&blueprint, this);
     }
 
     void PipelineLayoutBuilder::SetBindGroupLayout(uint32_t groupIndex,
@@ -85,4 +107,29 @@ namespace backend {
         mMask.set(groupIndex);
     }
 
+    // PipelineLayoutCacheFuncs
+
+    size_t PipelineLayoutCacheFuncs::operator()(const PipelineLayoutBase* layout) const {
+        // Bind group layouts are deduplicated so they can be hashed and compared by pointer.
+        size_t hash = Hash(layout->GetBindGroupsLayoutMask());
+        for (size_t group = 0; group < kMaxBindGroups; ++group) {
+            HashCombine(&hash, layout->GetBindGroupLayout(group));
+        }
+        return hash;
+    }
+
+    bool PipelineLayoutCacheFuncs::operator()(const PipelineLayoutBase* a,
+                                              const PipelineLayoutBase* b) const {
+        if (a->GetBindGroupsLayoutMask() != b->GetBindGroupsLayoutMask()) {
+            return false;
+        }
+
+        for (size_t group = 0; group < kMaxBindGroups; ++group) {
+            if (a->GetBindGroupLayout(group) != b->GetBindGroupLayout(group)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
 }  // namespace backend
@@ -31,7 +31,8 @@ namespace backend {
 
     class PipelineLayoutBase : public RefCounted {
       public:
-        PipelineLayoutBase(PipelineLayoutBuilder* builder);
+        PipelineLayoutBase(PipelineLayoutBuilder* builder, bool blueprint = false);
+        ~PipelineLayoutBase() override;
 
         const BindGroupLayoutBase* GetBindGroupLayout(size_t group) const;
         const std::bitset<kMaxBindGroups> GetBindGroupsLayoutMask() const;
@@ -47,6 +48,10 @@ namespace backend {
       protected:
         BindGroupLayoutArray mBindGroupLayouts;
         std::bitset<kMaxBindGroups> mMask;
+
+      private:
+        DeviceBase* mDevice;
+        bool mIsBlueprint = false;
     };
 
     class PipelineLayoutBuilder : public Builder<PipelineLayoutBase> {
@@ -65,6 +70,15 @@ namespace backend {
         std::bitset<kMaxBindGroups> mMask;
     };
 
+    // Implements the functors necessary for the unordered_set<PipelineLayoutBase*>-based cache.
+    struct PipelineLayoutCacheFuncs {
+        // The hash function
+        size_t operator()(const PipelineLayoutBase* layout) const;
+
+        // The equality predicate
+        bool operator()(const PipelineLayoutBase* a, const PipelineLayoutBase* b) const;
+    };
+
 }  // namespace backend
 
 #endif  // BACKEND_PIPELINELAYOUT_H_
@@ -0,0 +1,173 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/ProcProfiler.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace backend {
+
+    namespace {
+
+        class ProfileRegistry {
+          public:
+            ~ProfileRegistry() {
+                Write(std::cerr);
+            }
+
+            EntryPointProfile* Register(const char* name) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mProfiles.push_back(std::make_unique<EntryPointProfile>(name));
+                return mProfiles.back().get();
+            }
+
+            void Write(std::ostream& stream) {
+                std::vector<const EntryPointProfile*> profiles;
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (const auto& profile : mProfiles) {
+                    if (profile->GetCallCount() != 0) {
+                        profiles.push_back(profile.get());
+                    }
+                }
+
+                // Show the entry points where the most time is spent first.
+                std::sort(profiles.begin(), profiles.end(),
+                          [](const EntryPointProfile* a, const EntryPointProfile* b) {
+                              return a->GetTotalTimeNs() > b->GetTotalTimeNs();
+                          });
+
+                for (const EntryPointProfile* profile : profiles) {
+                    stream << profile->GetName() << ": calls=" << profile->GetCallCount()
+                           << " validationFailures=" << profile->GetValidationFailureCount()
+                           << " totalNs=" << profile->GetTotalTimeNs()
+                           << " p50Ns=" << profile->GetPercentileTimeNs(50.0)
+                           << " p90Ns=" << profile->GetPercentileTimeNs(90.0)
+                           << " p99Ns=" << profile->GetPercentileTimeNs(99.0) << std::endl;
+                }
+            }
+
+          private:
+            // Entry points register their profile on their first call, which can happen on any
+            // thread.
+            std::mutex mMutex;
+            std::vector<std::unique_ptr<EntryPointProfile>> mProfiles;
+        };
+
+        ProfileRegistry* GetRegistry() {
+            static ProfileRegistry registry;
+            return &registry;
+        }
+
+    }  // anonymous namespace
+
+    // EntryPointProfile
+
+    EntryPointProfile::EntryPointProfile(const char* name)
+        : mName(name), mCallCount(0), mValidationFailureCount(0), mTotalTimeNs(0) {
+        for (std::atomic<uint64_t>& count : mHistogram) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void EntryPointProfile::RecordCall(std::chrono::steady_clock::time_point start,
+                                       bool validationFailed) {
+        auto duration = std::chrono::steady_clock::now() - start;
+        RecordCall(static_cast<uint64_t>(
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()),
+                   validationFailed);
+    }
+
+    void EntryPointProfile::RecordCall(uint64_t durationNs, bool validationFailed) {
+        // The counters are only read when writing the profile, they don't need to be ordered with
+        // anything else.
+        mCallCount.fetch_add(1, std::memory_order_relaxed);
+        if (validationFailed) {
+            mValidationFailureCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        mTotalTimeNs.fetch_add(durationNs, std::memory_order_relaxed);
+
+        // Bucket i contains the durations in [2^(i-1), 2^i - 1], bucket 0 is for 0ns.
+        size_t bucket = 0;
+        while (bucket < kBucketCount - 1 && (durationNs >> bucket) != 0) {
+            bucket++;
+        }
+        mHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const char* EntryPointProfile::GetName() const {
+        return mName;
+    }
+
+    uint64_t EntryPointProfile::GetCallCount() const {
+        return mCallCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t EntryPointProfile::GetValidationFailureCount() const {
+        return mValidationFailureCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t EntryPointProfile::GetTotalTimeNs() const {
+        return mTotalTimeNs.load(std::memory_order_relaxed);
+    }
+
+    uint64_t EntryPointProfile::GetPercentileTimeNs(double percentile) const {
+        ASSERT(percentile >= 0.0 && percentile <= 100.0);
+
+        // Calls can be recorded concurrently, so use a snapshot of the histogram and its own total
+        // instead of the call count.
+        std::array<uint64_t, kBucketCount> histogram;
+        uint64_t callCount = 0;
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            histogram[bucket] = mHistogram[bucket].load(std::memory_order_relaxed);
+            callCount += histogram[bucket];
+        }
+        if (callCount == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * callCount);
+        rank = std::max(rank, uint64_t(1));
+
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            seen += histogram[bucket];
+            if (seen >= rank) {
+                return bucket == 0 ? 0 : (uint64_t(1) << bucket) - 1;
+            }
+        }
+        UNREACHABLE();
+        return 0;
+    }
+
+    EntryPointProfile* RegisterEntryPointProfile(const char* name) {
+        return GetRegistry()->Register(name);
+    }
+
+    bool IsProcProfilingEnabled() {
+        static bool enabled = getenv("NXT_PROFILE_PROCS") != nullptr;
+        return enabled;
+    }
+
+    void WriteProcProfile(std::ostream& stream) {
+        GetRegistry()->Write(stream);
+    }
+
+}  // namespace backend
@@ -0,0 +1,67 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_PROCPROFILER_H_
+#define BACKEND_PROCPROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace backend {
+
+    // Statistics of a single entry point, recorded by the procs returned by GetProfilingProcs.
+    // Entry points can be called from several threads so the counters are atomic. They are
+    // updated independently, so a profile read during calls can be slightly inconsistent.
+    class EntryPointProfile {
+      public:
+        EntryPointProfile(const char* name);
+
+        void RecordCall(std::chrono::steady_clock::time_point start, bool validationFailed);
+        void RecordCall(uint64_t durationNs, bool validationFailed);
+
+        const char* GetName() const;
+        uint64_t GetCallCount() const;
+        uint64_t GetValidationFailureCount() const;
+        uint64_t GetTotalTimeNs() const;
+        // Durations are bucketed by power of two so this returns an upper bound of the
+        // percentile, which is between 0 and 100.
+        uint64_t GetPercentileTimeNs(double percentile) const;
+
+      private:
+        static constexpr size_t kBucketCount = 64;
+
+        const char* mName;
+        std::atomic<uint64_t> mCallCount;
+        std::atomic<uint64_t> mValidationFailureCount;
+        std::atomic<uint64_t> mTotalTimeNs;
+        std::array<std::atomic<uint64_t>, kBucketCount> mHistogram;
+    };
+
+    // Returns the profile of the entry point, which lives until the end of the program. The
+    // profiles of the entry points that were called are written to stderr at exit.
+    EntryPointProfile* RegisterEntryPointProfile(const char* name);
+
+    // Whether backends should use the profiling procs, set with the NXT_PROFILE_PROCS
+    // environment variable.
+    bool IsProcProfilingEnabled();
+
+    // Writes a line per called entry point with its counters and time percentiles.
+    void WriteProcProfile(std::ostream& stream);
+
+}  // namespace backend
+
+#endif  // BACKEND_PROCPROFILER_H_
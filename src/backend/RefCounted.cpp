@@ -28,21 +28,32 @@ namespace backend {
         ASSERT(mInternalRefs != 0);
 
         // TODO(cwallez@chromium.org): what to do on overflow?
-        mInternalRefs++;
+        mInternalRefs.fetch_add(1, std::memory_order_relaxed);
     }
 
     void RefCounted::ReleaseInternal() {
         ASSERT(mInternalRefs != 0);
 
-        mInternalRefs--;
-
-        if (mInternalRefs == 0) {
+        // The release ordering makes the uses of the object by this thread happen before its
+        // deletion, and the acquire ordering makes the deletion see the uses by other threads.
+        if (mInternalRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             ASSERT(mExternalRefs == 0);
-            // TODO(cwallez@chromium.org): would this work with custom allocators?
+            // Frequently created types return their memory to a SlabAllocator here, through the
+            // operator delete of SlabAllocated.
             delete this;
         }
     }
 
+    bool RefCounted::TryReferenceInternal() {
+        uint32_t refs = mInternalRefs.load(std::memory_order_relaxed);
+        do {
+            if (refs == 0) {
+                return false;
+            }
+        } while (!mInternalRefs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed));
+        return true;
+    }
+
     uint32_t RefCounted::GetExternalRefs() const {
         return mExternalRefs;
     }
@@ -55,21 +66,18 @@ namespace backend {
         ASSERT(mInternalRefs != 0);
 
         // mExternalRefs != 0 counts as one internal ref.
-        if (mExternalRefs == 0) {
+        // TODO(cwallez@chromium.org): what to do on overflow?
+        if (mExternalRefs.fetch_add(1, std::memory_order_relaxed) == 0) {
             ReferenceInternal();
         }
-
-        // TODO(cwallez@chromium.org): what to do on overflow?
-        mExternalRefs++;
     }
 
     void RefCounted::Release() {
         ASSERT(mInternalRefs != 0);
         ASSERT(mExternalRefs != 0);
 
-        mExternalRefs--;
         // mExternalRefs != 0 counts as one internal ref.
-        if (mExternalRefs == 0) {
+        if (mExternalRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             ReleaseInternal();
         }
     }
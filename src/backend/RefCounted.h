@@ -15,10 +15,13 @@
 #ifndef BACKEND_REFCOUNTED_H_
 #define BACKEND_REFCOUNTED_H_
 
+#include <atomic>
 #include <cstdint>
 
 namespace backend {
 
+    // The reference counts are atomic so that objects can be referenced and released from
+    // multiple threads, for example when command buffers are recorded on different threads.
     class RefCounted {
       public:
         RefCounted();
@@ -26,6 +29,9 @@ namespace backend {
 
         void ReferenceInternal();
         void ReleaseInternal();
+        // Adds an internal reference unless the object is already being destroyed. Used by caches
+        // that don't hold references to their objects.
+        bool TryReferenceInternal();
 
         uint32_t GetExternalRefs() const;
         uint32_t GetInternalRefs() const;
@@ -35,8 +41,8 @@ namespace backend {
         void Release();
 
       protected:
-        uint32_t mExternalRefs = 1;
-        uint32_t mInternalRefs = 1;
+        std::atomic<uint32_t> mExternalRefs{1};
+        std::atomic<uint32_t> mInternalRefs{1};
     };
 
     template <typename T>
@@ -21,6 +21,7 @@
 #include "backend/RenderPassDescriptor.h"
 #include "backend/Texture.h"
 #include "common/BitSetIterator.h"
+#include "common/Trace.h"
 
 namespace backend {
 
@@ -138,6 +139,7 @@ namespace backend {
     }
 
     RenderPipelineBase* RenderPipelineBuilder::GetResultImpl() {
+        NXT_TRACE_SCOPE("RenderPipelineBuilder::GetResult");
         // TODO(cwallez@chromium.org): the layout should be required, and put the default objects in
         // the device
         if (!mInputState) {
@@ -18,6 +18,7 @@
 #include "backend/Device.h"
 #include "backend/Pipeline.h"
 #include "backend/PipelineLayout.h"
+#include "common/Trace.h"
 
 #include <spirv-cross/spirv_cross.hpp>
 
@@ -31,6 +32,7 @@ namespace backend {
     }
 
     void ShaderModuleBase::ExtractSpirvInfo(const spirv_cross::Compiler& compiler) {
+        NXT_TRACE_SCOPE("ShaderModule::ExtractSpirvInfo");
         // TODO(cwallez@chromium.org): make errors here builder-level
         // currently errors here do not prevent the shadermodule from being used
         const auto& resources = compiler.get_shader_resources();
@@ -226,6 +228,7 @@ namespace backend {
     }
 
     ShaderModuleBase* ShaderModuleBuilder::GetResultImpl() {
+        NXT_TRACE_SCOPE("ShaderModuleBuilder::GetResult");
         if (mSpirv.size() == 0) {
             HandleError("Shader module needs to have the source set");
             return nullptr;
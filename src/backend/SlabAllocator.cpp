@@ -0,0 +1,282 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/SlabAllocator.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+namespace backend {
+
+    namespace {
+
+        // Slabs are big enough to amortize their allocation but still hold a few slots for the
+        // largest objects.
+        constexpr size_t kSlabSize = 16 * 1024;
+        constexpr size_t kMinSlotsPerSlab = 8;
+
+        // Number of slots moved at once between a thread cache and the free lists of the
+        // allocator. A thread cache keeps less than twice as many slots of each size class.
+        constexpr uint32_t kThreadCacheBatchSize = 32;
+
+        class AllocatorRegistry {
+          public:
+            SlabAllocator* Register(const char* name) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mAllocators.push_back(std::make_unique<SlabAllocator>(name, true));
+                return mAllocators.back().get();
+            }
+
+            std::vector<SlabAllocatorStats> GetStats() const {
+                std::lock_guard<std::mutex> lock(mMutex);
+                std::vector<SlabAllocatorStats> stats;
+                for (const auto& allocator : mAllocators) {
+                    stats.push_back(allocator->GetStats());
+                }
+                return stats;
+            }
+
+          private:
+            mutable std::mutex mMutex;
+            std::vector<std::unique_ptr<SlabAllocator>> mAllocators;
+        };
+
+        // Slots must be able to hold a free list link and keep the next slot aligned.
+        size_t GetSlotSize(size_t size) {
+            size = std::max(size, sizeof(void*));
+            return Align(static_cast<uint32_t>(size), alignof(std::max_align_t));
+        }
+
+        AllocatorRegistry* GetRegistry() {
+            // Leaked on purpose so that objects destroyed after main can still be deallocated.
+            static AllocatorRegistry* registry = [] {
+                if (getenv("NXT_SLAB_ALLOCATOR_STATS") != nullptr) {
+                    std::atexit([] { WriteSlabAllocatorStats(std::cerr); });
+                }
+                return new AllocatorRegistry;
+            }();
+            return registry;
+        }
+
+        thread_local bool tThreadCacheDestroyed = false;
+
+    }  // anonymous namespace
+
+    // Destroyed when its thread exits, giving the cached slots back to the allocators. The
+    // allocations made on the thread after that, for example by the static destructors of the
+    // main thread, use the free lists of the allocators directly.
+    struct SlabAllocator::ThreadCache {
+        ~ThreadCache() {
+            for (ThreadCacheEntry& entry : entries) {
+                std::lock_guard<std::mutex> lock(entry.allocator->mMutex);
+                entry.allocator->DrainThreadCache(&entry, entry.slotCount);
+            }
+            tThreadCacheDestroyed = true;
+        }
+
+        // A thread uses a handful of allocators and size classes so a vector is the fastest
+        // lookup.
+        std::vector<ThreadCacheEntry> entries;
+    };
+
+    SlabAllocator::SlabAllocator(const char* name, bool useThreadCaches)
+        : mName(name), mUseThreadCaches(useThreadCaches) {
+    }
+
+    SlabAllocator::~SlabAllocator() {
+        ASSERT(mLiveCount == 0);
+        for (void* slab : mSlabs) {
+            ::operator delete(slab);
+        }
+    }
+
+    void* SlabAllocator::Allocate(size_t size) {
+        size_t slotSize = GetSlotSize(size);
+        mLiveCount.fetch_add(1, std::memory_order_relaxed);
+        mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        ThreadCacheEntry* entry = GetThreadCacheEntry(slotSize);
+        if (entry != nullptr) {
+            if (entry->freeList == nullptr) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                RefillThreadCache(entry);
+            }
+
+            FreeSlot* slot = entry->freeList;
+            entry->freeList = slot->next;
+            entry->slotCount--;
+            return slot;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        SizeClass* sizeClass = GetSizeClass(slotSize);
+        if (sizeClass->freeList == nullptr) {
+            AllocateSlab(sizeClass);
+        }
+
+        FreeSlot* slot = sizeClass->freeList;
+        sizeClass->freeList = slot->next;
+        return slot;
+    }
+
+    void SlabAllocator::Deallocate(void* ptr, size_t size) {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        size_t slotSize = GetSlotSize(size);
+        ASSERT(mLiveCount > 0);
+        mLiveCount.fetch_sub(1, std::memory_order_relaxed);
+
+        FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+        ThreadCacheEntry* entry = GetThreadCacheEntry(slotSize);
+        if (entry != nullptr) {
+            slot->next = entry->freeList;
+            entry->freeList = slot;
+            entry->slotCount++;
+
+            if (entry->slotCount >= 2 * kThreadCacheBatchSize) {
+                std::lock_guard<std::mutex> lock(mMutex);
+                DrainThreadCache(entry, kThreadCacheBatchSize);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        SizeClass* sizeClass = GetSizeClass(slotSize);
+        slot->next = sizeClass->freeList;
+        sizeClass->freeList = slot;
+    }
+
+    SlabAllocatorStats SlabAllocator::GetStats() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return {mName, mLiveCount.load(), mAllocationCount.load(), mSlabs.size(), mReservedBytes};
+    }
+
+    SlabAllocator::ThreadCacheEntry* SlabAllocator::GetThreadCacheEntry(size_t slotSize) {
+        if (!mUseThreadCaches || tThreadCacheDestroyed) {
+            return nullptr;
+        }
+
+        thread_local ThreadCache cache;
+        for (ThreadCacheEntry& entry : cache.entries) {
+            if (entry.allocator == this && entry.slotSize == slotSize) {
+                return &entry;
+            }
+        }
+
+        cache.entries.push_back({this, slotSize, nullptr, 0});
+        return &cache.entries.back();
+    }
+
+    void SlabAllocator::RefillThreadCache(ThreadCacheEntry* entry) {
+        ASSERT(entry->freeList == nullptr);
+
+        SizeClass* sizeClass = GetSizeClass(entry->slotSize);
+        if (sizeClass->freeList == nullptr) {
+            AllocateSlab(sizeClass);
+        }
+
+        // Move the first slots of the free list as a whole to keep them in address order.
+        FreeSlot* first = sizeClass->freeList;
+        FreeSlot* last = first;
+        uint32_t slotCount = 1;
+        while (slotCount < kThreadCacheBatchSize && last->next != nullptr) {
+            last = last->next;
+            slotCount++;
+        }
+
+        sizeClass->freeList = last->next;
+        last->next = nullptr;
+        entry->freeList = first;
+        entry->slotCount = slotCount;
+    }
+
+    void SlabAllocator::DrainThreadCache(ThreadCacheEntry* entry, uint32_t slotCount) {
+        ASSERT(slotCount <= entry->slotCount);
+        if (slotCount == 0) {
+            return;
+        }
+
+        FreeSlot* first = entry->freeList;
+        FreeSlot* last = first;
+        for (uint32_t i = 1; i < slotCount; ++i) {
+            last = last->next;
+        }
+
+        entry->freeList = last->next;
+        entry->slotCount -= slotCount;
+
+        SizeClass* sizeClass = GetSizeClass(entry->slotSize);
+        last->next = sizeClass->freeList;
+        sizeClass->freeList = first;
+    }
+
+    SlabAllocator::SizeClass* SlabAllocator::GetSizeClass(size_t slotSize) {
+        for (SizeClass& sizeClass : mSizeClasses) {
+            if (sizeClass.slotSize == slotSize) {
+                return &sizeClass;
+            }
+        }
+
+        mSizeClasses.push_back({slotSize, nullptr});
+        return &mSizeClasses.back();
+    }
+
+    void SlabAllocator::AllocateSlab(SizeClass* sizeClass) {
+        ASSERT(sizeClass->freeList == nullptr);
+
+        size_t slotSize = sizeClass->slotSize;
+        size_t slotCount = std::max(kSlabSize / slotSize, kMinSlotsPerSlab);
+        size_t slabSize = slotCount * slotSize;
+
+        // ::operator new returns memory aligned for std::max_align_t, and slot sizes are multiples
+        // of its alignment.
+        char* slab = static_cast<char*>(::operator new(slabSize));
+        mSlabs.push_back(slab);
+        mReservedBytes += slabSize;
+
+        // Chain the slots in address order so that consecutive allocations are contiguous.
+        FreeSlot* next = nullptr;
+        for (size_t i = slotCount; i > 0; --i) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(slab + (i - 1) * slotSize);
+            slot->next = next;
+            next = slot;
+        }
+        sizeClass->freeList = next;
+    }
+
+    SlabAllocator* RegisterSlabAllocator(const char* name) {
+        return GetRegistry()->Register(name);
+    }
+
+    std::vector<SlabAllocatorStats> GetSlabAllocatorStats() {
+        return GetRegistry()->GetStats();
+    }
+
+    void WriteSlabAllocatorStats(std::ostream& stream) {
+        for (const SlabAllocatorStats& stats : GetSlabAllocatorStats()) {
+            stream << stats.name << ": live=" << stats.liveCount
+                   << " allocations=" << stats.allocationCount << " slabs=" << stats.slabCount
+                   << " reservedBytes=" << stats.reservedBytes << std::endl;
+        }
+    }
+
+}  // namespace backend
@@ -0,0 +1,124 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_SLABALLOCATOR_H_
+#define BACKEND_SLABALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace backend {
+
+    struct SlabAllocatorStats {
+        const char* name;
+        // Number of objects currently allocated, slots kept in thread caches aren't counted.
+        uint64_t liveCount;
+        // Number of allocations since the creation of the allocator, sample it at two points in
+        // time to get an allocation rate.
+        uint64_t allocationCount;
+        uint64_t slabCount;
+        uint64_t reservedBytes;
+    };
+
+    // Allocates objects in slots of large slabs of memory that are recycled through free lists.
+    // Slots are grouped by size so that the backend-specific subclasses of a frontend type (and
+    // the different builder types) each get their own slabs. Slabs are never returned to the
+    // system so that frequently created and destroyed objects don't go through the heap at all.
+    // With thread caches, each thread keeps a few free slots of every size class so that most
+    // allocations and deallocations don't take the lock. The allocator must then outlive all the
+    // threads using it, which is the case of the registered allocators.
+    class SlabAllocator {
+      public:
+        SlabAllocator(const char* name, bool useThreadCaches = false);
+        ~SlabAllocator();
+
+        void* Allocate(size_t size);
+        void Deallocate(void* ptr, size_t size);
+
+        SlabAllocatorStats GetStats() const;
+
+      private:
+        struct FreeSlot {
+            FreeSlot* next;
+        };
+
+        struct SizeClass {
+            size_t slotSize;
+            FreeSlot* freeList;
+        };
+
+        struct ThreadCache;
+        struct ThreadCacheEntry {
+            SlabAllocator* allocator;
+            size_t slotSize;
+            FreeSlot* freeList;
+            uint32_t slotCount;
+        };
+        ThreadCacheEntry* GetThreadCacheEntry(size_t slotSize);
+        // Moves slots between the thread cache and the free lists, with mMutex locked.
+        void RefillThreadCache(ThreadCacheEntry* entry);
+        void DrainThreadCache(ThreadCacheEntry* entry, uint32_t slotCount);
+
+        SizeClass* GetSizeClass(size_t slotSize);
+        void AllocateSlab(SizeClass* sizeClass);
+
+        const char* mName;
+        bool mUseThreadCaches;
+
+        mutable std::mutex mMutex;
+        // There is usually a single size class per allocator so a vector is the fastest lookup.
+        std::vector<SizeClass> mSizeClasses;
+        std::vector<void*> mSlabs;
+        uint64_t mReservedBytes = 0;
+        // Updated without the lock by the thread caches.
+        std::atomic<uint64_t> mLiveCount{0};
+        std::atomic<uint64_t> mAllocationCount{0};
+    };
+
+    // Returns an allocator with thread caches that lives until the end of the program, so that
+    // objects can be deleted during static destruction.
+    SlabAllocator* RegisterSlabAllocator(const char* name);
+
+    std::vector<SlabAllocatorStats> GetSlabAllocatorStats();
+    // Writes a line per allocator with its statistics. They are also written to stderr at exit
+    // when the NXT_SLAB_ALLOCATOR_STATS environment variable is set.
+    void WriteSlabAllocatorStats(std::ostream& stream);
+
+    // Base class that makes new and delete of T and its subclasses use the slab allocator named
+    // T::kSlabAllocatorName. The sized delete is called with the size of the most derived class
+    // because RefCounted has a virtual destructor.
+    template <typename T>
+    class SlabAllocated {
+      public:
+        static void* operator new(size_t size) {
+            return GetAllocator()->Allocate(size);
+        }
+        static void operator delete(void* ptr, size_t size) {
+            GetAllocator()->Deallocate(ptr, size);
+        }
+
+      private:
+        static SlabAllocator* GetAllocator() {
+            static SlabAllocator* allocator = RegisterSlabAllocator(T::kSlabAllocatorName);
+            return allocator;
+        }
+    };
+
+}  // namespace backend
+
+#endif  // BACKEND_SLABALLOCATOR_H_
@@ -112,6 +112,11 @@ namespace backend {
         return new TextureViewBuilder(mDevice, this);
     }
 
+    TextureViewBase* TextureBase::CreateTextureView() {
+        TextureViewBuilder builder(mDevice, this);
+        return builder.TryGetResult();
+    }
+
     bool TextureBase::IsFrozen() const {
         return mIsFrozen;
     }
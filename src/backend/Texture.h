@@ -18,6 +18,7 @@
 #include "backend/Builder.h"
 #include "backend/Forward.h"
 #include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
 
 #include "nxt/nxtcpp.h"
 
@@ -28,8 +29,10 @@ namespace backend {
     bool TextureFormatHasStencil(nxt::TextureFormat format);
     bool TextureFormatHasDepthOrStencil(nxt::TextureFormat format);
 
-    class TextureBase : public RefCounted {
+    class TextureBase : public RefCounted, public SlabAllocated<TextureBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "Texture";
+
         TextureBase(TextureBuilder* builder);
 
         nxt::TextureDimension GetDimension() const;
@@ -50,6 +53,7 @@ namespace backend {
 
         // NXT API
         TextureViewBuilder* CreateTextureViewBuilder();
+        TextureViewBase* CreateTextureView();
         void TransitionUsage(nxt::TextureUsageBit usage);
         void FreezeUsage(nxt::TextureUsageBit usage);
 
@@ -95,8 +99,10 @@ namespace backend {
         nxt::TextureUsageBit mCurrentUsage = nxt::TextureUsageBit::None;
     };
 
-    class TextureViewBase : public RefCounted {
+    class TextureViewBase : public RefCounted, public SlabAllocated<TextureViewBase> {
       public:
+        static constexpr const char* kSlabAllocatorName = "TextureView";
+
         TextureViewBase(TextureViewBuilder* builder);
 
         const TextureBase* GetTexture() const;
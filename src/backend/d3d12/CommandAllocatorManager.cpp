@@ -30,7 +30,7 @@ namespace backend { namespace d3d12 {
         // If there are no free allocators, get the oldest serial in flight and wait on it
         if (mFreeAllocators.none()) {
             const uint64_t firstSerial = mInFlightCommandAllocators.FirstSerial();
-            device->WaitForSerial(firstSerial);
+            device->WaitForSerialCompletion(firstSerial);
             Tick(firstSerial);
         }
 
@@ -14,6 +14,7 @@
 
 #include "backend/d3d12/D3D12Backend.h"
 
+#include "backend/ProcProfiler.h"
 #include "backend/d3d12/BindGroupD3D12.h"
 #include "backend/d3d12/BindGroupLayoutD3D12.h"
 #include "backend/d3d12/BlendStateD3D12.h"
@@ -42,10 +43,11 @@ namespace backend { namespace d3d12 {
 
     nxtProcTable GetNonValidatingProcs();
     nxtProcTable GetValidatingProcs();
+    nxtProcTable GetProfilingProcs();
 
     void Init(nxtProcTable* procs, nxtDevice* device) {
         *device = nullptr;
-        *procs = GetValidatingProcs();
+        *procs = IsProcProfilingEnabled() ? GetProfilingProcs() : GetValidatingProcs();
         *device = reinterpret_cast<nxtDevice>(new Device());
     }
 
@@ -60,6 +62,17 @@ namespace backend { namespace d3d12 {
         return static_cast<nxtTextureFormat>(impl->GetPreferredFormat());
     }
 
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *lastSubmitted = backendDevice->GetLastSubmittedSerial();
+        *completed = backendDevice->GetCompletedSerial();
+    }
+
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        return backendDevice->WaitForSerial(serial, timeoutNs);
+    }
+
     void ASSERT_SUCCESS(HRESULT hr) {
         ASSERT(SUCCEEDED(hr));
     }
@@ -147,8 +160,9 @@ namespace backend { namespace d3d12 {
     Device::~Device() {
         const uint64_t currentSerial = GetSerial();
         NextSerial();
-        WaitForSerial(currentSerial);  // Wait for all in-flight commands to finish executing
-        TickImpl();                    // Call tick one last time so resources are cleaned up
+        // Wait for all in-flight commands to finish executing
+        WaitForSerialCompletion(currentSerial);
+        TickImpl();  // Call tick one last time so resources are cleaned up
         ASSERT(mUsedComObjectRefs.Empty());
 
         delete mCommandAllocatorManager;
@@ -229,14 +243,46 @@ namespace backend { namespace d3d12 {
         ASSERT_SUCCESS(mCommandQueue->Signal(mFence.Get(), mSerial++));
     }
 
-    void Device::WaitForSerial(uint64_t serial) {
-        const uint64_t lastCompletedSerial = mFence->GetCompletedValue();
-        if (lastCompletedSerial < serial) {
+    void Device::WaitForSerialCompletion(uint64_t serial) {
+        // The event can also have been set by an earlier WaitForSerial that timed out, so check
+        // the fence again after waking up.
+        while (mFence->GetCompletedValue() < serial) {
             ASSERT_SUCCESS(mFence->SetEventOnCompletion(serial, mFenceEvent));
             WaitForSingleObject(mFenceEvent, INFINITE);
         }
     }
 
+    Serial Device::GetLastSubmittedSerial() const {
+        // NextSerial signals the fence with mSerial then increments it.
+        return mSerial - 1;
+    }
+
+    Serial Device::GetCompletedSerial() const {
+        return mFence->GetCompletedValue();
+    }
+
+    bool Device::WaitForSerial(Serial serial, uint64_t timeoutNs) {
+        if (mFence->GetCompletedValue() >= serial) {
+            return true;
+        }
+
+        // Waiting on the pending serial requires its commands to be submitted and the fence to
+        // be signaled with it first.
+        if (serial == mSerial) {
+            ExecuteCommandLists({});
+            NextSerial();
+        }
+
+        // Round up to milliseconds, staying below INFINITE.
+        uint64_t timeoutMs = timeoutNs / 1000000 + (timeoutNs % 1000000 != 0 ? 1 : 0);
+        if (timeoutMs >= INFINITE) {
+            timeoutMs = INFINITE - 1;
+        }
+        ASSERT_SUCCESS(mFence->SetEventOnCompletion(serial, mFenceEvent));
+        WaitForSingleObject(mFenceEvent, static_cast<DWORD>(timeoutMs));
+        return mFence->GetCompletedValue() >= serial;
+    }
+
     void Device::ReferenceUntilUnused(ComPtr<IUnknown> object) {
         mUsedComObjectRefs.Enqueue(object, mSerial);
     }
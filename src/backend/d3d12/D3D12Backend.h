@@ -108,6 +108,10 @@ namespace backend { namespace d3d12 {
 
         void TickImpl() override;
 
+        Serial GetLastSubmittedSerial() const override;
+        Serial GetCompletedSerial() const override;
+        bool WaitForSerial(Serial serial, uint64_t timeoutNs) override;
+
         ComPtr<IDXGIFactory4> GetFactory();
         ComPtr<ID3D12Device> GetD3D12Device();
         ComPtr<ID3D12CommandQueue> GetCommandQueue();
@@ -122,7 +126,8 @@ namespace backend { namespace d3d12 {
 
         uint64_t GetSerial() const;
         void NextSerial();
-        void WaitForSerial(uint64_t serial);
+        // Blocks until the serial has completed, without timeout.
+        void WaitForSerialCompletion(uint64_t serial);
 
         void ReferenceUntilUnused(ComPtr<IUnknown> object);
 
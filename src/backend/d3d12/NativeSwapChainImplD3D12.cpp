@@ -95,7 +95,7 @@ namespace backend { namespace d3d12 {
 
         // TODO(cwallez@chromium.org) Currently we force the CPU to wait for the GPU to be finished
         // with the buffer. Ideally the synchronization should be all done on the GPU.
-        mDevice->WaitForSerial(mBufferSerials[mCurrentBuffer]);
+        mDevice->WaitForSerialCompletion(mBufferSerials[mCurrentBuffer]);
 
         return NXT_SWAP_CHAIN_NO_ERROR;
     }
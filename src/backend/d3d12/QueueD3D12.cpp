@@ -16,6 +16,7 @@
 
 #include "backend/d3d12/CommandBufferD3D12.h"
 #include "backend/d3d12/D3D12Backend.h"
+#include "common/Trace.h"
 
 namespace backend { namespace d3d12 {
 
@@ -23,6 +24,7 @@ namespace backend { namespace d3d12 {
     }
 
     void Queue::Submit(uint32_t numCommands, CommandBuffer* const* commands) {
+        NXT_TRACE_SCOPE("Queue::Submit");
         mDevice->Tick();
 
         mDevice->OpenCommandList(&mCommandList);
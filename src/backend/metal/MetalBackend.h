@@ -27,6 +27,7 @@
 
 #import <Metal/Metal.h>
 #import <QuartzCore/CAMetalLayer.h>
+#include <atomic>
 #include <type_traits>
 
 namespace backend { namespace metal {
@@ -109,6 +110,10 @@ namespace backend { namespace metal {
 
         void TickImpl() override;
 
+        Serial GetLastSubmittedSerial() const override;
+        Serial GetCompletedSerial() const override;
+        bool WaitForSerial(Serial serial, uint64_t timeoutNs) override;
+
         id<MTLDevice> GetMTLDevice();
 
         id<MTLCommandBuffer> GetPendingCommandBuffer();
@@ -126,7 +131,8 @@ namespace backend { namespace metal {
         MapRequestTracker* mMapTracker;
         ResourceUploader* mResourceUploader;
 
-        Serial mFinishedCommandSerial = 0;
+        // Written by the command buffer completion handlers, which run on another thread.
+        std::atomic<Serial> mFinishedCommandSerial;
         Serial mPendingCommandSerial = 1;
         id<MTLCommandBuffer> mPendingCommands = nil;
     };
@@ -14,6 +14,7 @@
 
 #include "backend/metal/MetalBackend.h"
 
+#include "backend/ProcProfiler.h"
 #include "backend/metal/BlendStateMTL.h"
 #include "backend/metal/BufferMTL.h"
 #include "backend/metal/CommandBufferMTL.h"
@@ -27,24 +28,40 @@
 #include "backend/metal/ShaderModuleMTL.h"
 #include "backend/metal/SwapChainMTL.h"
 #include "backend/metal/TextureMTL.h"
+#include "common/Trace.h"
+
+#include <chrono>
 
 #include <unistd.h>
 
 namespace backend { namespace metal {
     nxtProcTable GetNonValidatingProcs();
     nxtProcTable GetValidatingProcs();
+    nxtProcTable GetProfilingProcs();
 
     void Init(id<MTLDevice> metalDevice, nxtProcTable* procs, nxtDevice* device) {
         *device = nullptr;
 
-        *procs = GetValidatingProcs();
+        *procs = IsProcProfilingEnabled() ? GetProfilingProcs() : GetValidatingProcs();
         *device = reinterpret_cast<nxtDevice>(new Device(metalDevice));
     }
 
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *lastSubmitted = backendDevice->GetLastSubmittedSerial();
+        *completed = backendDevice->GetCompletedSerial();
+    }
+
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        return backendDevice->WaitForSerial(serial, timeoutNs);
+    }
+
     // Device
 
     Device::Device(id<MTLDevice> mtlDevice)
         : mMtlDevice(mtlDevice),
+          mFinishedCommandSerial(0),
           mMapTracker(new MapRequestTracker(this)),
           mResourceUploader(new ResourceUploader(this)) {
         [mMtlDevice retain];
@@ -142,6 +159,35 @@ namespace backend { namespace metal {
         SubmitPendingCommandBuffer();
     }
 
+    Serial Device::GetLastSubmittedSerial() const {
+        return mPendingCommandSerial - 1;
+    }
+
+    Serial Device::GetCompletedSerial() const {
+        return mFinishedCommandSerial;
+    }
+
+    bool Device::WaitForSerial(Serial serial, uint64_t timeoutNs) {
+        // Waiting on the pending serial requires its commands to be submitted first.
+        if (serial == mPendingCommandSerial) {
+            SubmitPendingCommandBuffer();
+        }
+
+        // The completion handlers don't signal anything that can be waited on with a timeout so
+        // poll like the destructor does.
+        auto start = std::chrono::steady_clock::now();
+        while (mFinishedCommandSerial < serial) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) >=
+                timeoutNs) {
+                return false;
+            }
+            usleep(100);
+        }
+        return true;
+    }
+
     id<MTLDevice> Device::GetMTLDevice() {
         return mMtlDevice;
     }
@@ -217,6 +263,7 @@ namespace backend { namespace metal {
     }
 
     void Queue::Submit(uint32_t numCommands, CommandBuffer* const* commands) {
+        NXT_TRACE_SCOPE("Queue::Submit");
         Device* device = ToBackend(GetDevice());
         device->Tick();
         id<MTLCommandBuffer> commandBuffer = device->GetPendingCommandBuffer();
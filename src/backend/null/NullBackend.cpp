@@ -15,6 +15,8 @@
 #include "backend/null/NullBackend.h"
 
 #include "backend/Commands.h"
+#include "backend/ProcProfiler.h"
+#include "common/Trace.h"
 
 #include <spirv-cross/spirv_cross.hpp>
 
@@ -22,9 +24,10 @@ namespace backend { namespace null {
 
     nxtProcTable GetNonValidatingProcs();
     nxtProcTable GetValidatingProcs();
+    nxtProcTable GetProfilingProcs();
 
     void Init(nxtProcTable* procs, nxtDevice* device) {
-        *procs = GetValidatingProcs();
+        *procs = IsProcProfilingEnabled() ? GetProfilingProcs() : GetValidatingProcs();
         *device = reinterpret_cast<nxtDevice>(new Device);
     }
 
@@ -211,6 +214,7 @@ namespace backend { namespace null {
     }
 
     void Queue::Submit(uint32_t numCommands, CommandBuffer* const* commands) {
+        NXT_TRACE_SCOPE("Queue::Submit");
         auto operations = ToBackend(GetDevice())->AcquirePendingOperations();
 
         for (auto& operation : operations) {
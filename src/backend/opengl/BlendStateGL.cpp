@@ -15,6 +15,7 @@
 #include "backend/opengl/BlendStateGL.h"
 
 #include "backend/opengl/OpenGLBackend.h"
+#include "backend/opengl/PersistentPipelineStateGL.h"
 #include "common/Assert.h"
 
 namespace backend { namespace opengl {
@@ -74,24 +75,26 @@ namespace backend { namespace opengl {
     BlendState::BlendState(BlendStateBuilder* builder) : BlendStateBase(builder) {
     }
 
-    void BlendState::ApplyNow(uint32_t attachment) {
+    void BlendState::ApplyNow(PersistentPipelineState& persistentPipelineState,
+                              uint32_t attachment) const {
         const auto& info = GetBlendInfo();
 
+        persistentPipelineState.SetBlendEnabled(attachment, info.blendEnabled);
         if (info.blendEnabled) {
-            glEnablei(GL_BLEND, attachment);
-            glBlendEquationSeparatei(attachment, GLBlendMode(info.colorBlend.operation),
-                                     GLBlendMode(info.alphaBlend.operation));
-            glBlendFuncSeparatei(attachment, GLBlendFactor(info.colorBlend.srcFactor, false),
-                                 GLBlendFactor(info.colorBlend.dstFactor, false),
-                                 GLBlendFactor(info.alphaBlend.srcFactor, true),
-                                 GLBlendFactor(info.alphaBlend.dstFactor, true));
-        } else {
-            glDisablei(GL_BLEND, attachment);
+            persistentPipelineState.SetBlendEquation(attachment,
+                                                     GLBlendMode(info.colorBlend.operation),
+                                                     GLBlendMode(info.alphaBlend.operation));
+            persistentPipelineState.SetBlendFunc(attachment,
+                                                 GLBlendFactor(info.colorBlend.srcFactor, false),
+                                                 GLBlendFactor(info.colorBlend.dstFactor, false),
+                                                 GLBlendFactor(info.alphaBlend.srcFactor, true),
+                                                 GLBlendFactor(info.alphaBlend.dstFactor, true));
         }
-        glColorMaski(attachment, info.colorWriteMask & nxt::ColorWriteMask::Red,
-                     info.colorWriteMask & nxt::ColorWriteMask::Green,
-                     info.colorWriteMask & nxt::ColorWriteMask::Blue,
-                     info.colorWriteMask & nxt::ColorWriteMask::Alpha);
+        persistentPipelineState.SetColorMask(attachment,
+                                             info.colorWriteMask & nxt::ColorWriteMask::Red,
+                                             info.colorWriteMask & nxt::ColorWriteMask::Green,
+                                             info.colorWriteMask & nxt::ColorWriteMask::Blue,
+                                             info.colorWriteMask & nxt::ColorWriteMask::Alpha);
     }
 
 }}  // namespace backend::opengl
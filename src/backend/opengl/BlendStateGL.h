@@ -21,11 +21,13 @@
 
 namespace backend { namespace opengl {
 
+    class PersistentPipelineState;
+
     class BlendState : public BlendStateBase {
       public:
         BlendState(BlendStateBuilder* builder);
 
-        void ApplyNow(uint32_t attachment);
+        void ApplyNow(PersistentPipelineState& persistentPipelineState, uint32_t attachment) const;
     };
 
 }}  // namespace backend::opengl
@@ -26,13 +26,18 @@ namespace backend { namespace opengl {
         glBufferData(GL_ARRAY_BUFFER, GetSize(), nullptr, GL_STATIC_DRAW);
     }
 
+    Buffer::~Buffer() {
+        // The handle can be reused by the next buffer created so the VAOs using it must go.
+        ToBackend(GetDevice())->OnBufferDestroyed(mBuffer);
+        glDeleteBuffers(1, &mBuffer);
+    }
+
     GLuint Buffer::GetHandle() const {
         return mBuffer;
     }
 
     void Buffer::SetSubDataImpl(uint32_t start, uint32_t count, const uint8_t* data) {
-        glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
-        glBufferSubData(GL_ARRAY_BUFFER, start, count, data);
+        ToBackend(GetDevice())->GetBufferUploader()->BufferSubData(mBuffer, start, count, data);
     }
 
     void Buffer::MapReadAsyncImpl(uint32_t serial, uint32_t start, uint32_t count) {
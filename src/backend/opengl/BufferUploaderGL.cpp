@@ -0,0 +1,118 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/opengl/BufferUploaderGL.h"
+
+#include "common/Assert.h"
+
+#include <cstring>
+
+namespace backend { namespace opengl {
+
+    BufferUploader::BufferUploader() {
+        glGenBuffers(1, &mRingBuffer);
+        glBindBuffer(GL_COPY_READ_BUFFER, mRingBuffer);
+        glBufferData(GL_COPY_READ_BUFFER, kRingSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    BufferUploader::~BufferUploader() {
+        for (const auto& region : mInFlightRegions) {
+            glDeleteSync(region.fence);
+        }
+        glDeleteBuffers(1, &mRingBuffer);
+    }
+
+    void BufferUploader::BufferSubData(GLuint buffer,
+                                       GLintptr offset,
+                                       GLsizeiptr size,
+                                       const void* data) {
+        Tick();
+
+        size_t ringOffset = 0;
+        if (!Allocate(static_cast<size_t>(size), &ringOffset)) {
+            // The ring is full or the upload is too big for it, fallback to a synchronous upload.
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+            return;
+        }
+
+        // The region isn't used by the GPU anymore so it can be written without synchronization.
+        glBindBuffer(GL_COPY_READ_BUFFER, mRingBuffer);
+        void* staging = glMapBufferRange(
+            GL_COPY_READ_BUFFER, ringOffset, size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        ASSERT(staging != nullptr);
+        memcpy(staging, data, size);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, ringOffset, offset, size);
+
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mInFlightRegions.push_back({ringOffset, fence});
+    }
+
+    void BufferUploader::Tick() {
+        while (!mInFlightRegions.empty()) {
+            GLsync fence = mInFlightRegions.front().fence;
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                break;
+            }
+
+            glDeleteSync(fence);
+            mInFlightRegions.pop_front();
+        }
+
+        if (mInFlightRegions.empty()) {
+            mHead = 0;
+        }
+    }
+
+    bool BufferUploader::Allocate(size_t size, size_t* offset) {
+        if (size == 0 || size > kRingSize) {
+            return false;
+        }
+
+        if (mInFlightRegions.empty()) {
+            ASSERT(mHead == 0);
+            *offset = 0;
+            mHead = size;
+            return true;
+        }
+
+        // The oldest in-flight region marks the end of the free space. The comparisons are strict
+        // so that mHead never catches up with it, which would make a full ring look empty.
+        size_t tail = mInFlightRegions.front().start;
+        if (mHead >= tail) {
+            if (mHead + size <= kRingSize) {
+                *offset = mHead;
+            } else if (size < tail) {
+                // Wrap around, the space at the end of the ring is freed with the region before.
+                *offset = 0;
+            } else {
+                return false;
+            }
+        } else {
+            if (mHead + size >= tail) {
+                return false;
+            }
+            *offset = mHead;
+        }
+
+        mHead = *offset + size;
+        return true;
+    }
+
+}}  // namespace backend::opengl
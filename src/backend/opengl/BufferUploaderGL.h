@@ -0,0 +1,56 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_OPENGL_BUFFERUPLOADERGL_H_
+#define BACKEND_OPENGL_BUFFERUPLOADERGL_H_
+
+#include "glad/glad.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace backend { namespace opengl {
+
+    // Uploads data to buffers through a ring of staging memory followed by a GPU-side copy so that
+    // SetSubData never waits on the GPU still using the destination buffer. Each region of the
+    // ring is protected by a fence and is reused only once the copy out of it has completed.
+    class BufferUploader {
+      public:
+        BufferUploader();
+        ~BufferUploader();
+
+        void BufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+
+        // Releases the regions of the ring whose copies have completed.
+        void Tick();
+
+      private:
+        bool Allocate(size_t size, size_t* offset);
+
+        static constexpr size_t kRingSize = 4 * 1024 * 1024;
+
+        struct InFlightRegion {
+            size_t start;
+            GLsync fence;
+        };
+
+        GLuint mRingBuffer = 0;
+        size_t mHead = 0;
+        std::deque<InFlightRegion> mInFlightRegions;
+    };
+
+}}  // namespace backend::opengl
+
+#endif  // BACKEND_OPENGL_BUFFERUPLOADERGL_H_
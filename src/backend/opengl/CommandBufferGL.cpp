@@ -23,9 +23,11 @@
 #include "backend/opengl/PipelineLayoutGL.h"
 #include "backend/opengl/RenderPipelineGL.h"
 #include "backend/opengl/SamplerGL.h"
+#include "backend/opengl/ShaderModuleGL.h"
 #include "backend/opengl/TextureGL.h"
 
 #include <cstring>
+#include <vector>
 
 namespace backend { namespace opengl {
 
@@ -42,39 +44,6 @@ namespace backend { namespace opengl {
             }
         }
 
-        GLenum VertexFormatType(nxt::VertexFormat format) {
-            switch (format) {
-                case nxt::VertexFormat::FloatR32G32B32A32:
-                case nxt::VertexFormat::FloatR32G32B32:
-                case nxt::VertexFormat::FloatR32G32:
-                case nxt::VertexFormat::FloatR32:
-                    return GL_FLOAT;
-                case nxt::VertexFormat::IntR32G32B32A32:
-                case nxt::VertexFormat::IntR32G32B32:
-                case nxt::VertexFormat::IntR32G32:
-                case nxt::VertexFormat::IntR32:
-                    return GL_INT;
-                case nxt::VertexFormat::UshortR16G16B16A16:
-                case nxt::VertexFormat::UshortR16G16:
-                    return GL_UNSIGNED_SHORT;
-                case nxt::VertexFormat::UnormR8G8B8A8:
-                case nxt::VertexFormat::UnormR8G8:
-                    return GL_UNSIGNED_BYTE;
-                default:
-                    UNREACHABLE();
-            }
-        }
-
-        GLboolean VertexFormatIsNormalized(nxt::VertexFormat format) {
-            switch (format) {
-                case nxt::VertexFormat::UnormR8G8B8A8:
-                case nxt::VertexFormat::UnormR8G8:
-                    return GL_TRUE;
-                default:
-                    return GL_FALSE;
-            }
-        }
-
         // Push constants are implemented using OpenGL uniforms, however they aren't part of the
         // global OpenGL state but are part of the program state instead. This means that we have to
         // reapply push constants on pipeline change.
@@ -96,11 +65,16 @@ namespace backend { namespace opengl {
                                     uint32_t offset,
                                     const uint32_t* data) {
                 for (auto stage : IterateStages(stages)) {
-                    memcpy(&mValues[stage][offset], data, count * sizeof(uint32_t));
-
-                    // Use 64 bit masks and make sure there are no shift UB
-                    static_assert(kMaxPushConstants <= 8 * sizeof(unsigned long long) - 1, "");
-                    mDirtyBits[stage] |= ((1ull << count) - 1ull) << offset;
+                    // Only mark the constants that changed as dirty: the uniforms of the current
+                    // program already hold mValues, unless the pipeline changes in which case all
+                    // of them are reapplied. This avoids the glUniform calls for values that are
+                    // the same from one draw to the next.
+                    for (uint32_t i = 0; i < count; ++i) {
+                        if (mValues[stage][offset + i] != data[i]) {
+                            mValues[stage][offset + i] = data[i];
+                            mDirtyBits[stage].set(offset + i);
+                        }
+                    }
                 }
             }
 
@@ -117,48 +91,67 @@ namespace backend { namespace opengl {
 
                     for (uint32_t constant :
                          IterateBitSet(mDirtyBits[stage] & pushConstants.mask)) {
-                        GLint location = glPushConstants[constant];
-                        switch (pushConstants.types[constant]) {
-                            case PushConstantType::Int:
-                                glUniform1i(location,
-                                            *reinterpret_cast<GLint*>(&mValues[stage][constant]));
-                                break;
-                            case PushConstantType::UInt:
-                                glUniform1ui(location,
-                                             *reinterpret_cast<GLuint*>(&mValues[stage][constant]));
-                                break;
-                            case PushConstantType::Float:
-                                float value;
-                                // Use a memcpy to avoid strict-aliasing warnings, even if it is
-                                // still technically undefined behavior.
-                                memcpy(&value, &mValues[stage][constant], sizeof(value));
-                                glUniform1f(location, value);
-                                break;
-                        }
+                        ApplyConstant(pushConstants.types[constant], glPushConstants[constant],
+                                      &mValues[stage][constant]);
                     }
 
                     mDirtyBits[stage].reset();
                 }
             }
 
+            // Sets all the push constants of stage in the current program, which isn't the
+            // pipeline's program, so the dirty bits are left untouched.
+            void ApplyAll(nxt::ShaderStage stage,
+                          PipelineBase* pipeline,
+                          const PipelineGL::GLPushConstantInfo& glPushConstants) {
+                const auto& pushConstants = pipeline->GetPushConstants(stage);
+                for (uint32_t constant : IterateBitSet(pushConstants.mask)) {
+                    ApplyConstant(pushConstants.types[constant], glPushConstants[constant],
+                                  &mValues[stage][constant]);
+                }
+            }
+
+            const std::array<uint32_t, kMaxPushConstants>& GetValues(nxt::ShaderStage stage) const {
+                return mValues[stage];
+            }
+
           private:
+            static void ApplyConstant(PushConstantType type, GLint location, uint32_t* data) {
+                switch (type) {
+                    case PushConstantType::Int:
+                        glUniform1i(location, *reinterpret_cast<GLint*>(data));
+                        break;
+                    case PushConstantType::UInt:
+                        glUniform1ui(location, *reinterpret_cast<GLuint*>(data));
+                        break;
+                    case PushConstantType::Float:
+                        float value;
+                        // Use a memcpy to avoid strict-aliasing warnings, even if it is
+                        // still technically undefined behavior.
+                        memcpy(&value, data, sizeof(value));
+                        glUniform1f(location, value);
+                        break;
+                }
+            }
+
             PerStage<std::array<uint32_t, kMaxPushConstants>> mValues;
             PerStage<std::bitset<kMaxPushConstants>> mDirtyBits;
         };
 
-        // Vertex buffers and index buffers are implemented as part of an OpenGL VAO that
-        // corresponds to an InputState. On the contrary in NXT they are part of the global state.
-        // This means that we have to re-apply these buffers on an InputState change.
+        // Vertex buffers and index buffers are implemented as part of an OpenGL VAO. On the
+        // contrary in NXT they are part of the global state. InputStates keep a VAO for each set of
+        // buffers used with them, this structure tracks the buffers so that the right VAO is bound
+        // before the next draw.
         class InputBufferTracker {
           public:
             void OnBeginPass() {
                 // We don't know what happened between this pass and the last one, just reset the
-                // input state so everything gets reapplied.
+                // input state so the VAO gets rebound.
                 mLastInputState = nullptr;
             }
 
             void OnSetIndexBuffer(BufferBase* buffer) {
-                mIndexBufferDirty = true;
+                mDirty = true;
                 mIndexBuffer = ToBackend(buffer);
             }
 
@@ -171,10 +164,7 @@ namespace backend { namespace opengl {
                     mVertexBuffers[slot] = ToBackend(buffers[i].Get());
                     mVertexBufferOffsets[slot] = offsets[i];
                 }
-
-                // Use 64 bit masks and make sure there are no shift UB
-                static_assert(kMaxVertexInputs <= 8 * sizeof(unsigned long long) - 1, "");
-                mDirtyVertexBuffers |= ((1ull << count) - 1ull) << startSlot;
+                mDirty = true;
             }
 
             void OnSetPipeline(RenderPipelineBase* pipeline) {
@@ -183,54 +173,255 @@ namespace backend { namespace opengl {
                     return;
                 }
 
-                mIndexBufferDirty = true;
-                mDirtyVertexBuffers |= inputState->GetInputsSetMask();
-
+                mDirty = true;
                 mLastInputState = ToBackend(inputState);
             }
 
-            void Apply() {
-                if (mIndexBufferDirty && mIndexBuffer != nullptr) {
-                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer->GetHandle());
-                    mIndexBufferDirty = false;
+            void Apply(PersistentPipelineState& persistentPipelineState) {
+                if (!mDirty) {
+                    return;
                 }
 
-                for (uint32_t slot :
-                     IterateBitSet(mDirtyVertexBuffers & mLastInputState->GetInputsSetMask())) {
-                    for (uint32_t location :
-                         IterateBitSet(mLastInputState->GetAttributesUsingInput(slot))) {
-                        auto attribute = mLastInputState->GetAttribute(location);
-
-                        GLuint buffer = mVertexBuffers[slot]->GetHandle();
-                        uint32_t offset = mVertexBufferOffsets[slot];
-
-                        auto input = mLastInputState->GetInput(slot);
-                        auto components = VertexFormatNumComponents(attribute.format);
-                        auto formatType = VertexFormatType(attribute.format);
-
-                        GLboolean normalized = VertexFormatIsNormalized(attribute.format);
-                        glBindBuffer(GL_ARRAY_BUFFER, buffer);
-                        glVertexAttribPointer(
-                            location, components, formatType, normalized, input.stride,
-                            reinterpret_cast<void*>(
-                                static_cast<intptr_t>(offset + attribute.offset)));
-                    }
+                InputState::VertexBuffers vertexBuffers;
+                for (uint32_t slot : IterateBitSet(mLastInputState->GetInputsSetMask())) {
+                    vertexBuffers.buffers[slot] = mVertexBuffers[slot]->GetHandle();
+                    vertexBuffers.offsets[slot] = mVertexBufferOffsets[slot];
+                }
+                if (mIndexBuffer != nullptr) {
+                    vertexBuffers.indexBuffer = mIndexBuffer->GetHandle();
                 }
 
-                mDirtyVertexBuffers.reset();
+                mLastInputState->ApplyVertexBuffers(vertexBuffers, persistentPipelineState);
+                mDirty = false;
             }
 
           private:
-            bool mIndexBufferDirty = false;
+            bool mDirty = false;
             Buffer* mIndexBuffer = nullptr;
 
-            std::bitset<kMaxVertexInputs> mDirtyVertexBuffers;
             std::array<Buffer*, kMaxVertexInputs> mVertexBuffers;
             std::array<uint32_t, kMaxVertexInputs> mVertexBufferOffsets;
 
             InputState* mLastInputState = nullptr;
         };
 
+        // Consecutive draws that only differ by their vertex push constants are batched in a
+        // single glMultiDraw*Indirect call using the batched program of the pipeline, see
+        // ShaderModuleGL.h. The vertex push constants of each draw are packed in a uniform buffer
+        // and each indirect command has its baseInstance set to its index in the batch, so that the
+        // batched program finds them through the per-instance draw index attribute. Unlike
+        // gl_DrawID this works without OpenGL 4.6 or ARB_shader_draw_parameters.
+        //
+        // Draws are deferred until a command that can change the state they use is executed, only
+        // the vertex push constants can change between the draws of a batch.
+        class DrawBatcher {
+          public:
+            DrawBatcher(Device* device,
+                        PersistentPipelineState* persistentPipelineState,
+                        PushConstantTracker* pushConstants,
+                        InputBufferTracker* inputBuffers)
+                : mDevice(device),
+                  mPersistentPipelineState(persistentPipelineState),
+                  mPushConstants(pushConstants),
+                  mInputBuffers(inputBuffers) {
+            }
+
+            void OnSetPipeline(RenderPipeline* pipeline) {
+                ASSERT(mDrawCount == 0);
+                mPipeline = pipeline;
+                mPushConstantCount = static_cast<uint32_t>(
+                    pipeline->GetPushConstants(nxt::ShaderStage::Vertex).mask.count());
+                mPushConstantStride = GetBatchedPushConstantsStride(mPushConstantCount);
+            }
+
+            // Returns false if the draw can't be batched, in which case the pending draws have been
+            // issued and the draw must be issued directly.
+            bool AddDrawArrays(const DrawArraysCmd& draw) {
+                if (!CanBatch(draw.instanceCount, draw.firstInstance)) {
+                    Flush();
+                    return false;
+                }
+
+                PrepareToAdd(false);
+                mArraysCommands.push_back(
+                    {draw.vertexCount, draw.instanceCount, draw.firstVertex, mDrawCount});
+                AddPushConstants();
+                return true;
+            }
+
+            bool AddDrawElements(const DrawElementsCmd& draw, uint32_t indexBufferBaseOffset) {
+                // Indirect commands give the first index in indices instead of bytes.
+                uint32_t formatSize =
+                    static_cast<uint32_t>(IndexFormatSize(mPipeline->GetIndexFormat()));
+                if (!CanBatch(draw.instanceCount, draw.firstInstance) ||
+                    indexBufferBaseOffset % formatSize != 0) {
+                    Flush();
+                    return false;
+                }
+
+                PrepareToAdd(true);
+                mElementsCommands.push_back({draw.indexCount, draw.instanceCount,
+                                             draw.firstIndex + indexBufferBaseOffset / formatSize,
+                                             0, mDrawCount});
+                AddPushConstants();
+                return true;
+            }
+
+            void Flush() {
+                if (mDrawCount == 0) {
+                    return;
+                }
+
+                mInputBuffers->Apply(*mPersistentPipelineState);
+                if (mDrawCount == 1) {
+                    IssueSingleDraw();
+                } else {
+                    IssueMultiDraw();
+                }
+
+                mDrawCount = 0;
+                mArraysCommands.clear();
+                mElementsCommands.clear();
+                mPushConstantData.clear();
+            }
+
+          private:
+            struct DrawArraysIndirectCommand {
+                GLuint count;
+                GLuint instanceCount;
+                GLuint first;
+                GLuint baseInstance;
+            };
+
+            struct DrawElementsIndirectCommand {
+                GLuint count;
+                GLuint instanceCount;
+                GLuint firstIndex;
+                GLint baseVertex;
+                GLuint baseInstance;
+            };
+
+            // Instances past the first would read the draw index of the next draws.
+            bool CanBatch(uint32_t instanceCount, uint32_t firstInstance) const {
+                return mPipeline != nullptr && mPipeline->GetBatchedProgramHandle() != 0 &&
+                       instanceCount == 1 && firstInstance == 0;
+            }
+
+            void PrepareToAdd(bool indexed) {
+                if (mDrawCount > 0 &&
+                    (indexed != mIndexed || mDrawCount == mPipeline->GetMaxBatchedDraws())) {
+                    Flush();
+                }
+                mIndexed = indexed;
+            }
+
+            void AddPushConstants() {
+                const auto& values = mPushConstants->GetValues(nxt::ShaderStage::Vertex);
+                size_t offset = mPushConstantData.size();
+                mPushConstantData.resize(offset + mPushConstantStride, 0);
+                memcpy(&mPushConstantData[offset], values.data(),
+                       mPushConstantCount * sizeof(uint32_t));
+                mDrawCount++;
+            }
+
+            // A batch of a single draw is issued directly with its push constants. The current
+            // values are set back afterwards so that the ones that differ get reapplied.
+            void IssueSingleDraw() {
+                std::array<uint32_t, kMaxPushConstants> currentValues =
+                    mPushConstants->GetValues(nxt::ShaderStage::Vertex);
+                mPushConstants->OnSetPushConstants(nxt::ShaderStageBit::Vertex, mPushConstantCount,
+                                                   0, mPushConstantData.data());
+                mPushConstants->Apply(mPipeline, mPipeline);
+
+                GLenum topology = mPipeline->GetGLPrimitiveTopology();
+                if (mIndexed) {
+                    const DrawElementsIndirectCommand& command = mElementsCommands[0];
+                    nxt::IndexFormat indexFormat = mPipeline->GetIndexFormat();
+                    glDrawElementsInstanced(
+                        topology, command.count, IndexFormatType(indexFormat),
+                        reinterpret_cast<void*>(command.firstIndex * IndexFormatSize(indexFormat)),
+                        command.instanceCount);
+                } else {
+                    const DrawArraysIndirectCommand& command = mArraysCommands[0];
+                    glDrawArraysInstanced(topology, command.first, command.count,
+                                          command.instanceCount);
+                }
+
+                mPushConstants->OnSetPushConstants(nxt::ShaderStageBit::Vertex, mPushConstantCount,
+                                                   0, currentValues.data());
+            }
+
+            void IssueMultiDraw() {
+                const Device::BatchedDrawBuffers& buffers = mDevice->GetBatchedDrawBuffers();
+
+                // glBufferData orphans the previous contents that the GPU might still be using.
+                // The bound range covers the whole uniform block even if the batch isn't full.
+                GLsizeiptr blockSize =
+                    mPipeline->GetMaxBatchedDraws() * mPushConstantStride * sizeof(uint32_t);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffers.pushConstants);
+                glBufferData(GL_COPY_WRITE_BUFFER, blockSize, nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_COPY_WRITE_BUFFER, 0,
+                                mPushConstantData.size() * sizeof(uint32_t),
+                                mPushConstantData.data());
+                mPersistentPipelineState->BindBufferRange(GL_UNIFORM_BUFFER,
+                                                          kBatchedPushConstantsBinding,
+                                                          buffers.pushConstants, 0, blockSize);
+
+                mPersistentPipelineState->BindBuffer(GL_DRAW_INDIRECT_BUFFER,
+                                                     buffers.indirectCommands);
+                if (mIndexed) {
+                    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                                 mElementsCommands.size() * sizeof(DrawElementsIndirectCommand),
+                                 mElementsCommands.data(), GL_STREAM_DRAW);
+                } else {
+                    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                                 mArraysCommands.size() * sizeof(DrawArraysIndirectCommand),
+                                 mArraysCommands.data(), GL_STREAM_DRAW);
+                }
+
+                // The batched program has its own uniforms, the fragment push constants are set
+                // on it for each batch.
+                mPersistentPipelineState->UseProgram(mPipeline->GetBatchedProgramHandle());
+                mPushConstants->ApplyAll(
+                    nxt::ShaderStage::Fragment, mPipeline,
+                    mPipeline->GetBatchedGLPushConstants(nxt::ShaderStage::Fragment));
+
+                // The draw index attribute is only enabled during the batch so that the VAOs of the
+                // input state are the same for draws issued directly.
+                glEnableVertexAttribArray(kDrawIndexAttribute);
+                glVertexAttribDivisor(kDrawIndexAttribute, 1);
+                mPersistentPipelineState->VertexAttribPointer(
+                    kDrawIndexAttribute, buffers.drawIndices, 1, GL_FLOAT, GL_FALSE, 0, 0);
+
+                GLenum topology = mPipeline->GetGLPrimitiveTopology();
+                if (mIndexed) {
+                    glMultiDrawElementsIndirect(topology,
+                                                IndexFormatType(mPipeline->GetIndexFormat()),
+                                                nullptr, mDrawCount, 0);
+                } else {
+                    glMultiDrawArraysIndirect(topology, nullptr, mDrawCount, 0);
+                }
+
+                glDisableVertexAttribArray(kDrawIndexAttribute);
+                mPersistentPipelineState->UseProgram(mPipeline->GetProgramHandle());
+            }
+
+            Device* mDevice;
+            PersistentPipelineState* mPersistentPipelineState;
+            PushConstantTracker* mPushConstants;
+            InputBufferTracker* mInputBuffers;
+
+            RenderPipeline* mPipeline = nullptr;
+            uint32_t mPushConstantCount = 0;
+            uint32_t mPushConstantStride = 0;
+
+            uint32_t mDrawCount = 0;
+            bool mIndexed = false;
+            std::vector<DrawArraysIndirectCommand> mArraysCommands;
+            std::vector<DrawElementsIndirectCommand> mElementsCommands;
+            std::vector<uint32_t> mPushConstantData;
+        };
+
     }  // namespace
 
     CommandBuffer::CommandBuffer(CommandBufferBuilder* builder)
@@ -253,10 +444,19 @@ namespace backend { namespace opengl {
 
         PushConstantTracker pushConstants;
         InputBufferTracker inputBuffers;
+        DrawBatcher drawBatcher(ToBackend(GetDevice()), &persistentPipelineState, &pushConstants,
+                                &inputBuffers);
 
         GLuint currentFBO = 0;
 
         while (mCommands.NextCommandId(&type)) {
+            // Other commands can change the state used by the batched draws so they are issued
+            // first. This includes EndRenderPass so no draws are pending at the end.
+            if (type != Command::DrawArrays && type != Command::DrawElements &&
+                type != Command::SetPushConstants) {
+                drawBatcher.Flush();
+            }
+
             switch (type) {
                 case Command::BeginComputePass: {
                     mCommands.NextCommand<BeginComputePassCmd>();
@@ -370,9 +570,9 @@ namespace backend { namespace opengl {
                         }
                     }
 
-                    glBlendColor(0, 0, 0, 0);
-                    glViewport(0, 0, info->GetWidth(), info->GetHeight());
-                    glScissor(0, 0, info->GetWidth(), info->GetHeight());
+                    persistentPipelineState.SetBlendColor(0, 0, 0, 0);
+                    persistentPipelineState.SetViewport(0, 0, info->GetWidth(), info->GetHeight());
+                    persistentPipelineState.SetScissor(0, 0, info->GetWidth(), info->GetHeight());
                 } break;
 
                 case Command::CopyBufferToBuffer: {
@@ -380,13 +580,15 @@ namespace backend { namespace opengl {
                     auto& src = copy->source;
                     auto& dst = copy->destination;
 
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, ToBackend(src.buffer)->GetHandle());
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ToBackend(dst.buffer)->GetHandle());
+                    persistentPipelineState.BindBuffer(GL_PIXEL_PACK_BUFFER,
+                                                       ToBackend(src.buffer)->GetHandle());
+                    persistentPipelineState.BindBuffer(GL_PIXEL_UNPACK_BUFFER,
+                                                       ToBackend(dst.buffer)->GetHandle());
                     glCopyBufferSubData(GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, src.offset,
                                         dst.offset, copy->size);
 
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    persistentPipelineState.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    persistentPipelineState.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
                 } break;
 
                 case Command::CopyBufferToTexture: {
@@ -398,9 +600,9 @@ namespace backend { namespace opengl {
                     GLenum target = texture->GetGLTarget();
                     auto format = texture->GetGLFormat();
 
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->GetHandle());
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(target, texture->GetHandle());
+                    persistentPipelineState.BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->GetHandle());
+                    persistentPipelineState.ActiveTexture(0);
+                    persistentPipelineState.BindTexture(0, target, texture->GetHandle());
 
                     ASSERT(texture->GetDimension() == nxt::TextureDimension::e2D);
                     glPixelStorei(GL_UNPACK_ROW_LENGTH,
@@ -409,7 +611,7 @@ namespace backend { namespace opengl {
                                     format.format, format.type,
                                     reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset)));
                     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    persistentPipelineState.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
                 } break;
 
                 case Command::CopyTextureToBuffer: {
@@ -423,7 +625,7 @@ namespace backend { namespace opengl {
                     // The only way to move data from a texture to a buffer in GL is via
                     // glReadPixels with a pack buffer. Create a temporary FBO for the copy.
                     ASSERT(texture->GetDimension() == nxt::TextureDimension::e2D);
-                    glBindTexture(GL_TEXTURE_2D, texture->GetHandle());
+                    persistentPipelineState.BindTexture(0, GL_TEXTURE_2D, texture->GetHandle());
 
                     GLuint readFBO = 0;
                     glGenFramebuffers(1, &readFBO);
@@ -432,7 +634,7 @@ namespace backend { namespace opengl {
                     glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
                                            texture->GetHandle(), src.level);
 
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
+                    persistentPipelineState.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
                     glPixelStorei(GL_PACK_ROW_LENGTH,
                                   copy->rowPitch / TextureFormatPixelSize(texture->GetFormat()));
                     ASSERT(src.depth == 1 && src.z == 0);
@@ -441,7 +643,7 @@ namespace backend { namespace opengl {
                                  offset);
                     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    persistentPipelineState.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
                     glDeleteFramebuffers(1, &readFBO);
                 } break;
 
@@ -455,8 +657,12 @@ namespace backend { namespace opengl {
 
                 case Command::DrawArrays: {
                     DrawArraysCmd* draw = mCommands.NextCommand<DrawArraysCmd>();
+                    if (drawBatcher.AddDrawArrays(*draw)) {
+                        break;
+                    }
+
                     pushConstants.Apply(lastPipeline, lastGLPipeline);
-                    inputBuffers.Apply();
+                    inputBuffers.Apply(persistentPipelineState);
 
                     if (draw->firstInstance > 0) {
                         glDrawArraysInstancedBaseInstance(
@@ -472,8 +678,12 @@ namespace backend { namespace opengl {
 
                 case Command::DrawElements: {
                     DrawElementsCmd* draw = mCommands.NextCommand<DrawElementsCmd>();
+                    if (drawBatcher.AddDrawElements(*draw, indexBufferBaseOffset)) {
+                        break;
+                    }
+
                     pushConstants.Apply(lastPipeline, lastGLPipeline);
-                    inputBuffers.Apply();
+                    inputBuffers.Apply(persistentPipelineState);
 
                     nxt::IndexFormat indexFormat = lastRenderPipeline->GetIndexFormat();
                     size_t formatSize = IndexFormatSize(indexFormat);
@@ -509,7 +719,7 @@ namespace backend { namespace opengl {
 
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
-                    ToBackend(cmd->pipeline)->ApplyNow();
+                    ToBackend(cmd->pipeline)->ApplyNow(persistentPipelineState);
                     lastGLPipeline = ToBackend(cmd->pipeline).Get();
                     lastPipeline = ToBackend(cmd->pipeline).Get();
                     pushConstants.OnSetPipeline(lastPipeline);
@@ -524,11 +734,16 @@ namespace backend { namespace opengl {
 
                     pushConstants.OnSetPipeline(lastPipeline);
                     inputBuffers.OnSetPipeline(lastRenderPipeline);
+                    drawBatcher.OnSetPipeline(lastRenderPipeline);
                 } break;
 
                 case Command::SetPushConstants: {
                     SetPushConstantsCmd* cmd = mCommands.NextCommand<SetPushConstantsCmd>();
                     uint32_t* data = mCommands.NextData<uint32_t>(cmd->count);
+                    // Batched draws can only differ by their vertex push constants.
+                    if (cmd->stages & ~nxt::ShaderStageBit::Vertex) {
+                        drawBatcher.Flush();
+                    }
                     pushConstants.OnSetPushConstants(cmd->stages, cmd->count, cmd->offset, data);
                 } break;
 
@@ -539,12 +754,12 @@ namespace backend { namespace opengl {
 
                 case Command::SetScissorRect: {
                     SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
-                    glScissor(cmd->x, cmd->y, cmd->width, cmd->height);
+                    persistentPipelineState.SetScissor(cmd->x, cmd->y, cmd->width, cmd->height);
                 } break;
 
                 case Command::SetBlendColor: {
                     SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
-                    glBlendColor(cmd->r, cmd->g, cmd->b, cmd->a);
+                    persistentPipelineState.SetBlendColor(cmd->r, cmd->g, cmd->b, cmd->a);
                 } break;
 
                 case Command::SetBindGroup: {
@@ -564,8 +779,9 @@ namespace backend { namespace opengl {
                                 GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
                                 GLuint uboIndex = indices[binding];
 
-                                glBindBufferRange(GL_UNIFORM_BUFFER, uboIndex, buffer,
-                                                  view->GetOffset(), view->GetSize());
+                                persistentPipelineState.BindBufferRange(
+                                    GL_UNIFORM_BUFFER, uboIndex, buffer, view->GetOffset(),
+                                    view->GetSize());
                             } break;
 
                             case nxt::BindingType::Sampler: {
@@ -575,7 +791,7 @@ namespace backend { namespace opengl {
 
                                 for (auto unit :
                                      lastGLPipeline->GetTextureUnitsForSampler(samplerIndex)) {
-                                    glBindSampler(unit, sampler);
+                                    persistentPipelineState.BindSampler(unit, sampler);
                                 }
                             } break;
 
@@ -589,8 +805,7 @@ namespace backend { namespace opengl {
 
                                 for (auto unit :
                                      lastGLPipeline->GetTextureUnitsForTexture(textureIndex)) {
-                                    glActiveTexture(GL_TEXTURE0 + unit);
-                                    glBindTexture(target, handle);
+                                    persistentPipelineState.BindTexture(unit, target, handle);
                                 }
                             } break;
 
@@ -600,8 +815,9 @@ namespace backend { namespace opengl {
                                 GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
                                 GLuint ssboIndex = indices[binding];
 
-                                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, ssboIndex, buffer,
-                                                  view->GetOffset(), view->GetSize());
+                                persistentPipelineState.BindBufferRange(
+                                    GL_SHADER_STORAGE_BUFFER, ssboIndex, buffer,
+                                    view->GetOffset(), view->GetSize());
                             } break;
                         }
                     }
@@ -638,7 +854,11 @@ namespace backend { namespace opengl {
 
         // HACK: cleanup a tiny bit of state to make this work with
         // virtualized contexts enabled in Chromium
-        glBindSampler(0, 0);
+        persistentPipelineState.BindSampler(0, 0);
+
+        ToBackend(GetDevice())
+            ->AddGLStateCallCounts(persistentPipelineState.GetIssuedCallCount(),
+                                   persistentPipelineState.GetSkippedCallCount());
     }
 
 }}  // namespace backend::opengl
@@ -20,8 +20,8 @@ namespace backend { namespace opengl {
         : ComputePipelineBase(builder), PipelineGL(this, builder) {
     }
 
-    void ComputePipeline::ApplyNow() {
-        PipelineGL::ApplyNow();
+    void ComputePipeline::ApplyNow(PersistentPipelineState& persistentPipelineState) {
+        PipelineGL::ApplyNow(persistentPipelineState);
     }
 
 }}  // namespace backend::opengl
@@ -27,7 +27,7 @@ namespace backend { namespace opengl {
       public:
         ComputePipeline(ComputePipelineBuilder* builder);
 
-        void ApplyNow();
+        void ApplyNow(PersistentPipelineState& persistentPipelineState);
     };
 
 }}  // namespace backend::opengl
@@ -76,26 +76,13 @@ namespace backend { namespace opengl {
         auto& depthInfo = GetDepth();
 
         // Depth writes only occur if depth is enabled
-        if (depthInfo.compareFunction == nxt::CompareFunction::Always &&
-            !depthInfo.depthWriteEnabled) {
-            glDisable(GL_DEPTH_TEST);
-        } else {
-            glEnable(GL_DEPTH_TEST);
-        }
-
-        if (depthInfo.depthWriteEnabled) {
-            glDepthMask(GL_TRUE);
-        } else {
-            glDepthMask(GL_FALSE);
-        }
+        persistentPipelineState.SetDepthTestEnabled(
+            depthInfo.compareFunction != nxt::CompareFunction::Always ||
+            depthInfo.depthWriteEnabled);
+        persistentPipelineState.SetDepthMask(depthInfo.depthWriteEnabled);
+        persistentPipelineState.SetDepthFunc(OpenGLCompareFunction(depthInfo.compareFunction));
 
-        glDepthFunc(OpenGLCompareFunction(depthInfo.compareFunction));
-
-        if (StencilTestEnabled()) {
-            glEnable(GL_STENCIL_TEST);
-        } else {
-            glDisable(GL_STENCIL_TEST);
-        }
+        persistentPipelineState.SetStencilTestEnabled(StencilTestEnabled());
 
         auto& stencilInfo = GetStencil();
 
@@ -104,14 +91,16 @@ namespace backend { namespace opengl {
         persistentPipelineState.SetStencilFuncsAndMask(backCompareFunction, frontCompareFunction,
                                                        stencilInfo.readMask);
 
-        glStencilOpSeparate(GL_BACK, OpenGLStencilOperation(stencilInfo.back.stencilFail),
-                            OpenGLStencilOperation(stencilInfo.back.depthFail),
-                            OpenGLStencilOperation(stencilInfo.back.depthStencilPass));
-        glStencilOpSeparate(GL_FRONT, OpenGLStencilOperation(stencilInfo.front.stencilFail),
-                            OpenGLStencilOperation(stencilInfo.front.depthFail),
-                            OpenGLStencilOperation(stencilInfo.front.depthStencilPass));
+        persistentPipelineState.SetStencilOp(
+            GL_BACK, OpenGLStencilOperation(stencilInfo.back.stencilFail),
+            OpenGLStencilOperation(stencilInfo.back.depthFail),
+            OpenGLStencilOperation(stencilInfo.back.depthStencilPass));
+        persistentPipelineState.SetStencilOp(
+            GL_FRONT, OpenGLStencilOperation(stencilInfo.front.stencilFail),
+            OpenGLStencilOperation(stencilInfo.front.depthFail),
+            OpenGLStencilOperation(stencilInfo.front.depthStencilPass));
 
-        glStencilMask(stencilInfo.writeMask);
+        persistentPipelineState.SetStencilWriteMask(stencilInfo.writeMask);
     }
 
 }}  // namespace backend::opengl
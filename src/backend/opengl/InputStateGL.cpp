@@ -15,22 +15,143 @@
 #include "backend/opengl/InputStateGL.h"
 
 #include "backend/opengl/OpenGLBackend.h"
+#include "backend/opengl/PersistentPipelineStateGL.h"
 #include "common/Assert.h"
+#include "common/BitSetIterator.h"
 
 namespace backend { namespace opengl {
 
-    InputState::InputState(InputStateBuilder* builder) : InputStateBase(builder) {
-        glGenVertexArrays(1, &mVertexArrayObject);
-        glBindVertexArray(mVertexArrayObject);
-        auto& attributesSetMask = GetAttributesSetMask();
-        for (uint32_t location = 0; location < attributesSetMask.size(); ++location) {
-            if (!attributesSetMask[location]) {
-                continue;
+    namespace {
+
+        GLenum VertexFormatType(nxt::VertexFormat format) {
+            switch (format) {
+                case nxt::VertexFormat::FloatR32G32B32A32:
+                case nxt::VertexFormat::FloatR32G32B32:
+                case nxt::VertexFormat::FloatR32G32:
+                case nxt::VertexFormat::FloatR32:
+                    return GL_FLOAT;
+                case nxt::VertexFormat::IntR32G32B32A32:
+                case nxt::VertexFormat::IntR32G32B32:
+                case nxt::VertexFormat::IntR32G32:
+                case nxt::VertexFormat::IntR32:
+                    return GL_INT;
+                case nxt::VertexFormat::UshortR16G16B16A16:
+                case nxt::VertexFormat::UshortR16G16:
+                    return GL_UNSIGNED_SHORT;
+                case nxt::VertexFormat::UnormR8G8B8A8:
+                case nxt::VertexFormat::UnormR8G8:
+                    return GL_UNSIGNED_BYTE;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        GLboolean VertexFormatIsNormalized(nxt::VertexFormat format) {
+            switch (format) {
+                case nxt::VertexFormat::UnormR8G8B8A8:
+                case nxt::VertexFormat::UnormR8G8:
+                    return GL_TRUE;
+                default:
+                    return GL_FALSE;
+            }
+        }
+
+        bool operator==(const InputState::VertexBuffers& a, const InputState::VertexBuffers& b) {
+            return a.indexBuffer == b.indexBuffer && a.buffers == b.buffers &&
+                   a.offsets == b.offsets;
+        }
+
+    }  // namespace
+
+    InputState::InputState(InputStateBuilder* builder)
+        : InputStateBase(builder), mDevice(ToBackend(builder->GetDevice())) {
+        for (uint32_t location : IterateBitSet(GetAttributesSetMask())) {
+            attributesUsingInput[GetAttribute(location).bindingSlot][location] = true;
+        }
+        mDevice->AddInputState(this);
+    }
+
+    InputState::~InputState() {
+        mDevice->RemoveInputState(this);
+        for (const auto& cached : mCachedVAOs) {
+            glDeleteVertexArrays(1, &cached.vao);
+        }
+    }
+
+    std::bitset<kMaxVertexAttributes> InputState::GetAttributesUsingInput(uint32_t slot) const {
+        return attributesUsingInput[slot];
+    }
+
+    void InputState::ApplyVertexBuffers(const VertexBuffers& vertexBuffers,
+                                        PersistentPipelineState& persistentPipelineState) {
+        mUseCounter++;
+
+        for (auto& cached : mCachedVAOs) {
+            if (cached.vertexBuffers == vertexBuffers) {
+                cached.lastUsed = mUseCounter;
+                persistentPipelineState.BindVertexArray(cached.vao);
+                return;
             }
+        }
+
+        // Cache miss, create a new VAO or recycle the least recently used one.
+        CachedVAO* target = nullptr;
+        if (mCachedVAOs.size() < kMaxCachedVAOs) {
+            mCachedVAOs.push_back(
+                {vertexBuffers, CreateVAO(persistentPipelineState), mUseCounter});
+            target = &mCachedVAOs.back();
+        } else {
+            target = &mCachedVAOs[0];
+            for (auto& cached : mCachedVAOs) {
+                if (cached.lastUsed < target->lastUsed) {
+                    target = &cached;
+                }
+            }
+            target->vertexBuffers = vertexBuffers;
+            target->lastUsed = mUseCounter;
+        }
+
+        persistentPipelineState.BindVertexArray(target->vao);
+        persistentPipelineState.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexBuffers.indexBuffer);
+
+        for (uint32_t location : IterateBitSet(GetAttributesSetMask())) {
+            auto attribute = GetAttribute(location);
+            auto input = GetInput(attribute.bindingSlot);
+
+            persistentPipelineState.VertexAttribPointer(
+                location, vertexBuffers.buffers[attribute.bindingSlot],
+                VertexFormatNumComponents(attribute.format), VertexFormatType(attribute.format),
+                VertexFormatIsNormalized(attribute.format), input.stride,
+                vertexBuffers.offsets[attribute.bindingSlot] + attribute.offset);
+        }
+    }
+
+    void InputState::OnBufferDestroyed(GLuint buffer) {
+        for (auto it = mCachedVAOs.begin(); it != mCachedVAOs.end();) {
+            const VertexBuffers& vertexBuffers = it->vertexBuffers;
+            bool usesBuffer = vertexBuffers.indexBuffer == buffer;
+            for (uint32_t slot : IterateBitSet(GetInputsSetMask())) {
+                usesBuffer = usesBuffer || vertexBuffers.buffers[slot] == buffer;
+            }
+
+            if (usesBuffer) {
+                glDeleteVertexArrays(1, &it->vao);
+                it = mCachedVAOs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    GLuint InputState::CreateVAO(PersistentPipelineState& persistentPipelineState) const {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        persistentPipelineState.BindVertexArray(vao);
+
+        for (uint32_t location : IterateBitSet(GetAttributesSetMask())) {
             auto attribute = GetAttribute(location);
             glEnableVertexAttribArray(location);
 
-            attributesUsingInput[attribute.bindingSlot][location] = true;
             auto input = GetInput(attribute.bindingSlot);
 
             if (input.stride == 0) {
@@ -49,14 +170,8 @@ namespace backend { namespace opengl {
                 }
             }
         }
-    }
-
-    std::bitset<kMaxVertexAttributes> InputState::GetAttributesUsingInput(uint32_t slot) const {
-        return attributesUsingInput[slot];
-    }
 
-    GLuint InputState::GetVAO() {
-        return mVertexArrayObject;
+        return vao;
     }
 
 }}  // namespace backend::opengl
@@ -19,19 +19,52 @@
 
 #include "glad/glad.h"
 
+#include <array>
+#include <vector>
+
 namespace backend { namespace opengl {
 
     class Device;
+    class PersistentPipelineState;
 
     class InputState : public InputStateBase {
       public:
         InputState(InputStateBuilder* builder);
+        ~InputState();
+
+        // The buffers are part of the VAO state in OpenGL. Handles are used to identify buffers,
+        // the VAOs using a buffer are removed from the cache when it is destroyed so that its
+        // handle can be reused.
+        struct VertexBuffers {
+            std::array<GLuint, kMaxVertexInputs> buffers = {};
+            std::array<uint32_t, kMaxVertexInputs> offsets = {};
+            GLuint indexBuffer = 0;
+        };
 
         std::bitset<kMaxVertexAttributes> GetAttributesUsingInput(uint32_t slot) const;
-        GLuint GetVAO();
+
+        // Binds a VAO with vertexBuffers applied. VAOs are kept in a small LRU cache so that
+        // switching between buffers already seen only costs a glBindVertexArray.
+        void ApplyVertexBuffers(const VertexBuffers& vertexBuffers,
+                                PersistentPipelineState& persistentPipelineState);
+
+        // Deletes the cached VAOs that use buffer, called by the device when buffer is deleted.
+        void OnBufferDestroyed(GLuint buffer);
 
       private:
-        GLuint mVertexArrayObject;
+        GLuint CreateVAO(PersistentPipelineState& persistentPipelineState) const;
+
+        Device* mDevice = nullptr;
+
+        static constexpr size_t kMaxCachedVAOs = 8;
+        struct CachedVAO {
+            VertexBuffers vertexBuffers;
+            GLuint vao;
+            uint64_t lastUsed;
+        };
+        std::vector<CachedVAO> mCachedVAOs;
+        uint64_t mUseCounter = 0;
+
         std::array<std::bitset<kMaxVertexAttributes>, kMaxVertexInputs> attributesUsingInput;
     };
 
@@ -14,6 +14,7 @@
 
 #include "backend/opengl/OpenGLBackend.h"
 
+#include "backend/ProcProfiler.h"
 #include "backend/opengl/BlendStateGL.h"
 #include "backend/opengl/BufferGL.h"
 #include "backend/opengl/CommandBufferGL.h"
@@ -26,17 +27,22 @@
 #include "backend/opengl/ShaderModuleGL.h"
 #include "backend/opengl/SwapChainGL.h"
 #include "backend/opengl/TextureGL.h"
+#include "common/Assert.h"
+#include "common/Trace.h"
+
+#include <array>
 
 namespace backend { namespace opengl {
     nxtProcTable GetNonValidatingProcs();
     nxtProcTable GetValidatingProcs();
+    nxtProcTable GetProfilingProcs();
 
     void Init(void* (*getProc)(const char*), nxtProcTable* procs, nxtDevice* device) {
         *device = nullptr;
 
         gladLoadGLLoader(reinterpret_cast<GLADloadproc>(getProc));
 
-        *procs = GetValidatingProcs();
+        *procs = IsProcProfilingEnabled() ? GetProfilingProcs() : GetValidatingProcs();
         *device = reinterpret_cast<nxtDevice>(new Device);
 
         glEnable(GL_DEPTH_TEST);
@@ -44,8 +50,34 @@ namespace backend { namespace opengl {
         glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
     }
 
+    void GetGLStateCallCounts(nxtDevice device, uint64_t* issued, uint64_t* skipped) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *issued = backendDevice->GetIssuedGLStateCallCount();
+        *skipped = backendDevice->GetSkippedGLStateCallCount();
+    }
+
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *lastSubmitted = backendDevice->GetLastSubmittedSerial();
+        *completed = backendDevice->GetCompletedSerial();
+    }
+
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        return backendDevice->WaitForSerial(serial, timeoutNs);
+    }
+
     // Device
 
+    Device::~Device() {
+        for (const auto& fenceAndSerial : mFencesInFlight) {
+            glDeleteSync(fenceAndSerial.first);
+        }
+        glDeleteBuffers(1, &mBatchedDrawBuffers.indirectCommands);
+        glDeleteBuffers(1, &mBatchedDrawBuffers.pushConstants);
+        glDeleteBuffers(1, &mBatchedDrawBuffers.drawIndices);
+    }
+
     BindGroupBase* Device::CreateBindGroup(BindGroupBuilder* builder) {
         return new BindGroup(builder);
     }
@@ -103,6 +135,112 @@ namespace backend { namespace opengl {
     }
 
     void Device::TickImpl() {
+        CheckPassedFences();
+        mBufferUploader.Tick();
+    }
+
+    Serial Device::GetLastSubmittedSerial() const {
+        return mLastSubmittedSerial;
+    }
+
+    Serial Device::GetCompletedSerial() const {
+        return mCompletedSerial;
+    }
+
+    bool Device::WaitForSerial(Serial serial, uint64_t timeoutNs) {
+        CheckPassedFences();
+        if (serial <= mCompletedSerial) {
+            return true;
+        }
+
+        // Fences are in serial order so the first one at or after serial covers its work.
+        for (const auto& fenceAndSerial : mFencesInFlight) {
+            if (fenceAndSerial.second < serial) {
+                continue;
+            }
+
+            GLenum status =
+                glClientWaitSync(fenceAndSerial.first, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+            ASSERT(status != GL_WAIT_FAILED);
+            break;
+        }
+
+        CheckPassedFences();
+        return serial <= mCompletedSerial;
+    }
+
+    void Device::SubmitFenceSync() {
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mLastSubmittedSerial++;
+        mFencesInFlight.emplace_back(fence, mLastSubmittedSerial);
+    }
+
+    void Device::CheckPassedFences() {
+        while (!mFencesInFlight.empty()) {
+            GLsync fence = mFencesInFlight.front().first;
+            Serial fenceSerial = mFencesInFlight.front().second;
+
+            // Fences are added in order, so we can stop searching as soon as we see one that's
+            // not signaled.
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                return;
+            }
+
+            glDeleteSync(fence);
+            mFencesInFlight.pop_front();
+
+            ASSERT(fenceSerial > mCompletedSerial);
+            mCompletedSerial = fenceSerial;
+        }
+    }
+
+    BufferUploader* Device::GetBufferUploader() {
+        return &mBufferUploader;
+    }
+
+    const Device::BatchedDrawBuffers& Device::GetBatchedDrawBuffers() {
+        if (mBatchedDrawBuffers.drawIndices == 0) {
+            glGenBuffers(1, &mBatchedDrawBuffers.indirectCommands);
+            glGenBuffers(1, &mBatchedDrawBuffers.pushConstants);
+            glGenBuffers(1, &mBatchedDrawBuffers.drawIndices);
+
+            std::array<float, kMaxBatchedDraws> drawIndices;
+            for (uint32_t i = 0; i < kMaxBatchedDraws; ++i) {
+                drawIndices[i] = static_cast<float>(i);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, mBatchedDrawBuffers.drawIndices);
+            glBufferData(GL_COPY_WRITE_BUFFER, sizeof(drawIndices), drawIndices.data(),
+                         GL_STATIC_DRAW);
+        }
+        return mBatchedDrawBuffers;
+    }
+
+    void Device::AddGLStateCallCounts(uint64_t issued, uint64_t skipped) {
+        mIssuedGLStateCalls += issued;
+        mSkippedGLStateCalls += skipped;
+    }
+
+    uint64_t Device::GetIssuedGLStateCallCount() const {
+        return mIssuedGLStateCalls;
+    }
+
+    uint64_t Device::GetSkippedGLStateCallCount() const {
+        return mSkippedGLStateCalls;
+    }
+
+    void Device::AddInputState(InputState* inputState) {
+        mInputStates.insert(inputState);
+    }
+
+    void Device::RemoveInputState(InputState* inputState) {
+        mInputStates.erase(inputState);
+    }
+
+    void Device::OnBufferDestroyed(GLuint buffer) {
+        for (InputState* inputState : mInputStates) {
+            inputState->OnBufferDestroyed(buffer);
+        }
     }
 
     // Bind Group
@@ -122,9 +260,12 @@ namespace backend { namespace opengl {
     }
 
     void Queue::Submit(uint32_t numCommands, CommandBuffer* const* commands) {
+        NXT_TRACE_SCOPE("Queue::Submit");
         for (uint32_t i = 0; i < numCommands; ++i) {
             commands[i]->Execute();
         }
+
+        ToBackend(GetDevice())->SubmitFenceSync();
     }
 
     // RenderPassDescriptor
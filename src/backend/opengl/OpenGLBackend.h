@@ -27,9 +27,14 @@
 #include "backend/Queue.h"
 #include "backend/RenderPassDescriptor.h"
 #include "backend/ToBackend.h"
+#include "backend/opengl/BufferUploaderGL.h"
+#include "common/Serial.h"
 
 #include "glad/glad.h"
 
+#include <deque>
+#include <unordered_set>
+
 namespace backend { namespace opengl {
 
     class BindGroup;
@@ -83,6 +88,8 @@ namespace backend { namespace opengl {
     // Definition of backend types
     class Device : public DeviceBase {
       public:
+        ~Device();
+
         BindGroupBase* CreateBindGroup(BindGroupBuilder* builder) override;
         BindGroupLayoutBase* CreateBindGroupLayout(BindGroupLayoutBuilder* builder) override;
         BlendStateBase* CreateBlendState(BlendStateBuilder* builder) override;
@@ -104,6 +111,51 @@ namespace backend { namespace opengl {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        Serial GetLastSubmittedSerial() const override;
+        Serial GetCompletedSerial() const override;
+        bool WaitForSerial(Serial serial, uint64_t timeoutNs) override;
+
+        BufferUploader* GetBufferUploader();
+
+        // Buffers used by command buffers to batch draws, created on first use. The push constants
+        // and indirect commands are streamed, the draw indices hold 0 to kMaxBatchedDraws - 1.
+        struct BatchedDrawBuffers {
+            GLuint indirectCommands = 0;
+            GLuint pushConstants = 0;
+            GLuint drawIndices = 0;
+        };
+        const BatchedDrawBuffers& GetBatchedDrawBuffers();
+
+        // Inserts a fence after the commands submitted so far and associates it with a new serial.
+        void SubmitFenceSync();
+
+        // Statistics of the GL state-setting calls made and skipped by command buffers.
+        void AddGLStateCallCounts(uint64_t issued, uint64_t skipped);
+        uint64_t GetIssuedGLStateCallCount() const;
+        uint64_t GetSkippedGLStateCallCount() const;
+
+        // InputStates cache VAOs referencing buffers by handle, they are told when a buffer is
+        // destroyed so that they drop these VAOs.
+        void AddInputState(InputState* inputState);
+        void RemoveInputState(InputState* inputState);
+        void OnBufferDestroyed(GLuint buffer);
+
+      private:
+        void CheckPassedFences();
+
+        BufferUploader mBufferUploader;
+        BatchedDrawBuffers mBatchedDrawBuffers;
+
+        // Same serial tracking as the Vulkan backend, with a GLsync fence inserted after each
+        // submit.
+        std::deque<std::pair<GLsync, Serial>> mFencesInFlight;
+        Serial mLastSubmittedSerial = 0;
+        Serial mCompletedSerial = 0;
+
+        uint64_t mIssuedGLStateCalls = 0;
+        uint64_t mSkippedGLStateCalls = 0;
+
+        std::unordered_set<InputState*> mInputStates;
     };
 
     class BindGroup : public BindGroupBase {
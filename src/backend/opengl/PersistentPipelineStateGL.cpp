@@ -14,7 +14,7 @@
 
 #include "backend/opengl/PersistentPipelineStateGL.h"
 
-#include "backend/opengl/OpenGLBackend.h"
+#include "common/Assert.h"
 
 namespace backend { namespace opengl {
 
@@ -22,12 +22,201 @@ namespace backend { namespace opengl {
         CallGLStencilFunc();
     }
 
+    template <typename T>
+    bool PersistentPipelineState::Update(Cached<T>* cached, const T& value) {
+        if (cached->known && cached->value == value) {
+            mSkippedCalls++;
+            return false;
+        }
+
+        cached->known = true;
+        cached->value = value;
+        mIssuedCalls++;
+        return true;
+    }
+
+    void PersistentPipelineState::BindBuffer(GLenum target, GLuint buffer) {
+        Cached<GLuint>* cached = nullptr;
+        switch (target) {
+            case GL_ARRAY_BUFFER:
+                cached = &mArrayBuffer;
+                break;
+            case GL_ELEMENT_ARRAY_BUFFER:
+                cached = &mElementArrayBuffer;
+                break;
+            case GL_PIXEL_PACK_BUFFER:
+                cached = &mPixelPackBuffer;
+                break;
+            case GL_PIXEL_UNPACK_BUFFER:
+                cached = &mPixelUnpackBuffer;
+                break;
+            case GL_DRAW_INDIRECT_BUFFER:
+                cached = &mDrawIndirectBuffer;
+                break;
+            default:
+                UNREACHABLE();
+        }
+
+        if (Update(cached, buffer)) {
+            glBindBuffer(target, buffer);
+        }
+    }
+
+    void PersistentPipelineState::BindBufferRange(GLenum target,
+                                                  GLuint index,
+                                                  GLuint buffer,
+                                                  GLintptr offset,
+                                                  GLsizeiptr size) {
+        ASSERT(index < kMaxIndexedBuffers);
+        ASSERT(target == GL_UNIFORM_BUFFER || target == GL_SHADER_STORAGE_BUFFER);
+        auto& bindings = target == GL_UNIFORM_BUFFER ? mUniformBuffers : mStorageBuffers;
+
+        if (Update(&bindings[index], BufferRange(buffer, offset, size))) {
+            glBindBufferRange(target, index, buffer, offset, size);
+        }
+    }
+
+    void PersistentPipelineState::BindVertexArray(GLuint vertexArray) {
+        if (Update(&mVertexArray, vertexArray)) {
+            glBindVertexArray(vertexArray);
+            InvalidateVertexArrayState();
+        }
+    }
+
+    void PersistentPipelineState::VertexAttribPointer(GLuint location,
+                                                      GLuint buffer,
+                                                      GLint components,
+                                                      GLenum type,
+                                                      GLboolean normalized,
+                                                      GLsizei stride,
+                                                      uintptr_t offset) {
+        ASSERT(location < kMaxVertexAttributes);
+        AttribPointer pointer(buffer, components, type, normalized, stride, offset);
+
+        if (Update(&mAttribPointers[location], pointer)) {
+            BindBuffer(GL_ARRAY_BUFFER, buffer);
+            glVertexAttribPointer(location, components, type, normalized, stride,
+                                  reinterpret_cast<void*>(offset));
+        }
+    }
+
+    void PersistentPipelineState::UseProgram(GLuint program) {
+        if (Update(&mProgram, program)) {
+            glUseProgram(program);
+        }
+    }
+
+    void PersistentPipelineState::ActiveTexture(GLuint unit) {
+        ASSERT(unit < kMaxTextureUnits);
+        if (Update(&mActiveTextureUnit, unit)) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+    }
+
+    void PersistentPipelineState::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+        ASSERT(unit < kMaxTextureUnits);
+        if (Update(&mTextures[unit], TextureBinding(target, texture))) {
+            ActiveTexture(unit);
+            glBindTexture(target, texture);
+        }
+    }
+
+    void PersistentPipelineState::BindSampler(GLuint unit, GLuint sampler) {
+        ASSERT(unit < kMaxTextureUnits);
+        if (Update(&mSamplers[unit], sampler)) {
+            glBindSampler(unit, sampler);
+        }
+    }
+
+    void PersistentPipelineState::SetBlendEnabled(uint32_t attachment, bool enabled) {
+        ASSERT(attachment < kMaxColorAttachments);
+        if (Update(&mBlendEnabled[attachment], enabled)) {
+            if (enabled) {
+                glEnablei(GL_BLEND, attachment);
+            } else {
+                glDisablei(GL_BLEND, attachment);
+            }
+        }
+    }
+
+    void PersistentPipelineState::SetBlendEquation(uint32_t attachment,
+                                                   GLenum colorMode,
+                                                   GLenum alphaMode) {
+        ASSERT(attachment < kMaxColorAttachments);
+        if (Update(&mBlendEquations[attachment], std::make_tuple(colorMode, alphaMode))) {
+            glBlendEquationSeparatei(attachment, colorMode, alphaMode);
+        }
+    }
+
+    void PersistentPipelineState::SetBlendFunc(uint32_t attachment,
+                                               GLenum colorSrcFactor,
+                                               GLenum colorDstFactor,
+                                               GLenum alphaSrcFactor,
+                                               GLenum alphaDstFactor) {
+        ASSERT(attachment < kMaxColorAttachments);
+        BlendFunc func(colorSrcFactor, colorDstFactor, alphaSrcFactor, alphaDstFactor);
+        if (Update(&mBlendFuncs[attachment], func)) {
+            glBlendFuncSeparatei(attachment, colorSrcFactor, colorDstFactor, alphaSrcFactor,
+                                 alphaDstFactor);
+        }
+    }
+
+    void PersistentPipelineState::SetColorMask(uint32_t attachment,
+                                               bool red,
+                                               bool green,
+                                               bool blue,
+                                               bool alpha) {
+        ASSERT(attachment < kMaxColorAttachments);
+        if (Update(&mColorMasks[attachment], ColorMask(red, green, blue, alpha))) {
+            glColorMaski(attachment, red, green, blue, alpha);
+        }
+    }
+
+    void PersistentPipelineState::SetBlendColor(float r, float g, float b, float a) {
+        if (Update(&mBlendColor, std::make_tuple(r, g, b, a))) {
+            glBlendColor(r, g, b, a);
+        }
+    }
+
+    void PersistentPipelineState::SetDepthTestEnabled(bool enabled) {
+        if (Update(&mDepthTestEnabled, enabled)) {
+            if (enabled) {
+                glEnable(GL_DEPTH_TEST);
+            } else {
+                glDisable(GL_DEPTH_TEST);
+            }
+        }
+    }
+
+    void PersistentPipelineState::SetDepthMask(bool enabled) {
+        if (Update(&mDepthMask, enabled)) {
+            glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        }
+    }
+
+    void PersistentPipelineState::SetDepthFunc(GLenum depthFunction) {
+        if (Update(&mDepthFunc, depthFunction)) {
+            glDepthFunc(depthFunction);
+        }
+    }
+
+    void PersistentPipelineState::SetStencilTestEnabled(bool enabled) {
+        if (Update(&mStencilTestEnabled, enabled)) {
+            if (enabled) {
+                glEnable(GL_STENCIL_TEST);
+            } else {
+                glDisable(GL_STENCIL_TEST);
+            }
+        }
+    }
+
     void PersistentPipelineState::SetStencilFuncsAndMask(GLenum stencilBackCompareFunction,
                                                          GLenum stencilFrontCompareFunction,
                                                          uint32_t stencilReadMask) {
         if (mStencilBackCompareFunction == stencilBackCompareFunction &&
             mStencilFrontCompareFunction == stencilFrontCompareFunction &&
             mStencilReadMask == stencilReadMask) {
+            mSkippedCalls += 2;
             return;
         }
 
@@ -39,6 +228,7 @@ namespace backend { namespace opengl {
 
     void PersistentPipelineState::SetStencilReference(uint32_t stencilReference) {
         if (mStencilReference == stencilReference) {
+            mSkippedCalls += 2;
             return;
         }
 
@@ -46,11 +236,58 @@ namespace backend { namespace opengl {
         CallGLStencilFunc();
     }
 
+    void PersistentPipelineState::SetStencilOp(GLenum face,
+                                               GLenum stencilFail,
+                                               GLenum depthFail,
+                                               GLenum depthPass) {
+        ASSERT(face == GL_BACK || face == GL_FRONT);
+        auto* cached = face == GL_BACK ? &mStencilBackOp : &mStencilFrontOp;
+        if (Update(cached, std::make_tuple(stencilFail, depthFail, depthPass))) {
+            glStencilOpSeparate(face, stencilFail, depthFail, depthPass);
+        }
+    }
+
+    void PersistentPipelineState::SetStencilWriteMask(uint32_t stencilWriteMask) {
+        if (Update(&mStencilWriteMask, stencilWriteMask)) {
+            glStencilMask(stencilWriteMask);
+        }
+    }
+
+    void PersistentPipelineState::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        if (Update(&mViewport, Rect(x, y, width, height))) {
+            glViewport(x, y, width, height);
+        }
+    }
+
+    void PersistentPipelineState::SetScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+        if (Update(&mScissor, Rect(x, y, width, height))) {
+            glScissor(x, y, width, height);
+        }
+    }
+
+    uint64_t PersistentPipelineState::GetIssuedCallCount() const {
+        return mIssuedCalls;
+    }
+
+    uint64_t PersistentPipelineState::GetSkippedCallCount() const {
+        return mSkippedCalls;
+    }
+
     void PersistentPipelineState::CallGLStencilFunc() {
         glStencilFuncSeparate(GL_BACK, mStencilBackCompareFunction, mStencilReference,
                               mStencilReadMask);
         glStencilFuncSeparate(GL_FRONT, mStencilFrontCompareFunction, mStencilReference,
                               mStencilReadMask);
+        mIssuedCalls += 2;
+    }
+
+    void PersistentPipelineState::InvalidateVertexArrayState() {
+        // The element array buffer binding and the attribute pointers are part of the VAO state
+        // so we don't know their value in the newly bound VAO.
+        mElementArrayBuffer.known = false;
+        for (auto& pointer : mAttribPointers) {
+            pointer.known = false;
+        }
     }
 
 }}  // namespace backend::opengl
@@ -15,27 +15,153 @@
 #ifndef BACKEND_OPENGL_PERSISTENTPIPELINESTATEGL_H_
 #define BACKEND_OPENGL_PERSISTENTPIPELINESTATEGL_H_
 
+#include "common/Constants.h"
+
 #include "nxt/nxtcpp.h"
 
 #include "glad/glad.h"
 
+#include <array>
+#include <cstdint>
+#include <tuple>
+
 namespace backend { namespace opengl {
 
+    // Shadow of the OpenGL context state that is modified while executing command buffers. All
+    // the state-setting GL calls of CommandBuffer::Execute go through this object so that calls
+    // setting a value that is already current are filtered out.
+    //
+    // Code outside of command buffer execution (resource creation, swapchains) also modifies the
+    // GL context so the shadow starts with all values unknown, except the stencil state that is
+    // reset with SetDefaultState.
     class PersistentPipelineState {
       public:
         void SetDefaultState();
+
+        // Buffer and vertex array object bindings
+        void BindBuffer(GLenum target, GLuint buffer);
+        void BindBufferRange(GLenum target,
+                             GLuint index,
+                             GLuint buffer,
+                             GLintptr offset,
+                             GLsizeiptr size);
+        void BindVertexArray(GLuint vertexArray);
+        // The GL_ARRAY_BUFFER binding is part of the attribute pointer state so it is only set
+        // when the attribute pointer needs to be updated.
+        void VertexAttribPointer(GLuint location,
+                                 GLuint buffer,
+                                 GLint components,
+                                 GLenum type,
+                                 GLboolean normalized,
+                                 GLsizei stride,
+                                 uintptr_t offset);
+
+        // Program, texture and sampler bindings
+        void UseProgram(GLuint program);
+        void ActiveTexture(GLuint unit);
+        // Doesn't change the active texture unit if the texture is already bound to unit, call
+        // ActiveTexture before operations that use the texture bound to the active unit.
+        void BindTexture(GLuint unit, GLenum target, GLuint texture);
+        void BindSampler(GLuint unit, GLuint sampler);
+
+        // Blend state, per color attachment except for the blend color.
+        void SetBlendEnabled(uint32_t attachment, bool enabled);
+        void SetBlendEquation(uint32_t attachment, GLenum colorMode, GLenum alphaMode);
+        void SetBlendFunc(uint32_t attachment,
+                          GLenum colorSrcFactor,
+                          GLenum colorDstFactor,
+                          GLenum alphaSrcFactor,
+                          GLenum alphaDstFactor);
+        void SetColorMask(uint32_t attachment, bool red, bool green, bool blue, bool alpha);
+        void SetBlendColor(float r, float g, float b, float a);
+
+        // Depth and stencil state
+        void SetDepthTestEnabled(bool enabled);
+        void SetDepthMask(bool enabled);
+        void SetDepthFunc(GLenum depthFunction);
+        void SetStencilTestEnabled(bool enabled);
         void SetStencilFuncsAndMask(GLenum stencilBackCompareFunction,
                                     GLenum stencilFrontCompareFunction,
                                     uint32_t stencilReadMask);
         void SetStencilReference(uint32_t stencilReference);
+        void SetStencilOp(GLenum face, GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+        void SetStencilWriteMask(uint32_t stencilWriteMask);
+
+        // Rasterizer state
+        void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        void SetScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        // Number of GL calls made and filtered out by this object since its creation.
+        uint64_t GetIssuedCallCount() const;
+        uint64_t GetSkippedCallCount() const;
 
       private:
+        template <typename T>
+        struct Cached {
+            bool known = false;
+            T value;
+        };
+
+        // Returns whether the GL call setting value must be made and records value as current.
+        template <typename T>
+        bool Update(Cached<T>* cached, const T& value);
+
         void CallGLStencilFunc();
+        void InvalidateVertexArrayState();
+
+        static constexpr uint32_t kMaxTextureUnits = kMaxBindGroups * kMaxBindingsPerGroup;
+        // One more indexed buffer for the push constants of batched draws.
+        static constexpr uint32_t kMaxIndexedBuffers = kMaxBindGroups * kMaxBindingsPerGroup + 1;
 
         GLenum mStencilBackCompareFunction = GL_ALWAYS;
         GLenum mStencilFrontCompareFunction = GL_ALWAYS;
         GLuint mStencilReadMask = 0xffffffff;
         GLuint mStencilReference = 0;
+
+        using BufferRange = std::tuple<GLuint, GLintptr, GLsizeiptr>;
+        using AttribPointer = std::tuple<GLuint, GLint, GLenum, GLboolean, GLsizei, uintptr_t>;
+        using TextureBinding = std::tuple<GLenum, GLuint>;
+        using BlendFunc = std::tuple<GLenum, GLenum, GLenum, GLenum>;
+        using ColorMask = std::tuple<bool, bool, bool, bool>;
+        using Rect = std::tuple<GLint, GLint, GLsizei, GLsizei>;
+
+        // Non-indexed buffer bindings, the element array buffer is tracked separately because
+        // it is part of the vertex array object state.
+        Cached<GLuint> mArrayBuffer;
+        Cached<GLuint> mElementArrayBuffer;
+        Cached<GLuint> mPixelPackBuffer;
+        Cached<GLuint> mPixelUnpackBuffer;
+        Cached<GLuint> mDrawIndirectBuffer;
+        std::array<Cached<BufferRange>, kMaxIndexedBuffers> mUniformBuffers;
+        std::array<Cached<BufferRange>, kMaxIndexedBuffers> mStorageBuffers;
+
+        Cached<GLuint> mVertexArray;
+        std::array<Cached<AttribPointer>, kMaxVertexAttributes> mAttribPointers;
+
+        Cached<GLuint> mProgram;
+        Cached<GLuint> mActiveTextureUnit;
+        std::array<Cached<TextureBinding>, kMaxTextureUnits> mTextures;
+        std::array<Cached<GLuint>, kMaxTextureUnits> mSamplers;
+
+        std::array<Cached<bool>, kMaxColorAttachments> mBlendEnabled;
+        std::array<Cached<std::tuple<GLenum, GLenum>>, kMaxColorAttachments> mBlendEquations;
+        std::array<Cached<BlendFunc>, kMaxColorAttachments> mBlendFuncs;
+        std::array<Cached<ColorMask>, kMaxColorAttachments> mColorMasks;
+        Cached<std::tuple<float, float, float, float>> mBlendColor;
+
+        Cached<bool> mDepthTestEnabled;
+        Cached<bool> mDepthMask;
+        Cached<GLenum> mDepthFunc;
+        Cached<bool> mStencilTestEnabled;
+        Cached<std::tuple<GLenum, GLenum, GLenum>> mStencilBackOp;
+        Cached<std::tuple<GLenum, GLenum, GLenum>> mStencilFrontOp;
+        Cached<GLuint> mStencilWriteMask;
+
+        Cached<Rect> mViewport;
+        Cached<Rect> mScissor;
+
+        uint64_t mIssuedCalls = 0;
+        uint64_t mSkippedCalls = 0;
     };
 
 }}  // namespace backend::opengl
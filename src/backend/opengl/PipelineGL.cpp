@@ -41,7 +41,9 @@ namespace backend { namespace opengl {
 
     }  // namespace
 
-    PipelineGL::PipelineGL(PipelineBase* parent, PipelineBuilder* builder) {
+    PipelineGL::PipelineGL(PipelineBase* parent,
+                           PipelineBuilder* builder,
+                           bool allowDrawBatching) {
         auto CreateShader = [](GLenum type, const char* source) -> GLuint {
             GLuint shader = glCreateShader(type);
             glShaderSource(shader, 1, &source, nullptr);
@@ -87,74 +89,77 @@ namespace backend { namespace opengl {
             }
         };
 
-        mProgram = glCreateProgram();
+        auto LinkProgram = [&](bool batched) -> GLuint {
+            GLuint program = glCreateProgram();
 
-        for (auto stage : IterateStages(parent->GetStageMask())) {
-            const ShaderModule* module = ToBackend(builder->GetStageInfo(stage).module.Get());
+            for (auto stage : IterateStages(parent->GetStageMask())) {
+                const ShaderModule* module = ToBackend(builder->GetStageInfo(stage).module.Get());
 
-            GLuint shader = CreateShader(GLShaderType(stage), module->GetSource());
-            glAttachShader(mProgram, shader);
-        }
+                const char* source = module->GetSource();
+                if (batched && stage == nxt::ShaderStage::Vertex) {
+                    source = module->GetBatchedSource();
+                }
+                GLuint shader = CreateShader(GLShaderType(stage), source);
+                glAttachShader(program, shader);
+            }
 
-        glLinkProgram(mProgram);
+            glLinkProgram(program);
 
-        GLint linkStatus = GL_FALSE;
-        glGetProgramiv(mProgram, GL_LINK_STATUS, &linkStatus);
-        if (linkStatus == GL_FALSE) {
-            GLint infoLogLength = 0;
-            glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, &infoLogLength);
+            GLint linkStatus = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+            if (linkStatus == GL_FALSE) {
+                GLint infoLogLength = 0;
+                glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
 
-            if (infoLogLength > 1) {
-                std::vector<char> buffer(infoLogLength);
-                glGetProgramInfoLog(mProgram, infoLogLength, nullptr, &buffer[0]);
-                std::cout << "Program link failed:\n";
-                std::cout << buffer.data() << std::endl;
-            }
-        }
+                if (infoLogLength > 1) {
+                    std::vector<char> buffer(infoLogLength);
+                    glGetProgramInfoLog(program, infoLogLength, nullptr, &buffer[0]);
+                    std::cout << "Program link failed:\n";
+                    std::cout << buffer.data() << std::endl;
+                }
 
-        for (auto stage : IterateStages(parent->GetStageMask())) {
-            const ShaderModule* module = ToBackend(builder->GetStageInfo(stage).module.Get());
-            FillPushConstants(module, &mGlPushConstants[stage], mProgram);
-        }
+                // Without the batched program draws are issued one by one, which is still correct.
+                if (batched) {
+                    glDeleteProgram(program);
+                    return 0;
+                }
+            }
 
-        glUseProgram(mProgram);
+            for (auto stage : IterateStages(parent->GetStageMask())) {
+                const ShaderModule* module = ToBackend(builder->GetStageInfo(stage).module.Get());
+                FillPushConstants(module, batched ? &mBatchedGlPushConstants[stage]
+                                                  : &mGlPushConstants[stage],
+                                  program);
+            }
 
-        // The uniforms are part of the program state so we can pre-bind buffer units, texture units
-        // etc.
-        const auto& layout = ToBackend(parent->GetLayout());
-        const auto& indices = layout->GetBindingIndexInfo();
+            return program;
+        };
 
-        for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
-            const auto& groupInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+        mProgram = LinkProgram(false);
 
-            for (uint32_t binding = 0; binding < kMaxBindingsPerGroup; ++binding) {
-                if (!groupInfo.mask[binding]) {
-                    continue;
-                }
+        if (allowDrawBatching && (parent->GetStageMask() & nxt::ShaderStageBit::Vertex)) {
+            const ShaderModule* vertexModule =
+                ToBackend(builder->GetStageInfo(nxt::ShaderStage::Vertex).module.Get());
+            if (vertexModule->GetBatchedSource() != nullptr) {
+                mBatchedProgram = LinkProgram(true);
+            }
+            if (mBatchedProgram != 0) {
+                mMaxBatchedDraws = vertexModule->GetMaxBatchedDraws();
 
-                std::string name = GetBindingName(group, binding);
-                switch (groupInfo.types[binding]) {
-                    case nxt::BindingType::UniformBuffer: {
-                        GLint location = glGetUniformBlockIndex(mProgram, name.c_str());
-                        glUniformBlockBinding(mProgram, location, indices[group][binding]);
-                    } break;
-
-                    case nxt::BindingType::StorageBuffer: {
-                        GLuint location = glGetProgramResourceIndex(
-                            mProgram, GL_SHADER_STORAGE_BLOCK, name.c_str());
-                        glShaderStorageBlockBinding(mProgram, location, indices[group][binding]);
-                    } break;
-
-                    case nxt::BindingType::Sampler:
-                    case nxt::BindingType::SampledTexture:
-                        // These binding types are handled in the separate sampler and texture
-                        // emulation
-                        break;
-                }
+                GLuint blockIndex =
+                    glGetUniformBlockIndex(mBatchedProgram, kBatchedPushConstantsBlock);
+                glUniformBlockBinding(mBatchedProgram, blockIndex, kBatchedPushConstantsBinding);
             }
         }
 
-        // Compute links between stages for combined samplers, then bind them to texture units
+        // The uniforms are part of the program state so we can pre-bind buffer units, texture units
+        // etc. This is done for both the program and its batched variant.
+        const auto& layout = ToBackend(parent->GetLayout());
+        const auto& indices = layout->GetBindingIndexInfo();
+
+        // Compute links between stages for combined samplers, the texture unit of each combined
+        // sampler is set in the programs below.
+        std::vector<std::pair<std::string, GLuint>> combinedSamplerUnits;
         {
             std::set<CombinedSampler> combinedSamplersSet;
             for (auto stage : IterateStages(parent->GetStageMask())) {
@@ -170,9 +175,7 @@ namespace backend { namespace opengl {
 
             GLuint textureUnit = layout->GetTextureUnitsUsed();
             for (const auto& combined : combinedSamplersSet) {
-                std::string name = combined.GetName();
-                GLint location = glGetUniformLocation(mProgram, name.c_str());
-                glUniform1i(location, textureUnit);
+                combinedSamplerUnits.emplace_back(combined.GetName(), textureUnit);
 
                 GLuint samplerIndex =
                     indices[combined.samplerLocation.group][combined.samplerLocation.binding];
@@ -185,6 +188,49 @@ namespace backend { namespace opengl {
                 textureUnit++;
             }
         }
+
+        for (GLuint program : {mBatchedProgram, mProgram}) {
+            if (program == 0) {
+                continue;
+            }
+            glUseProgram(program);
+
+            for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
+                const auto& groupInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+
+                for (uint32_t binding = 0; binding < kMaxBindingsPerGroup; ++binding) {
+                    if (!groupInfo.mask[binding]) {
+                        continue;
+                    }
+
+                    std::string name = GetBindingName(group, binding);
+                    switch (groupInfo.types[binding]) {
+                        case nxt::BindingType::UniformBuffer: {
+                            GLint location = glGetUniformBlockIndex(program, name.c_str());
+                            glUniformBlockBinding(program, location, indices[group][binding]);
+                        } break;
+
+                        case nxt::BindingType::StorageBuffer: {
+                            GLuint location = glGetProgramResourceIndex(
+                                program, GL_SHADER_STORAGE_BLOCK, name.c_str());
+                            glShaderStorageBlockBinding(program, location,
+                                                        indices[group][binding]);
+                        } break;
+
+                        case nxt::BindingType::Sampler:
+                        case nxt::BindingType::SampledTexture:
+                            // These binding types are handled in the separate sampler and texture
+                            // emulation
+                            break;
+                    }
+                }
+            }
+
+            for (const auto& nameAndUnit : combinedSamplerUnits) {
+                GLint location = glGetUniformLocation(program, nameAndUnit.first.c_str());
+                glUniform1i(location, nameAndUnit.second);
+            }
+        }
     }
 
     const PipelineGL::GLPushConstantInfo& PipelineGL::GetGLPushConstants(
@@ -206,8 +252,21 @@ namespace backend { namespace opengl {
         return mProgram;
     }
 
-    void PipelineGL::ApplyNow() {
-        glUseProgram(mProgram);
+    GLuint PipelineGL::GetBatchedProgramHandle() const {
+        return mBatchedProgram;
+    }
+
+    const PipelineGL::GLPushConstantInfo& PipelineGL::GetBatchedGLPushConstants(
+        nxt::ShaderStage stage) const {
+        return mBatchedGlPushConstants[stage];
+    }
+
+    uint32_t PipelineGL::GetMaxBatchedDraws() const {
+        return mMaxBatchedDraws;
+    }
+
+    void PipelineGL::ApplyNow(PersistentPipelineState& persistentPipelineState) {
+        persistentPipelineState.UseProgram(mProgram);
     }
 
 }}  // namespace backend::opengl
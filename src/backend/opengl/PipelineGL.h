@@ -29,7 +29,9 @@ namespace backend { namespace opengl {
 
     class PipelineGL {
       public:
-        PipelineGL(PipelineBase* parent, PipelineBuilder* builder);
+        // When allowDrawBatching is true and the vertex shader has a batched variant, a second
+        // program using it is created for the draws that command buffers batch.
+        PipelineGL(PipelineBase* parent, PipelineBuilder* builder, bool allowDrawBatching = false);
 
         using GLPushConstantInfo = std::array<GLint, kMaxPushConstants>;
         using BindingLocations =
@@ -40,11 +42,19 @@ namespace backend { namespace opengl {
         const std::vector<GLuint>& GetTextureUnitsForTexture(GLuint index) const;
         GLuint GetProgramHandle() const;
 
-        void ApplyNow();
+        // The batched program is 0 if the draws using this pipeline can't be batched.
+        GLuint GetBatchedProgramHandle() const;
+        const GLPushConstantInfo& GetBatchedGLPushConstants(nxt::ShaderStage stage) const;
+        uint32_t GetMaxBatchedDraws() const;
+
+        void ApplyNow(PersistentPipelineState& persistentPipelineState);
 
       private:
         GLuint mProgram;
         PerStage<GLPushConstantInfo> mGlPushConstants;
+        GLuint mBatchedProgram = 0;
+        PerStage<GLPushConstantInfo> mBatchedGlPushConstants;
+        uint32_t mMaxBatchedDraws = 0;
         std::vector<std::vector<GLuint>> mUnitsForSamplers;
         std::vector<std::vector<GLuint>> mUnitsForTextures;
     };
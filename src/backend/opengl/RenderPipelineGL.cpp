@@ -16,9 +16,10 @@
 
 #include "backend/opengl/BlendStateGL.h"
 #include "backend/opengl/DepthStencilStateGL.h"
-#include "backend/opengl/InputStateGL.h"
 #include "backend/opengl/OpenGLBackend.h"
 #include "backend/opengl/PersistentPipelineStateGL.h"
+#include "backend/opengl/ShaderModuleGL.h"
+#include "common/BitSetIterator.h"
 
 namespace backend { namespace opengl {
 
@@ -39,11 +40,27 @@ namespace backend { namespace opengl {
                     UNREACHABLE();
             }
         }
+
+        // Batched draws use their baseInstance to index the per-instance draw index attribute, so
+        // the input state can't have attributes that are fetched per instance. Inputs with a stride
+        // of zero are also fetched per instance, see InputState::CreateVAO.
+        bool InputStateAllowsDrawBatching(const InputStateBase* inputState) {
+            if (inputState->GetAttributesSetMask()[kDrawIndexAttribute]) {
+                return false;
+            }
+            for (uint32_t slot : IterateBitSet(inputState->GetInputsSetMask())) {
+                const auto& input = inputState->GetInput(slot);
+                if (input.stride == 0 || input.stepMode != nxt::InputStepMode::Vertex) {
+                    return false;
+                }
+            }
+            return true;
+        }
     }  // namespace
 
     RenderPipeline::RenderPipeline(RenderPipelineBuilder* builder)
         : RenderPipelineBase(builder),
-          PipelineGL(this, builder),
+          PipelineGL(this, builder, InputStateAllowsDrawBatching(GetInputState())),
           mGlPrimitiveTopology(GLPrimitiveTopology(GetPrimitiveTopology())) {
     }
 
@@ -52,16 +69,14 @@ namespace backend { namespace opengl {
     }
 
     void RenderPipeline::ApplyNow(PersistentPipelineState& persistentPipelineState) {
-        PipelineGL::ApplyNow();
-
-        auto inputState = ToBackend(GetInputState());
-        glBindVertexArray(inputState->GetVAO());
+        PipelineGL::ApplyNow(persistentPipelineState);
 
         auto depthStencilState = ToBackend(GetDepthStencilState());
         depthStencilState->ApplyNow(persistentPipelineState);
 
         for (uint32_t attachmentSlot : IterateBitSet(GetColorAttachmentsMask())) {
-            ToBackend(GetBlendState(attachmentSlot))->ApplyNow(attachmentSlot);
+            ToBackend(GetBlendState(attachmentSlot))
+                ->ApplyNow(persistentPipelineState, attachmentSlot);
         }
     }
 
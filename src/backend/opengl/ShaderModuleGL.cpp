@@ -15,6 +15,8 @@
 #include "backend/opengl/ShaderModuleGL.h"
 
 #include "common/Assert.h"
+#include "common/BitSetIterator.h"
+#include "common/Math.h"
 #include "common/Platform.h"
 
 #include <spirv-cross/spirv_glsl.hpp>
@@ -29,6 +31,10 @@ namespace backend { namespace opengl {
         return o.str();
     }
 
+    uint32_t GetBatchedPushConstantsStride(uint32_t count) {
+        return Align(count, 4);
+    }
+
     bool operator<(const BindingLocation& a, const BindingLocation& b) {
         return std::tie(a.group, a.binding) < std::tie(b.group, b.binding);
     }
@@ -61,6 +67,7 @@ namespace backend { namespace opengl {
         // Rename the push constant block to be prefixed with the shader stage type so that uniform
         // names don't match between the FS and the VS.
         const auto& resources = compiler.get_shader_resources();
+        std::string pushConstantsName;
         if (resources.push_constant_buffers.size() > 0) {
             const char* prefix = nullptr;
             switch (compiler.get_execution_model()) {
@@ -77,7 +84,8 @@ namespace backend { namespace opengl {
                     UNREACHABLE();
             }
             auto interfaceBlock = resources.push_constant_buffers[0];
-            compiler.set_name(interfaceBlock.id, prefix + interfaceBlock.name);
+            pushConstantsName = prefix + interfaceBlock.name;
+            compiler.set_name(interfaceBlock.id, pushConstantsName);
         }
 
         ExtractSpirvInfo(compiler);
@@ -119,6 +127,60 @@ namespace backend { namespace opengl {
         }
 
         mGlslSource = compiler.compile();
+
+#if !defined(NXT_PLATFORM_APPLE)
+        // glMultiDraw*Indirect needs OpenGL 4.3, which isn't available on OSX.
+        if (GetExecutionModel() == nxt::ShaderStage::Vertex && !pushConstantsName.empty()) {
+            CreateBatchedSource(pushConstantsName);
+        }
+#endif
+    }
+
+    void ShaderModule::CreateBatchedSource(const std::string& pushConstantsName) {
+        // The push constants become a std140 struct in the uniform buffer, which only matches the
+        // packing done by command buffers if they are scalars starting at offset 0.
+        const auto& pushConstants = GetPushConstants();
+        uint32_t count = 0;
+        for (uint32_t constant : IterateBitSet(pushConstants.mask)) {
+            if (constant != count || pushConstants.sizes[constant] != 1) {
+                return;
+            }
+            count++;
+        }
+        if (count == 0 || GetUsedVertexAttributes()[kDrawIndexAttribute]) {
+            return;
+        }
+
+        // SPIRV-Cross declares the push constants as a uniform of a struct type. Replace that
+        // declaration with the uniform buffer and a define indexing it with the draw index so that
+        // the rest of the shader is unchanged.
+        const std::string declarationEnd = " " + pushConstantsName + ";\n";
+        const std::string uniform = "uniform ";
+        size_t end = mGlslSource.find(declarationEnd);
+        if (end == std::string::npos) {
+            return;
+        }
+        size_t start = mGlslSource.rfind('\n', end);
+        start = start == std::string::npos ? 0 : start + 1;
+        if (mGlslSource.compare(start, uniform.size(), uniform) != 0) {
+            return;
+        }
+        std::string typeName =
+            mGlslSource.substr(start + uniform.size(), end - start - uniform.size());
+
+        mMaxBatchedDraws = kMaxBatchedPushConstantsSize /
+                           (GetBatchedPushConstantsStride(count) * sizeof(uint32_t));
+        ASSERT(mMaxBatchedDraws <= kMaxBatchedDraws);
+
+        std::ostringstream o;
+        o << mGlslSource.substr(0, start);
+        o << "layout(std140) uniform " << kBatchedPushConstantsBlock << " {\n";
+        o << "    " << typeName << " nxt_batched_values[" << mMaxBatchedDraws << "];\n";
+        o << "};\n";
+        o << "layout(location = " << kDrawIndexAttribute << ") in float nxt_draw_index;\n";
+        o << "#define " << pushConstantsName << " nxt_batched_values[int(nxt_draw_index)]\n";
+        o << mGlslSource.substr(end + declarationEnd.size());
+        mBatchedGlslSource = o.str();
     }
 
     const char* ShaderModule::GetSource() const {
@@ -129,4 +191,15 @@ namespace backend { namespace opengl {
         return mCombinedInfo;
     }
 
+    const char* ShaderModule::GetBatchedSource() const {
+        if (mBatchedGlslSource.empty()) {
+            return nullptr;
+        }
+        return mBatchedGlslSource.data();
+    }
+
+    uint32_t ShaderModule::GetMaxBatchedDraws() const {
+        return mMaxBatchedDraws;
+    }
+
 }}  // namespace backend::opengl
@@ -25,6 +25,22 @@ namespace backend { namespace opengl {
 
     std::string GetBindingName(uint32_t group, uint32_t binding);
 
+    // Consecutive draws that only differ by their vertex push constants are batched by command
+    // buffers in glMultiDraw*Indirect calls. The vertex shader is then replaced by a variant that
+    // reads the push constants of each draw from an array in a uniform buffer, indexed by a
+    // per-instance attribute that holds the draw index.
+    static constexpr const char* kBatchedPushConstantsBlock = "nxt_batched_push_constants";
+    // The uniform buffer binding comes after the ones of the bind groups.
+    static constexpr GLuint kBatchedPushConstantsBinding = kMaxBindGroups * kMaxBindingsPerGroup;
+    static constexpr GLuint kDrawIndexAttribute = kMaxVertexAttributes - 1;
+    // GL_MAX_UNIFORM_BLOCK_SIZE is at least 16KB, and each draw uses at least 16 bytes.
+    static constexpr uint32_t kMaxBatchedPushConstantsSize = 16384;
+    static constexpr uint32_t kMaxBatchedDraws = kMaxBatchedPushConstantsSize / 16;
+
+    // Number of uint32_t between the push constants of two draws in the uniform buffer, using the
+    // std140 array stride of the struct of count scalars.
+    uint32_t GetBatchedPushConstantsStride(uint32_t count);
+
     struct BindingLocation {
         uint32_t group;
         uint32_t binding;
@@ -47,9 +63,17 @@ namespace backend { namespace opengl {
         const char* GetSource() const;
         const CombinedSamplerInfo& GetCombinedSamplerInfo() const;
 
+        // The batched variant of a vertex shader, nullptr if its draws can't be batched.
+        const char* GetBatchedSource() const;
+        uint32_t GetMaxBatchedDraws() const;
+
       private:
+        void CreateBatchedSource(const std::string& pushConstantsName);
+
         CombinedSamplerInfo mCombinedInfo;
         std::string mGlslSource;
+        std::string mBatchedGlslSource;
+        uint32_t mMaxBatchedDraws = 0;
     };
 
 }}  // namespace backend::opengl
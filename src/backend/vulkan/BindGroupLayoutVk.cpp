@@ -14,6 +14,7 @@
 
 #include "backend/vulkan/BindGroupLayoutVk.h"
 
+#include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/VulkanBackend.h"
 #include "common/BitSetIterator.h"
 
@@ -89,6 +90,12 @@ namespace backend { namespace vulkan {
     }
 
     BindGroupLayout::~BindGroupLayout() {
+        // Descriptor sets are freed implicitly when their pool is destroyed.
+        for (VkDescriptorPool pool : mPools) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(pool);
+        }
+        mPools.clear();
+
         // DescriptorSetLayout aren't used by execution on the GPU and can be deleted at any time,
         // so we destroy mHandle immediately instead of using the FencedDeleter
         if (mHandle != VK_NULL_HANDLE) {
@@ -151,4 +158,75 @@ namespace backend { namespace vulkan {
         *numPoolSizes = numSizes;
         return result;
     }
+
+    VkDescriptorSet BindGroupLayout::AllocateDescriptorSet() {
+        Device* device = ToBackend(GetDevice());
+
+        Serial completedSerial = device->GetCompletedSerial();
+        for (VkDescriptorSet set : mFreedSets.IterateUpTo(completedSerial)) {
+            mAvailableSets.push_back(set);
+        }
+        mFreedSets.ClearUpTo(completedSerial);
+
+        if (!mAvailableSets.empty()) {
+            VkDescriptorSet set = mAvailableSets.back();
+            mAvailableSets.pop_back();
+            return set;
+        }
+
+        if (mSetsLeftInCurrentPool == 0 && !AllocateDescriptorPool()) {
+            ASSERT(false);
+            return VK_NULL_HANDLE;
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorPool = mPools.back();
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &mHandle;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        if (device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo, &set) !=
+            VK_SUCCESS) {
+            ASSERT(false);
+        }
+        mSetsLeftInCurrentPool--;
+
+        return set;
+    }
+
+    void BindGroupLayout::FreeDescriptorSet(VkDescriptorSet set) {
+        // The set might still be used by commands in flight, it is rewritten only after they are
+        // finished.
+        mFreedSets.Enqueue(set, ToBackend(GetDevice())->GetSerial());
+    }
+
+    bool BindGroupLayout::AllocateDescriptorPool() {
+        uint32_t numPoolSizes = 0;
+        auto poolSizes = ComputePoolSizes(&numPoolSizes);
+        for (uint32_t i = 0; i < numPoolSizes; ++i) {
+            poolSizes[i].descriptorCount *= kMaxSetsPerPool;
+        }
+
+        VkDescriptorPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.maxSets = kMaxSetsPerPool;
+        createInfo.poolSizeCount = numPoolSizes;
+        createInfo.pPoolSizes = poolSizes.data();
+
+        Device* device = ToBackend(GetDevice());
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (device->fn.CreateDescriptorPool(device->GetVkDevice(), &createInfo, nullptr, &pool) !=
+            VK_SUCCESS) {
+            return false;
+        }
+
+        mPools.push_back(pool);
+        mSetsLeftInCurrentPool = kMaxSetsPerPool;
+        return true;
+    }
+
 }}  // namespace backend::vulkan
@@ -17,8 +17,11 @@
 
 #include "backend/BindGroupLayout.h"
 
+#include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 
+#include <vector>
+
 namespace backend { namespace vulkan {
 
     class Device;
@@ -36,8 +39,22 @@ namespace backend { namespace vulkan {
         using PoolSizeSpec = std::array<VkDescriptorPoolSize, kMaxPoolSizesNeeded>;
         PoolSizeSpec ComputePoolSizes(uint32_t* numPoolSizes) const;
 
+        // Descriptor sets of this layout are allocated from pools of kMaxSetsPerPool sets. Freed
+        // sets are reused once the GPU is done with them.
+        VkDescriptorSet AllocateDescriptorSet();
+        void FreeDescriptorSet(VkDescriptorSet set);
+
       private:
+        bool AllocateDescriptorPool();
+
+        static constexpr uint32_t kMaxSetsPerPool = 64;
+
         VkDescriptorSetLayout mHandle = VK_NULL_HANDLE;
+
+        std::vector<VkDescriptorPool> mPools;
+        uint32_t mSetsLeftInCurrentPool = 0;
+        std::vector<VkDescriptorSet> mAvailableSets;
+        SerialQueue<VkDescriptorSet> mFreedSets;
     };
 
 }}  // namespace backend::vulkan
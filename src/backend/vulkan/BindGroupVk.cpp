@@ -16,7 +16,6 @@
 
 #include "backend/vulkan/BindGroupLayoutVk.h"
 #include "backend/vulkan/BufferVk.h"
-#include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/SamplerVk.h"
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
@@ -26,40 +25,7 @@
 namespace backend { namespace vulkan {
 
     BindGroup::BindGroup(BindGroupBuilder* builder) : BindGroupBase(builder) {
-        // Create a pool to hold our descriptor set.
-        // TODO(cwallez@chromium.org): This horribly inefficient, find a way to be better, for
-        // example by having one pool per bind group layout instead.
-        uint32_t numPoolSizes = 0;
-        auto poolSizes = ToBackend(GetLayout())->ComputePoolSizes(&numPoolSizes);
-
-        VkDescriptorPoolCreateInfo createInfo;
-        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        createInfo.pNext = nullptr;
-        createInfo.flags = 0;
-        createInfo.maxSets = 1;
-        createInfo.poolSizeCount = numPoolSizes;
-        createInfo.pPoolSizes = poolSizes.data();
-
-        Device* device = ToBackend(GetDevice());
-        if (device->fn.CreateDescriptorPool(device->GetVkDevice(), &createInfo, nullptr, &mPool) !=
-            VK_SUCCESS) {
-            ASSERT(false);
-        }
-
-        // Now do the allocation of one descriptor set, this is very suboptimal too.
-        VkDescriptorSetLayout vkLayout = ToBackend(GetLayout())->GetHandle();
-
-        VkDescriptorSetAllocateInfo allocateInfo;
-        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocateInfo.pNext = nullptr;
-        allocateInfo.descriptorPool = mPool;
-        allocateInfo.descriptorSetCount = 1;
-        allocateInfo.pSetLayouts = &vkLayout;
-
-        if (device->fn.AllocateDescriptorSets(device->GetVkDevice(), &allocateInfo, &mHandle) !=
-            VK_SUCCESS) {
-            ASSERT(false);
-        }
+        mHandle = ToBackend(GetLayout())->AllocateDescriptorSet();
 
         // Now do a write of a single descriptor set with all possible chained data allocated on the
         // stack.
@@ -116,18 +82,15 @@ namespace backend { namespace vulkan {
             numWrites++;
         }
 
+        Device* device = ToBackend(GetDevice());
         device->fn.UpdateDescriptorSets(device->GetVkDevice(), numWrites, writes.data(), 0,
                                         nullptr);
     }
 
     BindGroup::~BindGroup() {
-        // The descriptor set doesn't need to be delete because it's done implicitly when the
-        // descriptor pool is destroyed.
-        mHandle = VK_NULL_HANDLE;
-
-        if (mPool != VK_NULL_HANDLE) {
-            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mPool);
-            mPool = VK_NULL_HANDLE;
+        if (mHandle != VK_NULL_HANDLE) {
+            ToBackend(GetLayout())->FreeDescriptorSet(mHandle);
+            mHandle = VK_NULL_HANDLE;
         }
     }
 
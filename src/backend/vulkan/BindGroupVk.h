@@ -31,7 +31,6 @@ namespace backend { namespace vulkan {
         VkDescriptorSet GetHandle() const;
 
       private:
-        VkDescriptorPool mPool = VK_NULL_HANDLE;
         VkDescriptorSet mHandle = VK_NULL_HANDLE;
     };
 
@@ -26,15 +26,128 @@ namespace backend { namespace vulkan {
     }
 
     BufferUploader::~BufferUploader() {
+        if (mRingBuffer != VK_NULL_HANDLE) {
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(mRingBuffer);
+            mDevice->GetMemoryAllocator()->Free(&mRingAllocation);
+            mRingBuffer = VK_NULL_HANDLE;
+        }
     }
 
     void BufferUploader::BufferSubData(VkBuffer buffer,
                                        VkDeviceSize offset,
                                        VkDeviceSize size,
                                        const void* data) {
-        // TODO(cwallez@chromium.org): this is soooooo bad. We should use some sort of ring buffer
-        // for this.
+        mDevice->AddPendingUpload(size);
+
+        VkDeviceSize ringOffset = 0;
+        if (!EnsureRing() || !AllocateInRing(size, &ringOffset)) {
+            BufferSubDataWithDedicatedStaging(buffer, offset, size, data);
+            return;
+        }
+
+        ASSERT(mRingAllocation.GetMappedPointer() != nullptr);
+        memcpy(mRingAllocation.GetMappedPointer() + ringOffset, data, static_cast<size_t>(size));
+
+        VkCommandBuffer commands = mDevice->GetPendingCommandBuffer();
+        RecordHostWriteBarrier(commands);
+
+        VkBufferCopy copy;
+        copy.srcOffset = ringOffset;
+        copy.dstOffset = offset;
+        copy.size = size;
+        mDevice->fn.CmdCopyBuffer(commands, mRingBuffer, buffer, 1, &copy);
+    }
+
+    void BufferUploader::Tick(Serial completedSerial) {
+        for (uint64_t allocatedBytes : mInFlightAllocatedBytes.IterateUpTo(completedSerial)) {
+            mRetiredBytes = allocatedBytes;
+        }
+        mInFlightAllocatedBytes.ClearUpTo(completedSerial);
+    }
+
+    bool BufferUploader::EnsureRing() {
+        if (mRingBuffer != VK_NULL_HANDLE) {
+            return true;
+        }
+
+        VkBufferCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.size = kRingSize;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.queueFamilyIndexCount = 0;
+        createInfo.pQueueFamilyIndices = 0;
+
+        if (mDevice->fn.CreateBuffer(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                     &mRingBuffer) != VK_SUCCESS) {
+            mRingBuffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkMemoryRequirements requirements;
+        mDevice->fn.GetBufferMemoryRequirements(mDevice->GetVkDevice(), mRingBuffer,
+                                                &requirements);
+
+        if (!mDevice->GetMemoryAllocator()->Allocate(requirements, true, &mRingAllocation) ||
+            mDevice->fn.BindBufferMemory(mDevice->GetVkDevice(), mRingBuffer,
+                                         mRingAllocation.GetMemory(),
+                                         mRingAllocation.GetMemoryOffset()) != VK_SUCCESS) {
+            ASSERT(false);
+            return false;
+        }
+
+        return true;
+    }
 
+    bool BufferUploader::AllocateInRing(VkDeviceSize size, VkDeviceSize* offset) {
+        if (size == 0 || size > kRingSize) {
+            return false;
+        }
+
+        VkDeviceSize head = mAllocatedBytes % kRingSize;
+        VkDeviceSize padding = 0;
+        if (head + size > kRingSize) {
+            // Skip the end of the ring so that the copy source is contiguous.
+            padding = kRingSize - head;
+        }
+
+        uint64_t usedBytes = mAllocatedBytes - mRetiredBytes;
+        if (usedBytes + padding + size > kRingSize) {
+            return false;
+        }
+
+        *offset = (head + padding) % kRingSize;
+        mAllocatedBytes += padding + size;
+        mInFlightAllocatedBytes.Enqueue(mAllocatedBytes, mDevice->GetSerial());
+        return true;
+    }
+
+    void BufferUploader::RecordHostWriteBarrier(VkCommandBuffer commands) {
+        // All the writes to the ring done before the submit are made visible by this single
+        // barrier, there is no need to have one per upload.
+        Serial serial = mDevice->GetSerial();
+        if (serial == mLastBarrierSerial) {
+            return;
+        }
+        mLastBarrierSerial = serial;
+
+        VkMemoryBarrier barrier;
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        mDevice->fn.CmdPipelineBarrier(commands, VK_PIPELINE_STAGE_HOST_BIT,
+                                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr,
+                                       0, nullptr);
+    }
+
+    void BufferUploader::BufferSubDataWithDedicatedStaging(VkBuffer buffer,
+                                                           VkDeviceSize offset,
+                                                           VkDeviceSize size,
+                                                           const void* data) {
         // Create a staging buffer
         VkBufferCreateInfo createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -73,16 +186,7 @@ namespace backend { namespace vulkan {
 
         // Enqueue host write -> transfer src barrier and copy command
         VkCommandBuffer commands = mDevice->GetPendingCommandBuffer();
-
-        VkMemoryBarrier barrier;
-        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-        barrier.pNext = nullptr;
-        barrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-        mDevice->fn.CmdPipelineBarrier(commands, VK_PIPELINE_STAGE_HOST_BIT,
-                                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr,
-                                       0, nullptr);
+        RecordHostWriteBarrier(commands);
 
         VkBufferCopy copy;
         copy.srcOffset = 0;
@@ -90,13 +194,10 @@ namespace backend { namespace vulkan {
         copy.size = size;
         mDevice->fn.CmdCopyBuffer(commands, stagingBuffer, buffer, 1, &copy);
 
-        // TODO(cwallez@chromium.org): Buffers must be deleted before the memory.
-        // This happens to work for now, but is fragile.
-        mDevice->GetMemoryAllocator()->Free(&allocation);
+        // Buffers must be deleted before the memory bound to them, the device makes sure of it by
+        // ticking the deleter before the memory allocator.
         mDevice->GetFencedDeleter()->DeleteWhenUnused(stagingBuffer);
-    }
-
-    void BufferUploader::Tick(Serial) {
+        mDevice->GetMemoryAllocator()->Free(&allocation);
     }
 
 }}  // namespace backend::vulkan
@@ -15,6 +15,7 @@
 #ifndef BACKEND_VULKAN_BUFFERUPLOADER_H_
 #define BACKEND_VULKAN_BUFFERUPLOADER_H_
 
+#include "backend/vulkan/MemoryAllocator.h"
 #include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 
@@ -22,6 +23,9 @@ namespace backend { namespace vulkan {
 
     class Device;
 
+    // Uploads data to buffers by copying it to a persistently mapped staging ring and recording a
+    // copy to the destination in the pending command buffer. Parts of the ring are reused once the
+    // serial of the commands reading from them is completed.
     class BufferUploader {
       public:
         BufferUploader(Device* device);
@@ -35,7 +39,30 @@ namespace backend { namespace vulkan {
         void Tick(Serial completedSerial);
 
       private:
+        bool EnsureRing();
+        bool AllocateInRing(VkDeviceSize size, VkDeviceSize* offset);
+        void RecordHostWriteBarrier(VkCommandBuffer commands);
+
+        // Used for uploads that don't fit in the ring.
+        void BufferSubDataWithDedicatedStaging(VkBuffer buffer,
+                                               VkDeviceSize offset,
+                                               VkDeviceSize size,
+                                               const void* data);
+
+        static constexpr VkDeviceSize kRingSize = 4 * 1024 * 1024;
+
         Device* mDevice = nullptr;
+
+        VkBuffer mRingBuffer = VK_NULL_HANDLE;
+        DeviceMemoryAllocation mRingAllocation;
+
+        // Ring allocation is tracked with monotonic byte counts: the bytes still in use by the GPU
+        // are mAllocatedBytes - mRetiredBytes and the head is mAllocatedBytes % kRingSize.
+        uint64_t mAllocatedBytes = 0;
+        uint64_t mRetiredBytes = 0;
+        SerialQueue<uint64_t> mInFlightAllocatedBytes;
+
+        Serial mLastBarrierSerial = 0;
     };
 
 }}  // namespace backend::vulkan
@@ -162,22 +162,49 @@ namespace backend { namespace vulkan {
         return mHandle;
     }
 
+    bool Buffer::ComputeBarrier(nxt::BufferUsageBit currentUsage,
+                                nxt::BufferUsageBit targetUsage,
+                                VkPipelineStageFlags* srcStages,
+                                VkPipelineStageFlags* dstStages,
+                                VkBufferMemoryBarrier* barrier) const {
+        // Reads don't need to be synchronized with each other.
+        nxt::BufferUsageBit writableUsages = nxt::BufferUsageBit::MapWrite |
+                                             nxt::BufferUsageBit::TransferDst |
+                                             nxt::BufferUsageBit::Storage;
+        if (!((currentUsage | targetUsage) & writableUsages)) {
+            return false;
+        }
+
+        *srcStages |= VulkanPipelineStage(currentUsage);
+        *dstStages |= VulkanPipelineStage(targetUsage);
+
+        barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier->pNext = nullptr;
+        barrier->srcAccessMask = VulkanAccessFlags(currentUsage);
+        barrier->dstAccessMask = VulkanAccessFlags(targetUsage);
+        barrier->srcQueueFamilyIndex = 0;
+        barrier->dstQueueFamilyIndex = 0;
+        barrier->buffer = mHandle;
+        barrier->offset = 0;
+        barrier->size = GetSize();
+
+        return true;
+    }
+
     void Buffer::RecordBarrier(VkCommandBuffer commands,
                                nxt::BufferUsageBit currentUsage,
                                nxt::BufferUsageBit targetUsage) const {
-        VkPipelineStageFlags srcStages = VulkanPipelineStage(currentUsage);
-        VkPipelineStageFlags dstStages = VulkanPipelineStage(targetUsage);
-
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
         VkBufferMemoryBarrier barrier;
-        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-        barrier.pNext = nullptr;
-        barrier.srcAccessMask = VulkanAccessFlags(currentUsage);
-        barrier.dstAccessMask = VulkanAccessFlags(targetUsage);
-        barrier.srcQueueFamilyIndex = 0;
-        barrier.dstQueueFamilyIndex = 0;
-        barrier.buffer = mHandle;
-        barrier.offset = 0;
-        barrier.size = GetSize();
+        if (!ComputeBarrier(currentUsage, targetUsage, &srcStages, &dstStages, &barrier)) {
+            return;
+        }
+
+        // The buffer wasn't used before so there is nothing to wait on.
+        if (srcStages == 0) {
+            srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
 
         ToBackend(GetDevice())
             ->fn.CmdPipelineBarrier(commands, srcStages, dstStages, 0, 0, nullptr, 1, &barrier, 0,
@@ -230,6 +257,8 @@ namespace backend { namespace vulkan {
         request.isWrite = isWrite;
 
         mInflightRequests.Enqueue(std::move(request), mDevice->GetSerial());
+        // The request completes only once the pending commands are submitted.
+        mDevice->RequestSubmit();
     }
 
     void MapRequestTracker::Tick(Serial finishedSerial) {
@@ -35,6 +35,14 @@ namespace backend { namespace vulkan {
 
         VkBuffer GetHandle() const;
 
+        // Computes the barrier transitioning the buffer from currentUsage to targetUsage and adds
+        // the stages it synchronizes to srcStages and dstStages. Returns false if no barrier is
+        // needed, for example between two read-only usages.
+        bool ComputeBarrier(nxt::BufferUsageBit currentUsage,
+                            nxt::BufferUsageBit targetUsage,
+                            VkPipelineStageFlags* srcStages,
+                            VkPipelineStageFlags* dstStages,
+                            VkBufferMemoryBarrier* barrier) const;
         void RecordBarrier(VkCommandBuffer commands,
                            nxt::BufferUsageBit currentUsage,
                            nxt::BufferUsageBit targetUsage) const;
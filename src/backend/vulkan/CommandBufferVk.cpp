@@ -24,6 +24,8 @@
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
 
+#include <vector>
+
 namespace backend { namespace vulkan {
 
     namespace {
@@ -115,6 +117,93 @@ namespace backend { namespace vulkan {
             std::bitset<kMaxBindGroups> mDirtySets;
         };
 
+        // Accumulates the usage transitions recorded between two commands doing GPU work so that
+        // they are all done with a single vkCmdPipelineBarrier. Successive transitions of the same
+        // resource are merged into a single transition from its first to its last usage.
+        class PipelineBarrierBatch {
+          public:
+            void TransitionBuffer(Buffer* buffer,
+                                  nxt::BufferUsageBit currentUsage,
+                                  nxt::BufferUsageBit targetUsage) {
+                for (auto& transition : mBufferTransitions) {
+                    if (transition.resource == buffer) {
+                        transition.targetUsage = targetUsage;
+                        return;
+                    }
+                }
+                mBufferTransitions.push_back({buffer, currentUsage, targetUsage});
+            }
+
+            void TransitionTexture(Texture* texture,
+                                   nxt::TextureUsageBit currentUsage,
+                                   nxt::TextureUsageBit targetUsage) {
+                for (auto& transition : mTextureTransitions) {
+                    if (transition.resource == texture) {
+                        transition.targetUsage = targetUsage;
+                        return;
+                    }
+                }
+                mTextureTransitions.push_back({texture, currentUsage, targetUsage});
+            }
+
+            // Records the barrier for all the pending transitions, returns whether a barrier was
+            // needed.
+            bool Flush(Device* device, VkCommandBuffer commands) {
+                VkPipelineStageFlags srcStages = 0;
+                VkPipelineStageFlags dstStages = 0;
+
+                for (const auto& transition : mBufferTransitions) {
+                    VkBufferMemoryBarrier barrier;
+                    if (transition.resource->ComputeBarrier(transition.currentUsage,
+                                                            transition.targetUsage, &srcStages,
+                                                            &dstStages, &barrier)) {
+                        mBufferBarriers.push_back(barrier);
+                    }
+                }
+                for (const auto& transition : mTextureTransitions) {
+                    VkImageMemoryBarrier barrier;
+                    if (transition.resource->ComputeBarrier(transition.currentUsage,
+                                                            transition.targetUsage, &srcStages,
+                                                            &dstStages, &barrier)) {
+                        mImageBarriers.push_back(barrier);
+                    }
+                }
+                mBufferTransitions.clear();
+                mTextureTransitions.clear();
+
+                if (mBufferBarriers.empty() && mImageBarriers.empty()) {
+                    return false;
+                }
+
+                // Buffers that weren't used before don't have anything to wait on.
+                if (srcStages == 0) {
+                    srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+                }
+
+                device->fn.CmdPipelineBarrier(
+                    commands, srcStages, dstStages, 0, 0, nullptr,
+                    static_cast<uint32_t>(mBufferBarriers.size()), mBufferBarriers.data(),
+                    static_cast<uint32_t>(mImageBarriers.size()), mImageBarriers.data());
+
+                mBufferBarriers.clear();
+                mImageBarriers.clear();
+                return true;
+            }
+
+          private:
+            template <typename Resource, typename Usage>
+            struct Transition {
+                Resource* resource;
+                Usage currentUsage;
+                Usage targetUsage;
+            };
+
+            std::vector<Transition<Buffer, nxt::BufferUsageBit>> mBufferTransitions;
+            std::vector<Transition<Texture, nxt::TextureUsageBit>> mTextureTransitions;
+            std::vector<VkBufferMemoryBarrier> mBufferBarriers;
+            std::vector<VkImageMemoryBarrier> mImageBarriers;
+        };
+
     }  // anonymous namespace
 
     CommandBuffer::CommandBuffer(CommandBufferBuilder* builder)
@@ -125,12 +214,106 @@ namespace backend { namespace vulkan {
         FreeCommands(&mCommands);
     }
 
+    void CommandBuffer::PrepareRecording() {
+        mBufferTransitions.clear();
+        mTextureTransitions.clear();
+        mRenderPasses.clear();
+
+        Command type;
+        while (mCommands.NextCommandId(&type)) {
+            switch (type) {
+                case Command::BeginRenderPass: {
+                    BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
+                    RenderPassDescriptor* info = ToBackend(cmd->info.Get());
+
+                    // NXT has an implicit transition to color attachment on render passes.
+                    PreparedRenderPass renderPass;
+                    renderPass.attachmentTransitionCount = 0;
+                    for (uint32_t i : IterateBitSet(info->GetColorAttachmentMask())) {
+                        PrepareAttachmentTransition(
+                            ToBackend(info->GetColorAttachment(i).view->GetTexture()),
+                            &renderPass);
+                    }
+                    if (info->HasDepthStencilAttachment()) {
+                        PrepareAttachmentTransition(
+                            ToBackend(info->GetDepthStencilAttachment().view->GetTexture()),
+                            &renderPass);
+                    }
+
+                    renderPass.cachedObjects = info->QueryCachedObjects();
+                    mRenderPasses.push_back(renderPass);
+                } break;
+
+                // Getting the handles waits for the pipeline compilations so that the handles
+                // can then be read concurrently.
+                case Command::SetComputePipeline: {
+                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
+                    ToBackend(cmd->pipeline)->GetHandle();
+                } break;
+
+                case Command::SetRenderPipeline: {
+                    SetRenderPipelineCmd* cmd = mCommands.NextCommand<SetRenderPipelineCmd>();
+                    ToBackend(cmd->pipeline)->GetHandle();
+                } break;
+
+                case Command::TransitionBufferUsage: {
+                    TransitionBufferUsageCmd* cmd =
+                        mCommands.NextCommand<TransitionBufferUsageCmd>();
+
+                    Buffer* buffer = ToBackend(cmd->buffer.Get());
+                    mBufferTransitions.push_back({buffer, buffer->GetUsage(), cmd->usage});
+                    buffer->UpdateUsageInternal(cmd->usage);
+                } break;
+
+                case Command::TransitionTextureUsage: {
+                    TransitionTextureUsageCmd* cmd =
+                        mCommands.NextCommand<TransitionTextureUsageCmd>();
+
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    mTextureTransitions.push_back({texture, texture->GetUsage(), cmd->usage});
+                    texture->UpdateUsageInternal(cmd->usage);
+                } break;
+
+                default: { SkipCommand(&mCommands, type); } break;
+            }
+        }
+
+        mCommands.Reset();
+    }
+
+    void CommandBuffer::PrepareAttachmentTransition(Texture* attachment,
+                                                    PreparedRenderPass* renderPass) {
+        if (!(attachment->GetUsage() & nxt::TextureUsageBit::OutputAttachment)) {
+            mTextureTransitions.push_back(
+                {attachment, attachment->GetUsage(), nxt::TextureUsageBit::OutputAttachment});
+            attachment->UpdateUsageInternal(nxt::TextureUsageBit::OutputAttachment);
+            renderPass->attachmentTransitionCount++;
+        }
+    }
+
     void CommandBuffer::RecordCommands(VkCommandBuffer commands) {
         Device* device = ToBackend(GetDevice());
 
         DescriptorSetTracker descriptorSets;
+        PipelineBarrierBatch barriers;
         RenderPipeline* lastRenderPipeline = nullptr;
 
+        size_t nextBufferTransition = 0;
+        size_t nextTextureTransition = 0;
+        size_t nextRenderPass = 0;
+        auto transitionNextTexture = [&]() {
+            const auto& transition = mTextureTransitions[nextTextureTransition++];
+            barriers.TransitionTexture(transition.resource, transition.currentUsage,
+                                       transition.targetUsage);
+        };
+
+        mPipelineBarrierCount = 0;
+        auto flushBarriers = [&]() {
+            if (barriers.Flush(device, commands)) {
+                mPipelineBarrierCount++;
+            }
+        };
+
         Command type;
         while (mCommands.NextCommandId(&type)) {
             switch (type) {
@@ -146,6 +329,7 @@ namespace backend { namespace vulkan {
 
                     VkBuffer srcHandle = ToBackend(src.buffer)->GetHandle();
                     VkBuffer dstHandle = ToBackend(dst.buffer)->GetHandle();
+                    flushBarriers();
                     device->fn.CmdCopyBuffer(commands, srcHandle, dstHandle, 1, &region);
                 } break;
 
@@ -159,6 +343,8 @@ namespace backend { namespace vulkan {
                     VkBufferImageCopy region =
                         ComputeBufferImageCopyRegion(copy->rowPitch, src, dst);
 
+                    flushBarriers();
+
                     // The image is written to so the NXT guarantees make sure it is in the
                     // TRANSFER_DST_OPTIMAL layout
                     device->fn.CmdCopyBufferToImage(commands, srcBuffer, dstImage,
@@ -176,6 +362,8 @@ namespace backend { namespace vulkan {
                     VkBufferImageCopy region =
                         ComputeBufferImageCopyRegion(copy->rowPitch, dst, src);
 
+                    flushBarriers();
+
                     // The NXT TransferSrc usage is always mapped to GENERAL
                     device->fn.CmdCopyImageToBuffer(commands, srcImage, VK_IMAGE_LAYOUT_GENERAL,
                                                     dstBuffer, 1, &region);
@@ -184,31 +372,15 @@ namespace backend { namespace vulkan {
                 case Command::BeginRenderPass: {
                     BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
                     RenderPassDescriptor* info = ToBackend(cmd->info.Get());
+                    const PreparedRenderPass& renderPass = mRenderPasses[nextRenderPass++];
 
-                    // NXT has an implicit transition to color attachment on render passes.
                     // Transition the attachments now before we start the render pass.
-                    for (uint32_t i : IterateBitSet(info->GetColorAttachmentMask())) {
-                        Texture* attachment =
-                            ToBackend(info->GetColorAttachment(i).view->GetTexture());
-
-                        if (!(attachment->GetUsage() & nxt::TextureUsageBit::OutputAttachment)) {
-                            attachment->RecordBarrier(commands, attachment->GetUsage(),
-                                                      nxt::TextureUsageBit::OutputAttachment);
-                            attachment->UpdateUsageInternal(nxt::TextureUsageBit::OutputAttachment);
-                        }
-                    }
-                    if (info->HasDepthStencilAttachment()) {
-                        Texture* attachment =
-                            ToBackend(info->GetDepthStencilAttachment().view->GetTexture());
-
-                        if (!(attachment->GetUsage() & nxt::TextureUsageBit::OutputAttachment)) {
-                            attachment->RecordBarrier(commands, attachment->GetUsage(),
-                                                      nxt::TextureUsageBit::OutputAttachment);
-                            attachment->UpdateUsageInternal(nxt::TextureUsageBit::OutputAttachment);
-                        }
+                    for (uint32_t i = 0; i < renderPass.attachmentTransitionCount; ++i) {
+                        transitionNextTexture();
                     }
 
-                    info->RecordBeginRenderPass(commands);
+                    flushBarriers();
+                    info->RecordBeginRenderPass(commands, renderPass.cachedObjects);
 
                     // Set all the dynamic state just in case.
                     device->fn.CmdSetLineWidth(commands, 1.0f);
@@ -247,6 +419,7 @@ namespace backend { namespace vulkan {
                 case Command::DrawArrays: {
                     DrawArraysCmd* draw = mCommands.NextCommand<DrawArraysCmd>();
 
+                    flushBarriers();
                     descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
                     device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
                                        draw->firstVertex, draw->firstInstance);
@@ -255,6 +428,7 @@ namespace backend { namespace vulkan {
                 case Command::DrawElements: {
                     DrawElementsCmd* draw = mCommands.NextCommand<DrawElementsCmd>();
 
+                    flushBarriers();
                     descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
                     uint32_t vertexOffset = 0;
                     device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
@@ -277,6 +451,7 @@ namespace backend { namespace vulkan {
 
                 case Command::Dispatch: {
                     DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
+                    flushBarriers();
                     descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_COMPUTE);
                     device->fn.CmdDispatch(commands, dispatch->x, dispatch->y, dispatch->z);
                 } break;
@@ -370,23 +545,32 @@ namespace backend { namespace vulkan {
                     TransitionBufferUsageCmd* cmd =
                         mCommands.NextCommand<TransitionBufferUsageCmd>();
 
-                    Buffer* buffer = ToBackend(cmd->buffer.Get());
-                    buffer->RecordBarrier(commands, buffer->GetUsage(), cmd->usage);
-                    buffer->UpdateUsageInternal(cmd->usage);
+                    ASSERT(ToBackend(cmd->buffer.Get()) ==
+                           mBufferTransitions[nextBufferTransition].resource);
+                    const auto& transition = mBufferTransitions[nextBufferTransition++];
+                    barriers.TransitionBuffer(transition.resource, transition.currentUsage,
+                                              transition.targetUsage);
                 } break;
 
                 case Command::TransitionTextureUsage: {
                     TransitionTextureUsageCmd* cmd =
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
 
-                    Texture* texture = ToBackend(cmd->texture.Get());
-                    texture->RecordBarrier(commands, texture->GetUsage(), cmd->usage);
-                    texture->UpdateUsageInternal(cmd->usage);
+                    ASSERT(ToBackend(cmd->texture.Get()) ==
+                           mTextureTransitions[nextTextureTransition].resource);
+                    transitionNextTexture();
                 } break;
 
                 default: { UNREACHABLE(); } break;
             }
         }
+
+        // Transitions at the end of the command buffer apply to the commands submitted after it.
+        flushBarriers();
+    }
+
+    uint32_t CommandBuffer::GetPipelineBarrierCount() const {
+        return mPipelineBarrierCount;
     }
 
 }}  // namespace backend::vulkan
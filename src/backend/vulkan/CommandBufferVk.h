@@ -16,20 +16,57 @@
 #define BACKEND_VULKAN_COMMANDBUFFERVK_H_
 
 #include "backend/CommandBuffer.h"
+#include "backend/vulkan/RenderPassDescriptorVk.h"
 
 #include "common/vulkan_platform.h"
 
+#include <vector>
+
 namespace backend { namespace vulkan {
 
+    class Buffer;
+    class Texture;
+
     class CommandBuffer : public CommandBufferBase {
       public:
         CommandBuffer(CommandBufferBuilder* builder);
         ~CommandBuffer();
 
+        // Resolves the state that recording needs from the resources and the device: the usage
+        // transitions, the render passes and framebuffers from the caches and the compiled
+        // pipelines. It must be called serially and in submit order, because the transitions
+        // depend on the usages left by the previous command buffers.
+        void PrepareRecording();
+        // Records the commands using only the state resolved by PrepareRecording, so that
+        // several command buffers can be recorded concurrently.
         void RecordCommands(VkCommandBuffer commands);
 
+        // Number of vkCmdPipelineBarrier calls made by the last RecordCommands.
+        uint32_t GetPipelineBarrierCount() const;
+
       private:
+        template <typename Resource, typename Usage>
+        struct UsageTransition {
+            Resource* resource;
+            Usage currentUsage;
+            Usage targetUsage;
+        };
+
+        struct PreparedRenderPass {
+            RenderPassDescriptor::CachedObjects cachedObjects;
+            // The number of attachments transitioned to OutputAttachment before the render pass.
+            uint32_t attachmentTransitionCount;
+        };
+
+        void PrepareAttachmentTransition(Texture* attachment, PreparedRenderPass* renderPass);
+
         CommandIterator mCommands;
+        uint32_t mPipelineBarrierCount = 0;
+
+        // The state resolved by PrepareRecording, consumed in command order by RecordCommands.
+        std::vector<UsageTransition<Buffer, nxt::BufferUsageBit>> mBufferTransitions;
+        std::vector<UsageTransition<Texture, nxt::TextureUsageBit>> mTextureTransitions;
+        std::vector<PreparedRenderPass> mRenderPasses;
     };
 
 }}  // namespace backend::vulkan
@@ -15,15 +15,34 @@
 #include "backend/vulkan/ComputePipelineVk.h"
 
 #include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/PipelineCache.h"
 #include "backend/vulkan/PipelineLayoutVk.h"
 #include "backend/vulkan/ShaderModuleVk.h"
 #include "backend/vulkan/VulkanBackend.h"
+#include "common/Trace.h"
+#include "common/WorkerPool.h"
+
+#include <memory>
+#include <string>
 
 namespace backend { namespace vulkan {
 
+    namespace {
+
+        // Holds the structures chained in the VkComputePipelineCreateInfo so that they stay alive
+        // while the pipeline is compiled on a worker thread.
+        struct ComputePipelineCreateData {
+            std::string entryPoint;
+            VkComputePipelineCreateInfo createInfo;
+        };
+
+    }  // anonymous namespace
+
     ComputePipeline::ComputePipeline(ComputePipelineBuilder* builder)
         : ComputePipelineBase(builder), mDevice(ToBackend(builder->GetDevice())) {
-        VkComputePipelineCreateInfo createInfo;
+        auto data = std::make_shared<ComputePipelineCreateData>();
+
+        VkComputePipelineCreateInfo& createInfo = data->createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
         createInfo.pNext = nullptr;
         createInfo.flags = 0;
@@ -31,30 +50,56 @@ namespace backend { namespace vulkan {
         createInfo.basePipelineHandle = VK_NULL_HANDLE;
         createInfo.basePipelineIndex = -1;
 
+        // The shader module must stay alive until the pipeline is compiled.
         const auto& stageInfo = builder->GetStageInfo(nxt::ShaderStage::Compute);
+        mModule = stageInfo.module;
+        data->entryPoint = stageInfo.entryPoint;
+
         createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         createInfo.stage.pNext = nullptr;
         createInfo.stage.flags = 0;
         createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         createInfo.stage.module = ToBackend(stageInfo.module)->GetHandle();
-        createInfo.stage.pName = stageInfo.entryPoint.c_str();
+        createInfo.stage.pName = data->entryPoint.c_str();
         createInfo.stage.pSpecializationInfo = nullptr;
 
-        if (mDevice->fn.CreateComputePipelines(mDevice->GetVkDevice(), VK_NULL_HANDLE, 1,
-                                               &createInfo, nullptr, &mHandle) != VK_SUCCESS) {
-            ASSERT(false);
+        auto compile = [this, data]() {
+            NXT_TRACE_SCOPE("vkCreateComputePipelines");
+            VkPipelineCache cache = mDevice->GetPipelineCache()->GetHandle();
+            if (mDevice->fn.CreateComputePipelines(mDevice->GetVkDevice(), cache, 1,
+                                                   &data->createInfo, nullptr,
+                                                   &mHandle) != VK_SUCCESS) {
+                ASSERT(false);
+            }
+        };
+
+        WorkerPool* pool = mDevice->GetPipelineCompilationPool();
+        if (pool != nullptr) {
+            mCompilation = pool->PostTask(compile);
+        } else {
+            compile();
+            mModule = {};
         }
     }
 
     ComputePipeline::~ComputePipeline() {
+        WaitForCompilation();
         if (mHandle != VK_NULL_HANDLE) {
             mDevice->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
     }
 
-    VkPipeline ComputePipeline::GetHandle() const {
+    VkPipeline ComputePipeline::GetHandle() {
+        WaitForCompilation();
         return mHandle;
     }
 
+    void ComputePipeline::WaitForCompilation() {
+        if (mCompilation.valid()) {
+            mCompilation.get();
+            mModule = {};
+        }
+    }
+
 }}  // namespace backend::vulkan
@@ -19,6 +19,8 @@
 
 #include "common/vulkan_platform.h"
 
+#include <future>
+
 namespace backend { namespace vulkan {
 
     class Device;
@@ -28,11 +30,17 @@ namespace backend { namespace vulkan {
         ComputePipeline(ComputePipelineBuilder* builder);
         ~ComputePipeline();
 
-        VkPipeline GetHandle() const;
+        // Waits for the pipeline to be compiled if it is compiled asynchronously.
+        VkPipeline GetHandle();
 
       private:
+        void WaitForCompilation();
+
         VkPipeline mHandle = VK_NULL_HANDLE;
         Device* mDevice = nullptr;
+
+        std::future<void> mCompilation;
+        Ref<ShaderModuleBase> mModule;
     };
 
 }}  // namespace backend::vulkan
@@ -0,0 +1,132 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/FramebufferCache.h"
+
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/VulkanBackend.h"
+#include "common/HashUtils.h"
+
+namespace backend { namespace vulkan {
+
+    FramebufferCache::FramebufferCache(Device* device) : mDevice(device) {
+    }
+
+    FramebufferCache::~FramebufferCache() {
+        for (auto it : mCache) {
+            mDevice->fn.DestroyFramebuffer(mDevice->GetVkDevice(), it.second, nullptr);
+        }
+        mCache.clear();
+    }
+
+    VkFramebuffer FramebufferCache::GetFramebuffer(const FramebufferCacheQuery& query) {
+        auto it = mCache.find(query);
+        if (it != mCache.end()) {
+            mHitCount++;
+            return it->second;
+        }
+
+        mMissCount++;
+        VkFramebuffer framebuffer = CreateFramebufferForQuery(query);
+        mCache.emplace(query, framebuffer);
+        return framebuffer;
+    }
+
+    template <typename Predicate>
+    void FramebufferCache::EvictIf(Predicate predicate) {
+        // The cache only contains the framebuffers for live attachments so it stays small enough
+        // that a linear scan is cheaper than maintaining reverse mappings.
+        for (auto it = mCache.begin(); it != mCache.end();) {
+            if (predicate(it->first)) {
+                mDevice->GetFencedDeleter()->DeleteWhenUnused(it->second);
+                it = mCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void FramebufferCache::OnImageViewDestroyed(VkImageView view) {
+        EvictIf([view](const FramebufferCacheQuery& query) -> bool {
+            for (uint32_t i = 0; i < query.attachmentCount; ++i) {
+                if (query.attachments[i] == view) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    void FramebufferCache::OnRenderPassDestroyed(VkRenderPass renderPass) {
+        EvictIf([renderPass](const FramebufferCacheQuery& query) -> bool {
+            return query.renderPass == renderPass;
+        });
+    }
+
+    uint64_t FramebufferCache::GetHitCount() const {
+        return mHitCount;
+    }
+
+    uint64_t FramebufferCache::GetMissCount() const {
+        return mMissCount;
+    }
+
+    VkFramebuffer FramebufferCache::CreateFramebufferForQuery(
+        const FramebufferCacheQuery& query) const {
+        VkFramebufferCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.renderPass = query.renderPass;
+        createInfo.attachmentCount = query.attachmentCount;
+        createInfo.pAttachments = query.attachments.data();
+        createInfo.width = query.width;
+        createInfo.height = query.height;
+        createInfo.layers = 1;
+
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        if (mDevice->fn.CreateFramebuffer(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                          &framebuffer) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+
+        return framebuffer;
+    }
+
+    // FramebufferCache::CacheFuncs
+
+    size_t FramebufferCache::CacheFuncs::operator()(const FramebufferCacheQuery& query) const {
+        size_t hash = Hash(query.renderPass.GetHandle());
+        HashCombine(&hash, query.attachmentCount, query.width, query.height);
+        return HashBytes(query.attachments.data(), query.attachmentCount * sizeof(VkImageView),
+                         hash);
+    }
+
+    bool FramebufferCache::CacheFuncs::operator()(const FramebufferCacheQuery& a,
+                                                  const FramebufferCacheQuery& b) const {
+        if (a.renderPass != b.renderPass || a.attachmentCount != b.attachmentCount ||
+            a.width != b.width || a.height != b.height) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < a.attachmentCount; ++i) {
+            if (a.attachments[i] != b.attachments[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}}  // namespace backend::vulkan
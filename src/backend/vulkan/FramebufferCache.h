@@ -0,0 +1,85 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_FRAMEBUFFERCACHE_H_
+#define BACKEND_VULKAN_FRAMEBUFFERCACHE_H_
+
+#include "common/vulkan_platform.h"
+
+#include "common/Constants.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // This is a key to query the FramebufferCache, only the first attachmentCount elements of
+    // attachments need to be initialized.
+    struct FramebufferCacheQuery {
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        uint32_t attachmentCount = 0;
+        std::array<VkImageView, kMaxColorAttachments + 1> attachments;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Caches VkFramebuffers so that render passes drawing to the same attachments every frame don't
+    // create a new framebuffer each time. Framebuffers are evicted when one of the image views they
+    // reference is destroyed.
+    class FramebufferCache {
+      public:
+        FramebufferCache(Device* device);
+        ~FramebufferCache();
+
+        VkFramebuffer GetFramebuffer(const FramebufferCacheQuery& query);
+
+        // Removes the framebuffers referencing view from the cache, they are deleted once the
+        // commands using them are finished.
+        void OnImageViewDestroyed(VkImageView view);
+        // Same as OnImageViewDestroyed, for framebuffers created with renderPass.
+        void OnRenderPassDestroyed(VkRenderPass renderPass);
+
+        // Number of GetFramebuffer calls that found or didn't find a cached framebuffer.
+        uint64_t GetHitCount() const;
+        uint64_t GetMissCount() const;
+
+      private:
+        VkFramebuffer CreateFramebufferForQuery(const FramebufferCacheQuery& query) const;
+
+        // Deletes when unused and removes all the framebuffers for which predicate returns true.
+        template <typename Predicate>
+        void EvictIf(Predicate predicate);
+
+        // Implements the functors necessary for to use FramebufferCacheQueries as unordered_map
+        // keys.
+        struct CacheFuncs {
+            size_t operator()(const FramebufferCacheQuery& query) const;
+            bool operator()(const FramebufferCacheQuery& a, const FramebufferCacheQuery& b) const;
+        };
+        using Cache =
+            std::unordered_map<FramebufferCacheQuery, VkFramebuffer, CacheFuncs, CacheFuncs>;
+
+        Device* mDevice = nullptr;
+        Cache mCache;
+
+        uint64_t mHitCount = 0;
+        uint64_t mMissCount = 0;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_FRAMEBUFFERCACHE_H_
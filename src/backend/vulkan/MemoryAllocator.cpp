@@ -16,6 +16,9 @@
 
 #include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/VulkanBackend.h"
+#include "common/Math.h"
+
+#include <algorithm>
 
 namespace backend { namespace vulkan {
 
@@ -35,15 +38,105 @@ namespace backend { namespace vulkan {
         return mMappedPointer;
     }
 
+    MemoryAllocator::MemoryBlock::MemoryBlock(VkDeviceMemory memory,
+                                              uint8_t* mappedPointer,
+                                              VkDeviceSize minAllocation)
+        : memory(memory), mappedPointer(mappedPointer), allocator(kBlockSize, minAllocation) {
+    }
+
     MemoryAllocator::MemoryAllocator(Device* device) : mDevice(device) {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+        mBlocks.resize(info.memoryTypes.size());
+        mDedicatedBytesPerHeap.resize(info.memoryHeaps.size(), 0);
     }
 
     MemoryAllocator::~MemoryAllocator() {
+        // All commands are finished by the time the allocator is destroyed, so blocks can be freed
+        // immediately.
+        for (auto& blocks : mBlocks) {
+            for (auto& block : blocks) {
+                mDevice->fn.FreeMemory(mDevice->GetVkDevice(), block->memory, nullptr);
+            }
+        }
     }
 
     bool MemoryAllocator::Allocate(VkMemoryRequirements requirements,
                                    bool mappable,
                                    DeviceMemoryAllocation* allocation) {
+        int bestType = FindBestTypeIndex(requirements, mappable);
+
+        // TODO(cwallez@chromium.org): I think the Vulkan spec guarantees this should never happen
+        if (bestType == -1) {
+            ASSERT(false);
+            return false;
+        }
+
+        uint32_t memoryType = static_cast<uint32_t>(bestType);
+        if (requirements.size <= kBlockSize / 2 &&
+            AllocateInBlock(requirements, memoryType, allocation)) {
+            return true;
+        }
+
+        return AllocateDedicated(requirements, memoryType, mappable, allocation);
+    }
+
+    void MemoryAllocator::Free(DeviceMemoryAllocation* allocation) {
+        if (allocation->mBlockIndex == kDedicatedBlock) {
+            uint32_t heapIndex =
+                mDevice->GetDeviceInfo().memoryTypes[allocation->mMemoryType].heapIndex;
+            mDedicatedBytesPerHeap[heapIndex] -= allocation->mSize;
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(allocation->mMemory);
+        } else {
+            mFreedRanges.Enqueue(
+                {allocation->mMemoryType, allocation->mBlockIndex, allocation->mOffset},
+                mDevice->GetSerial());
+        }
+
+        allocation->mMemory = VK_NULL_HANDLE;
+        allocation->mOffset = 0;
+        allocation->mMappedPointer = nullptr;
+    }
+
+    void MemoryAllocator::Tick(Serial finishedSerial) {
+        for (const FreedRange& range : mFreedRanges.IterateUpTo(finishedSerial)) {
+            mBlocks[range.memoryType][range.blockIndex]->allocator.Free(range.offset);
+        }
+        mFreedRanges.ClearUpTo(finishedSerial);
+    }
+
+    MemoryAllocator::HeapStats MemoryAllocator::GetHeapStats(uint32_t heapIndex) const {
+        const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+        ASSERT(heapIndex < info.memoryHeaps.size());
+
+        HeapStats stats;
+        stats.allocatedBytes = mDedicatedBytesPerHeap[heapIndex];
+        stats.usedBytes = mDedicatedBytesPerHeap[heapIndex];
+
+        VkDeviceSize freeBytes = 0;
+        VkDeviceSize largestFreeRange = 0;
+        for (size_t type = 0; type < mBlocks.size(); ++type) {
+            if (info.memoryTypes[type].heapIndex != heapIndex) {
+                continue;
+            }
+
+            for (const auto& block : mBlocks[type]) {
+                const BuddyAllocator& allocator = block->allocator;
+                stats.allocatedBytes += allocator.GetSize();
+                stats.usedBytes += allocator.GetUsedSize();
+                freeBytes += allocator.GetSize() - allocator.GetUsedSize();
+                largestFreeRange = std::max(largestFreeRange, allocator.GetLargestFreeRangeSize());
+            }
+        }
+
+        if (freeBytes > 0) {
+            stats.fragmentation =
+                1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+        }
+        return stats;
+    }
+
+    int MemoryAllocator::FindBestTypeIndex(VkMemoryRequirements requirements,
+                                           bool mappable) const {
         const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
 
         // Find a suitable memory type for this allocation
@@ -88,17 +181,18 @@ namespace backend { namespace vulkan {
             }
         }
 
-        // TODO(cwallez@chromium.org): I think the Vulkan spec guarantees this should never happen
-        if (bestType == -1) {
-            ASSERT(false);
-            return false;
-        }
+        return bestType;
+    }
 
+    bool MemoryAllocator::AllocateDedicated(VkMemoryRequirements requirements,
+                                            uint32_t memoryType,
+                                            bool mappable,
+                                            DeviceMemoryAllocation* allocation) {
         VkMemoryAllocateInfo allocateInfo;
         allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         allocateInfo.pNext = nullptr;
         allocateInfo.allocationSize = requirements.size;
-        allocateInfo.memoryTypeIndex = static_cast<uint32_t>(bestType);
+        allocateInfo.memoryTypeIndex = memoryType;
 
         VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
         if (mDevice->fn.AllocateMemory(mDevice->GetVkDevice(), &allocateInfo, nullptr,
@@ -117,17 +211,84 @@ namespace backend { namespace vulkan {
         allocation->mMemory = allocatedMemory;
         allocation->mOffset = 0;
         allocation->mMappedPointer = reinterpret_cast<uint8_t*>(mappedPointer);
+        allocation->mMemoryType = memoryType;
+        allocation->mBlockIndex = kDedicatedBlock;
+        allocation->mSize = requirements.size;
+
+        uint32_t heapIndex = mDevice->GetDeviceInfo().memoryTypes[memoryType].heapIndex;
+        mDedicatedBytesPerHeap[heapIndex] += requirements.size;
 
         return true;
     }
 
-    void MemoryAllocator::Free(DeviceMemoryAllocation* allocation) {
-        mDevice->GetFencedDeleter()->DeleteWhenUnused(allocation->mMemory);
-        allocation->mMemory = VK_NULL_HANDLE;
-        allocation->mOffset = 0;
-        allocation->mMappedPointer = nullptr;
-    }
+    bool MemoryAllocator::AllocateInBlock(VkMemoryRequirements requirements,
+                                          uint32_t memoryType,
+                                          DeviceMemoryAllocation* allocation) {
+        auto& blocks = mBlocks[memoryType];
 
-    void MemoryAllocator::Tick(Serial) {
+        size_t blockIndex = 0;
+        uint64_t offset = BuddyAllocator::kInvalidOffset;
+        for (; blockIndex < blocks.size(); ++blockIndex) {
+            offset = blocks[blockIndex]->allocator.Allocate(requirements.size,
+                                                            requirements.alignment);
+            if (offset != BuddyAllocator::kInvalidOffset) {
+                break;
+            }
+        }
+
+        if (offset == BuddyAllocator::kInvalidOffset) {
+            VkMemoryAllocateInfo allocateInfo;
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.pNext = nullptr;
+            allocateInfo.allocationSize = kBlockSize;
+            allocateInfo.memoryTypeIndex = memoryType;
+
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            if (mDevice->fn.AllocateMemory(mDevice->GetVkDevice(), &allocateInfo, nullptr,
+                                           &memory) != VK_SUCCESS) {
+                return false;
+            }
+
+            // Host visible blocks stay mapped for their whole lifetime.
+            const VulkanDeviceInfo& info = mDevice->GetDeviceInfo();
+            void* mappedPointer = nullptr;
+            if ((info.memoryTypes[memoryType].propertyFlags &
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+                if (mDevice->fn.MapMemory(mDevice->GetVkDevice(), memory, 0, kBlockSize, 0,
+                                          &mappedPointer) != VK_SUCCESS) {
+                    mDevice->fn.FreeMemory(mDevice->GetVkDevice(), memory, nullptr);
+                    return false;
+                }
+            }
+
+            // Ranges are aligned on their size so making them at least bufferImageGranularity
+            // guarantees linear and optimal resources never share a granularity page.
+            VkDeviceSize minAllocation = info.properties.limits.bufferImageGranularity;
+            if (minAllocation < kMinAllocationSize) {
+                minAllocation = kMinAllocationSize;
+            }
+            while (!IsPowerOfTwo(minAllocation)) {
+                minAllocation += minAllocation & (~minAllocation + 1);
+            }
+
+            blocks.emplace_back(new MemoryBlock(memory, reinterpret_cast<uint8_t*>(mappedPointer),
+                                                minAllocation));
+            blockIndex = blocks.size() - 1;
+            offset = blocks[blockIndex]->allocator.Allocate(requirements.size,
+                                                            requirements.alignment);
+            ASSERT(offset != BuddyAllocator::kInvalidOffset);
+        }
+
+        const MemoryBlock& block = *blocks[blockIndex];
+        allocation->mMemory = block.memory;
+        allocation->mOffset = static_cast<size_t>(offset);
+        allocation->mMappedPointer =
+            block.mappedPointer != nullptr ? block.mappedPointer + offset : nullptr;
+        allocation->mMemoryType = memoryType;
+        allocation->mBlockIndex = blockIndex;
+        allocation->mSize = requirements.size;
+
+        return true;
     }
+
 }}  // namespace backend::vulkan
@@ -15,9 +15,13 @@
 #ifndef BACKEND_VULKAN_MEMORYALLOCATOR_H_
 #define BACKEND_VULKAN_MEMORYALLOCATOR_H_
 
+#include "common/BuddyAllocator.h"
 #include "common/SerialQueue.h"
 #include "common/vulkan_platform.h"
 
+#include <memory>
+#include <vector>
+
 namespace backend { namespace vulkan {
 
     class Device;
@@ -35,8 +39,17 @@ namespace backend { namespace vulkan {
         VkDeviceMemory mMemory = VK_NULL_HANDLE;
         size_t mOffset = 0;
         uint8_t* mMappedPointer = nullptr;
+
+        // Where the allocation comes from, mBlockIndex is kDedicatedBlock for allocations that
+        // have their own VkDeviceMemory.
+        uint32_t mMemoryType = 0;
+        size_t mBlockIndex = 0;
+        VkDeviceSize mSize = 0;
     };
 
+    // Sub-allocates resources in large blocks of VkDeviceMemory, one set of blocks per memory type.
+    // Ranges of the blocks are managed with a buddy allocator, which honors the alignment
+    // requirements of resources. Resources bigger than half a block get a dedicated allocation.
     class MemoryAllocator {
       public:
         MemoryAllocator(Device* device);
@@ -45,12 +58,57 @@ namespace backend { namespace vulkan {
         bool Allocate(VkMemoryRequirements requirements,
                       bool mappable,
                       DeviceMemoryAllocation* allocation);
+        // The range is reused once the commands of the current serial are completed.
         void Free(DeviceMemoryAllocation* allocation);
 
         void Tick(Serial finishedSerial);
 
+        struct HeapStats {
+            // Bytes of VkDeviceMemory allocated from the heap.
+            VkDeviceSize allocatedBytes = 0;
+            // Bytes used by resources, including the rounding of sub-allocations.
+            VkDeviceSize usedBytes = 0;
+            // 1 - largest free range / free bytes in the blocks of the heap: 0 when all the free
+            // space is contiguous and closer to 1 as it is split in small ranges.
+            float fragmentation = 0.0f;
+        };
+        HeapStats GetHeapStats(uint32_t heapIndex) const;
+
       private:
+        int FindBestTypeIndex(VkMemoryRequirements requirements, bool mappable) const;
+        bool AllocateDedicated(VkMemoryRequirements requirements,
+                               uint32_t memoryType,
+                               bool mappable,
+                               DeviceMemoryAllocation* allocation);
+        bool AllocateInBlock(VkMemoryRequirements requirements,
+                             uint32_t memoryType,
+                             DeviceMemoryAllocation* allocation);
+
+        static constexpr VkDeviceSize kBlockSize = 64 * 1024 * 1024;
+        static constexpr VkDeviceSize kMinAllocationSize = 256;
+        static constexpr size_t kDedicatedBlock = SIZE_MAX;
+
+        struct MemoryBlock {
+            MemoryBlock(VkDeviceMemory memory, uint8_t* mappedPointer, VkDeviceSize minAllocation);
+
+            VkDeviceMemory memory;
+            uint8_t* mappedPointer;
+            BuddyAllocator allocator;
+        };
+
+        struct FreedRange {
+            uint32_t memoryType;
+            size_t blockIndex;
+            VkDeviceSize offset;
+        };
+
         Device* mDevice = nullptr;
+
+        // Blocks are kept once allocated so that indices in mBlocks stay valid.
+        std::vector<std::vector<std::unique_ptr<MemoryBlock>>> mBlocks;
+        SerialQueue<FreedRange> mFreedRanges;
+
+        std::vector<VkDeviceSize> mDedicatedBytesPerHeap;
     };
 
 }}  // namespace backend::vulkan
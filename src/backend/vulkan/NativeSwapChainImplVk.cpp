@@ -181,6 +181,7 @@ namespace backend { namespace vulkan {
         // Since we're going to do a queue operations we need to flush pending commands such as
         // layout transitions of the swapchain images to the PRESENT layout.
         mDevice->SubmitPendingCommands();
+        mDevice->EndFrame();
 
         // Assuming that the present queue is the same as the graphics queue, the proper
         // synchronization has already been done by the usage transition to present so we don't
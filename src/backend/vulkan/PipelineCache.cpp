@@ -0,0 +1,156 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/PipelineCache.h"
+
+#include "backend/vulkan/VulkanBackend.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    namespace {
+
+        // Written before the VkPipelineCache data in the file. The data has a header with the
+        // vendor, device and pipeline cache UUID, but not the driver version which we also check
+        // to avoid giving stale data to a driver.
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+        };
+
+        constexpr uint32_t kFileMagic = 0x4e585043;  // "NXPC"
+
+        FileHeader ComputeFileHeader(const VkPhysicalDeviceProperties& properties,
+                                     uint64_t dataSize) {
+            FileHeader header;
+            memset(&header, 0, sizeof(header));
+            header.magic = kFileMagic;
+            header.vendorID = properties.vendorID;
+            header.deviceID = properties.deviceID;
+            header.driverVersion = properties.driverVersion;
+            memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+            header.dataSize = dataSize;
+            return header;
+        }
+
+    }  // anonymous namespace
+
+    PipelineCache::PipelineCache(Device* device) : mDevice(device) {
+        mHandle = CreateCache(0, nullptr);
+    }
+
+    PipelineCache::~PipelineCache() {
+        // The cache isn't referenced by the pipelines created with it so it can be destroyed
+        // immediately.
+        if (mHandle != VK_NULL_HANDLE) {
+            mDevice->fn.DestroyPipelineCache(mDevice->GetVkDevice(), mHandle, nullptr);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkPipelineCache PipelineCache::GetHandle() const {
+        return mHandle;
+    }
+
+    bool PipelineCache::LoadFromFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        FileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return false;
+        }
+
+        const VkPhysicalDeviceProperties& properties = mDevice->GetDeviceInfo().properties;
+        FileHeader expectedHeader = ComputeFileHeader(properties, header.dataSize);
+        if (memcmp(&header, &expectedHeader, sizeof(header)) != 0) {
+            return false;
+        }
+
+        // The header could be corrupted, only allocate data for it if the file contains it.
+        std::streampos dataStart = file.tellg();
+        file.seekg(0, std::ios::end);
+        std::streamoff remainingSize = file.tellg() - dataStart;
+        if (!file || header.dataSize != static_cast<uint64_t>(remainingSize)) {
+            return false;
+        }
+        file.seekg(dataStart);
+
+        std::vector<char> data(static_cast<size_t>(header.dataSize));
+        if (!file.read(data.data(), data.size())) {
+            return false;
+        }
+
+        // Pipelines might already have been added to the cache so the loaded data is merged in
+        // it instead of replacing it.
+        VkPipelineCache loadedCache = CreateCache(data.size(), data.data());
+        if (loadedCache == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        VkResult result =
+            mDevice->fn.MergePipelineCaches(mDevice->GetVkDevice(), mHandle, 1, &loadedCache);
+        mDevice->fn.DestroyPipelineCache(mDevice->GetVkDevice(), loadedCache, nullptr);
+        return result == VK_SUCCESS;
+    }
+
+    bool PipelineCache::StoreToFile(const std::string& path) const {
+        size_t dataSize = 0;
+        if (mDevice->fn.GetPipelineCacheData(mDevice->GetVkDevice(), mHandle, &dataSize,
+                                             nullptr) != VK_SUCCESS) {
+            return false;
+        }
+
+        std::vector<char> data(dataSize);
+        if (mDevice->fn.GetPipelineCacheData(mDevice->GetVkDevice(), mHandle, &dataSize,
+                                             data.data()) != VK_SUCCESS) {
+            return false;
+        }
+
+        const VkPhysicalDeviceProperties& properties = mDevice->GetDeviceInfo().properties;
+        FileHeader header = ComputeFileHeader(properties, dataSize);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), dataSize);
+        return static_cast<bool>(file);
+    }
+
+    VkPipelineCache PipelineCache::CreateCache(size_t initialDataSize,
+                                               const void* initialData) const {
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = initialDataSize;
+        createInfo.pInitialData = initialData;
+
+        VkPipelineCache cache = VK_NULL_HANDLE;
+        if (mDevice->fn.CreatePipelineCache(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                            &cache) != VK_SUCCESS) {
+            return VK_NULL_HANDLE;
+        }
+        return cache;
+    }
+
+}}  // namespace backend::vulkan
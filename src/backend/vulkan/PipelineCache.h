@@ -0,0 +1,50 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_PIPELINECACHE_H_
+#define BACKEND_VULKAN_PIPELINECACHE_H_
+
+#include "common/vulkan_platform.h"
+
+#include <string>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // Wraps the VkPipelineCache used to create all the pipelines of a device. Its content can be
+    // saved to a file and reloaded in a later run so that pipeline compilations are warm from the
+    // start. Saved data is only reused with the same physical device and driver version.
+    class PipelineCache {
+      public:
+        PipelineCache(Device* device);
+        ~PipelineCache();
+
+        VkPipelineCache GetHandle() const;
+
+        // Merges the content of the file at path in the cache, returns false if the file doesn't
+        // exist or was saved for another device or driver.
+        bool LoadFromFile(const std::string& path);
+        bool StoreToFile(const std::string& path) const;
+
+      private:
+        VkPipelineCache CreateCache(size_t initialDataSize, const void* initialData) const;
+
+        Device* mDevice = nullptr;
+        VkPipelineCache mHandle = VK_NULL_HANDLE;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_PIPELINECACHE_H_
@@ -14,6 +14,8 @@
 
 #include "backend/vulkan/RenderPassCache.h"
 
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/FramebufferCache.h"
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
 #include "common/BitSetIterator.h"
@@ -53,26 +55,89 @@ namespace backend { namespace vulkan {
         this->stencilLoadOp = stencilLoadOp;
     }
 
+    std::vector<RenderPassCacheQuery> GetCommonRenderPassQueries() {
+        std::vector<RenderPassCacheQuery> queries;
+        for (nxt::TextureFormat format :
+             {nxt::TextureFormat::R8G8B8A8Unorm, nxt::TextureFormat::B8G8R8A8Unorm}) {
+            for (nxt::LoadOp loadOp : {nxt::LoadOp::Clear, nxt::LoadOp::Load}) {
+                RenderPassCacheQuery query;
+                query.SetColor(0, format, loadOp);
+                queries.push_back(query);
+
+                query.SetDepthStencil(nxt::TextureFormat::D32FloatS8Uint, loadOp, loadOp);
+                queries.push_back(query);
+            }
+        }
+        return queries;
+    }
+
     // RenderPassCache
 
-    RenderPassCache::RenderPassCache(Device* device) : mDevice(device) {
+    constexpr size_t RenderPassCache::kDefaultMaxSize;
+
+    RenderPassCache::RenderPassCache(Device* device, size_t maxSize)
+        : mDevice(device), mMaxSize(maxSize) {
+        ASSERT(maxSize > 0);
     }
 
     RenderPassCache::~RenderPassCache() {
-        for (auto it : mCache) {
-            mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), it.second, nullptr);
+        for (const auto& entry : mLRU) {
+            mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), entry.second, nullptr);
         }
         mCache.clear();
+        mLRU.clear();
     }
 
     VkRenderPass RenderPassCache::GetRenderPass(const RenderPassCacheQuery& query) {
         auto it = mCache.find(query);
         if (it != mCache.end()) {
-            return it->second;
+            mHitCount++;
+            mLRU.splice(mLRU.begin(), mLRU, it->second);
+            return it->second->second;
+        }
+
+        mMissCount++;
+        return Insert(query);
+    }
+
+    void RenderPassCache::Prewarm(const std::vector<RenderPassCacheQuery>& queries) {
+        for (const RenderPassCacheQuery& query : queries) {
+            if (mCache.find(query) == mCache.end()) {
+                Insert(query);
+            }
+        }
+    }
+
+    uint64_t RenderPassCache::GetHitCount() const {
+        return mHitCount;
+    }
+
+    uint64_t RenderPassCache::GetMissCount() const {
+        return mMissCount;
+    }
+
+    uint64_t RenderPassCache::GetEvictionCount() const {
+        return mEvictionCount;
+    }
+
+    VkRenderPass RenderPassCache::Insert(const RenderPassCacheQuery& query) {
+        if (mCache.size() >= mMaxSize) {
+            VkRenderPass evicted = mLRU.back().second;
+            mCache.erase(mLRU.back().first);
+            mLRU.pop_back();
+            mEvictionCount++;
+
+            // Framebuffers are keyed on the render pass handle which could be reused after the
+            // render pass is destroyed.
+            mDevice->GetFramebufferCache()->OnRenderPassDestroyed(evicted);
+            // Pipelines being compiled in the background could still be using the render pass.
+            mDevice->WaitForPipelineCompilations();
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(evicted);
         }
 
         VkRenderPass renderPass = CreateRenderPassForQuery(query);
-        mCache.emplace(query, renderPass);
+        mLRU.emplace_front(query, renderPass);
+        mCache.emplace(query, mLRU.begin());
         return renderPass;
     }
 
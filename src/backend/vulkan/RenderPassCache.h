@@ -22,7 +22,11 @@
 
 #include <array>
 #include <bitset>
+#include <cstdint>
+#include <list>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace backend { namespace vulkan {
 
@@ -49,31 +53,60 @@ namespace backend { namespace vulkan {
         nxt::LoadOp stencilLoadOp;
     };
 
+    // The queries for a single color attachment in one of the swapchain formats, with or without a
+    // depth-stencil attachment, and with every load operation. They are the render passes of most
+    // applications and the device prewarms its cache with them.
+    std::vector<RenderPassCacheQuery> GetCommonRenderPassQueries();
+
     // Caches VkRenderPasses so that we don't create duplicate ones for every RenderPipeline or
-    // render pass.
-    // TODO(cwallez@chromium.org): Make it an LRU cache somehow?
+    // render pass. The cache holds at most maxSize render passes, when it is full the least
+    // recently used one is evicted and deleted once the commands using it are finished.
     class RenderPassCache {
       public:
-        RenderPassCache(Device* device);
+        static constexpr size_t kDefaultMaxSize = 256;
+
+        RenderPassCache(Device* device, size_t maxSize = kDefaultMaxSize);
         ~RenderPassCache();
 
         VkRenderPass GetRenderPass(const RenderPassCacheQuery& query);
 
+        // Creates the render passes for queries ahead of time so that the first frames don't pay
+        // for their creation. Doesn't count as hits or misses.
+        void Prewarm(const std::vector<RenderPassCacheQuery>& queries);
+
+        uint64_t GetHitCount() const;
+        uint64_t GetMissCount() const;
+        uint64_t GetEvictionCount() const;
+
       private:
         // Does the actual VkRenderPass creation on a cache miss.
         VkRenderPass CreateRenderPassForQuery(const RenderPassCacheQuery& query) const;
 
+        // Adds a new render pass as the most recently used one, evicting the least recently used
+        // one if the cache is full.
+        VkRenderPass Insert(const RenderPassCacheQuery& query);
+
         // Implements the functors necessary for to use RenderPassCacheQueries as unordered_map
         // keys.
         struct CacheFuncs {
             size_t operator()(const RenderPassCacheQuery& query) const;
             bool operator()(const RenderPassCacheQuery& a, const RenderPassCacheQuery& b) const;
         };
+
+        // The render passes ordered from the most to the least recently used, the map points in
+        // the list to find them in constant time.
+        using LRUList = std::list<std::pair<RenderPassCacheQuery, VkRenderPass>>;
         using Cache =
-            std::unordered_map<RenderPassCacheQuery, VkRenderPass, CacheFuncs, CacheFuncs>;
+            std::unordered_map<RenderPassCacheQuery, LRUList::iterator, CacheFuncs, CacheFuncs>;
 
         Device* mDevice = nullptr;
+        size_t mMaxSize = 0;
+        LRUList mLRU;
         Cache mCache;
+
+        uint64_t mHitCount = 0;
+        uint64_t mMissCount = 0;
+        uint64_t mEvictionCount = 0;
     };
 
 }}  // namespace backend::vulkan
@@ -14,7 +14,7 @@
 
 #include "backend/vulkan/RenderPassDescriptorVk.h"
 
-#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/FramebufferCache.h"
 #include "backend/vulkan/RenderPassCache.h"
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
@@ -26,9 +26,10 @@ namespace backend { namespace vulkan {
         : RenderPassDescriptorBase(builder), mDevice(ToBackend(builder->GetDevice())) {
     }
 
-    void RenderPassDescriptor::RecordBeginRenderPass(VkCommandBuffer commands) {
+    RenderPassDescriptor::CachedObjects RenderPassDescriptor::QueryCachedObjects() {
+        CachedObjects cached;
+
         // Query a VkRenderPass from the cache
-        VkRenderPass renderPass = VK_NULL_HANDLE;
         {
             RenderPassCacheQuery query;
 
@@ -44,71 +45,65 @@ namespace backend { namespace vulkan {
                                       attachmentInfo.depthLoadOp, attachmentInfo.stencilLoadOp);
             }
 
-            renderPass = mDevice->GetRenderPassCache()->GetRenderPass(query);
+            cached.renderPass = mDevice->GetRenderPassCache()->GetRenderPass(query);
         }
 
-        // Create a framebuffer that will be used once for the render pass and gather the clear
-        // values for the attachments at the same time.
-        std::array<VkClearValue, kMaxColorAttachments + 1> clearValues;
-        VkFramebuffer framebuffer = VK_NULL_HANDLE;
-        uint32_t attachmentCount = 0;
+        // Query a VkFramebuffer from the cache
         {
-            // Fill in the attachment info that will be chained in the framebuffer create info.
-            std::array<VkImageView, kMaxColorAttachments + 1> attachments;
+            FramebufferCacheQuery query;
+            query.renderPass = cached.renderPass;
+            query.width = GetWidth();
+            query.height = GetHeight();
 
+            uint32_t attachmentCount = 0;
             for (uint32_t i : IterateBitSet(GetColorAttachmentMask())) {
-                auto& attachmentInfo = GetColorAttachment(i);
-                TextureView* view = ToBackend(attachmentInfo.view.Get());
+                TextureView* view = ToBackend(GetColorAttachment(i).view.Get());
+                query.attachments[attachmentCount++] = view->GetHandle();
+            }
 
-                attachments[attachmentCount] = view->GetHandle();
+            if (HasDepthStencilAttachment()) {
+                TextureView* view = ToBackend(GetDepthStencilAttachment().view.Get());
+                query.attachments[attachmentCount++] = view->GetHandle();
+            }
 
-                clearValues[attachmentCount].color.float32[0] = attachmentInfo.clearColor[0];
-                clearValues[attachmentCount].color.float32[1] = attachmentInfo.clearColor[1];
-                clearValues[attachmentCount].color.float32[2] = attachmentInfo.clearColor[2];
-                clearValues[attachmentCount].color.float32[3] = attachmentInfo.clearColor[3];
+            query.attachmentCount = attachmentCount;
+            cached.framebuffer = mDevice->GetFramebufferCache()->GetFramebuffer(query);
+        }
 
-                attachmentCount++;
-            }
+        return cached;
+    }
 
-            if (HasDepthStencilAttachment()) {
-                auto& attachmentInfo = GetDepthStencilAttachment();
-                TextureView* view = ToBackend(attachmentInfo.view.Get());
+    void RenderPassDescriptor::RecordBeginRenderPass(VkCommandBuffer commands,
+                                                     const CachedObjects& cached) {
+        // Gather the clear values in the same order as the framebuffer attachments.
+        std::array<VkClearValue, kMaxColorAttachments + 1> clearValues;
+        uint32_t attachmentCount = 0;
 
-                attachments[attachmentCount] = view->GetHandle();
+        for (uint32_t i : IterateBitSet(GetColorAttachmentMask())) {
+            auto& attachmentInfo = GetColorAttachment(i);
 
-                clearValues[attachmentCount].depthStencil.depth = attachmentInfo.clearDepth;
-                clearValues[attachmentCount].depthStencil.stencil = attachmentInfo.clearStencil;
+            clearValues[attachmentCount].color.float32[0] = attachmentInfo.clearColor[0];
+            clearValues[attachmentCount].color.float32[1] = attachmentInfo.clearColor[1];
+            clearValues[attachmentCount].color.float32[2] = attachmentInfo.clearColor[2];
+            clearValues[attachmentCount].color.float32[3] = attachmentInfo.clearColor[3];
 
-                attachmentCount++;
-            }
+            attachmentCount++;
+        }
 
-            // Chain attachments and create the framebuffer
-            VkFramebufferCreateInfo createInfo;
-            createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-            createInfo.pNext = nullptr;
-            createInfo.flags = 0;
-            createInfo.renderPass = renderPass;
-            createInfo.attachmentCount = attachmentCount;
-            createInfo.pAttachments = attachments.data();
-            createInfo.width = GetWidth();
-            createInfo.height = GetHeight();
-            createInfo.layers = 1;
-
-            if (mDevice->fn.CreateFramebuffer(mDevice->GetVkDevice(), &createInfo, nullptr,
-                                              &framebuffer) != VK_SUCCESS) {
-                ASSERT(false);
-            }
+        if (HasDepthStencilAttachment()) {
+            auto& attachmentInfo = GetDepthStencilAttachment();
+
+            clearValues[attachmentCount].depthStencil.depth = attachmentInfo.clearDepth;
+            clearValues[attachmentCount].depthStencil.stencil = attachmentInfo.clearStencil;
 
-            // We don't reuse VkFramebuffers so mark the framebuffer for deletion as soon as the
-            // commands currently being recorded are finished.
-            mDevice->GetFencedDeleter()->DeleteWhenUnused(framebuffer);
+            attachmentCount++;
         }
 
         VkRenderPassBeginInfo beginInfo;
         beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         beginInfo.pNext = nullptr;
-        beginInfo.renderPass = renderPass;
-        beginInfo.framebuffer = framebuffer;
+        beginInfo.renderPass = cached.renderPass;
+        beginInfo.framebuffer = cached.framebuffer;
         beginInfo.renderArea.offset.x = 0;
         beginInfo.renderArea.offset.y = 0;
         beginInfo.renderArea.extent.width = GetWidth();
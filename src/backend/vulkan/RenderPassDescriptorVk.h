@@ -27,8 +27,16 @@ namespace backend { namespace vulkan {
       public:
         RenderPassDescriptor(RenderPassDescriptorBuilder* builder);
 
-        // Compute all the arguments for, and record the vkCmdBeginRenderPass command.
-        void RecordBeginRenderPass(VkCommandBuffer commands);
+        // The objects from the device caches used to begin the render pass. The caches aren't
+        // thread-safe so they are queried before recording.
+        struct CachedObjects {
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        };
+        CachedObjects QueryCachedObjects();
+
+        // Compute the rest of the arguments for, and record the vkCmdBeginRenderPass command.
+        void RecordBeginRenderPass(VkCommandBuffer commands, const CachedObjects& cached);
 
       private:
         Device* mDevice = nullptr;
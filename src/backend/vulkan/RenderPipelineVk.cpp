@@ -18,11 +18,17 @@
 #include "backend/vulkan/DepthStencilStateVk.h"
 #include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/InputStateVk.h"
+#include "backend/vulkan/PipelineCache.h"
 #include "backend/vulkan/PipelineLayoutVk.h"
 #include "backend/vulkan/RenderPassCache.h"
 #include "backend/vulkan/RenderPassDescriptorVk.h"
 #include "backend/vulkan/ShaderModuleVk.h"
 #include "backend/vulkan/VulkanBackend.h"
+#include "common/Trace.h"
+#include "common/WorkerPool.h"
+
+#include <memory>
+#include <string>
 
 namespace backend { namespace vulkan {
 
@@ -45,6 +51,24 @@ namespace backend { namespace vulkan {
             }
         }
 
+        // Holds all the structures chained in the VkGraphicsPipelineCreateInfo so that they stay
+        // alive while the pipeline is compiled on a worker thread.
+        struct GraphicsPipelineCreateData {
+            std::string entryPoints[2];
+            VkPipelineShaderStageCreateInfo shaderStages[2];
+            VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+            VkViewport viewportDesc;
+            VkRect2D scissorRect;
+            VkPipelineViewportStateCreateInfo viewport;
+            VkPipelineRasterizationStateCreateInfo rasterization;
+            VkPipelineMultisampleStateCreateInfo multisample;
+            std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments>
+                colorBlendAttachments;
+            VkPipelineColorBlendStateCreateInfo colorBlend;
+            VkPipelineDynamicStateCreateInfo dynamic;
+            VkGraphicsPipelineCreateInfo createInfo;
+        };
+
     }  // anonymous namespace
 
     RenderPipeline::RenderPipeline(RenderPipelineBuilder* builder)
@@ -52,18 +76,25 @@ namespace backend { namespace vulkan {
         // Eventually a bunch of the structures that need to be chained in the create info will be
         // held by objects such as the BlendState. They aren't implemented yet so we initialize
         // everything here.
+        auto data = std::make_shared<GraphicsPipelineCreateData>();
 
-        VkPipelineShaderStageCreateInfo shaderStages[2];
+        auto& shaderStages = data->shaderStages;
         {
             const auto& vertexStageInfo = builder->GetStageInfo(nxt::ShaderStage::Vertex);
             const auto& fragmentStageInfo = builder->GetStageInfo(nxt::ShaderStage::Fragment);
 
+            // The shader modules must stay alive until the pipeline is compiled.
+            mModules[0] = vertexStageInfo.module;
+            mModules[1] = fragmentStageInfo.module;
+            data->entryPoints[0] = vertexStageInfo.entryPoint;
+            data->entryPoints[1] = fragmentStageInfo.entryPoint;
+
             shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
             shaderStages[0].pNext = nullptr;
             shaderStages[0].flags = 0;
             shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
             shaderStages[0].module = ToBackend(vertexStageInfo.module)->GetHandle();
-            shaderStages[0].pName = vertexStageInfo.entryPoint.c_str();
+            shaderStages[0].pName = data->entryPoints[0].c_str();
             shaderStages[0].pSpecializationInfo = nullptr;
 
             shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -71,11 +102,11 @@ namespace backend { namespace vulkan {
             shaderStages[1].flags = 0;
             shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
             shaderStages[1].module = ToBackend(fragmentStageInfo.module)->GetHandle();
-            shaderStages[1].pName = fragmentStageInfo.entryPoint.c_str();
+            shaderStages[1].pName = data->entryPoints[1].c_str();
             shaderStages[1].pSpecializationInfo = nullptr;
         }
 
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+        VkPipelineInputAssemblyStateCreateInfo& inputAssembly = data->inputAssembly;
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         inputAssembly.pNext = nullptr;
         inputAssembly.flags = 0;
@@ -85,19 +116,19 @@ namespace backend { namespace vulkan {
 
         // A dummy viewport/scissor info. The validation layers force use to provide at least one
         // scissor and one viewport here, even if we choose to make them dynamic.
-        VkViewport viewportDesc;
+        VkViewport& viewportDesc = data->viewportDesc;
         viewportDesc.x = 0.0f;
         viewportDesc.y = 0.0f;
         viewportDesc.width = 1.0f;
         viewportDesc.height = 1.0f;
         viewportDesc.minDepth = 0.0f;
         viewportDesc.maxDepth = 1.0f;
-        VkRect2D scissorRect;
+        VkRect2D& scissorRect = data->scissorRect;
         scissorRect.offset.x = 0;
         scissorRect.offset.y = 0;
         scissorRect.extent.width = 1;
         scissorRect.extent.height = 1;
-        VkPipelineViewportStateCreateInfo viewport;
+        VkPipelineViewportStateCreateInfo& viewport = data->viewport;
         viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         viewport.pNext = nullptr;
         viewport.flags = 0;
@@ -106,7 +137,7 @@ namespace backend { namespace vulkan {
         viewport.scissorCount = 1;
         viewport.pScissors = &scissorRect;
 
-        VkPipelineRasterizationStateCreateInfo rasterization;
+        VkPipelineRasterizationStateCreateInfo& rasterization = data->rasterization;
         rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
         rasterization.pNext = nullptr;
         rasterization.flags = 0;
@@ -121,7 +152,7 @@ namespace backend { namespace vulkan {
         rasterization.depthBiasSlopeFactor = 0.0f;
         rasterization.lineWidth = 1.0f;
 
-        VkPipelineMultisampleStateCreateInfo multisample;
+        VkPipelineMultisampleStateCreateInfo& multisample = data->multisample;
         multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         multisample.pNext = nullptr;
         multisample.flags = 0;
@@ -134,11 +165,11 @@ namespace backend { namespace vulkan {
 
         // Initialize the "blend state info" that will be chained in the "create info" from the data
         // pre-computed in the BlendState
-        std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments> colorBlendAttachments;
+        auto& colorBlendAttachments = data->colorBlendAttachments;
         for (uint32_t i : IterateBitSet(GetColorAttachmentsMask())) {
             colorBlendAttachments[i] = ToBackend(GetBlendState(i))->GetState();
         }
-        VkPipelineColorBlendStateCreateInfo colorBlend;
+        VkPipelineColorBlendStateCreateInfo& colorBlend = data->colorBlend;
         colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlend.pNext = nullptr;
         colorBlend.flags = 0;
@@ -155,7 +186,7 @@ namespace backend { namespace vulkan {
         colorBlend.blendConstants[3] = 0.0f;
 
         // Tag all state as dynamic but stencil masks.
-        VkDynamicState dynamicStates[] = {
+        static const VkDynamicState dynamicStates[] = {
             VK_DYNAMIC_STATE_VIEWPORT,
             VK_DYNAMIC_STATE_SCISSOR,
             VK_DYNAMIC_STATE_LINE_WIDTH,
@@ -164,7 +195,7 @@ namespace backend { namespace vulkan {
             VK_DYNAMIC_STATE_DEPTH_BOUNDS,
             VK_DYNAMIC_STATE_STENCIL_REFERENCE,
         };
-        VkPipelineDynamicStateCreateInfo dynamic;
+        VkPipelineDynamicStateCreateInfo& dynamic = data->dynamic;
         dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
         dynamic.pNext = nullptr;
         dynamic.flags = 0;
@@ -191,7 +222,7 @@ namespace backend { namespace vulkan {
 
         // The create info chains in a bunch of things created on the stack here or inside state
         // objects.
-        VkGraphicsPipelineCreateInfo createInfo;
+        VkGraphicsPipelineCreateInfo& createInfo = data->createInfo;
         createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         createInfo.pNext = nullptr;
         createInfo.flags = 0;
@@ -212,21 +243,43 @@ namespace backend { namespace vulkan {
         createInfo.basePipelineHandle = VK_NULL_HANDLE;
         createInfo.basePipelineIndex = -1;
 
-        if (mDevice->fn.CreateGraphicsPipelines(mDevice->GetVkDevice(), VK_NULL_HANDLE, 1,
-                                                &createInfo, nullptr, &mHandle) != VK_SUCCESS) {
-            ASSERT(false);
+        auto compile = [this, data]() {
+            NXT_TRACE_SCOPE("vkCreateGraphicsPipelines");
+            VkPipelineCache cache = mDevice->GetPipelineCache()->GetHandle();
+            if (mDevice->fn.CreateGraphicsPipelines(mDevice->GetVkDevice(), cache, 1,
+                                                    &data->createInfo, nullptr,
+                                                    &mHandle) != VK_SUCCESS) {
+                ASSERT(false);
+            }
+        };
+
+        WorkerPool* pool = mDevice->GetPipelineCompilationPool();
+        if (pool != nullptr) {
+            mCompilation = pool->PostTask(compile);
+        } else {
+            compile();
+            mModules = {};
         }
     }
 
     RenderPipeline::~RenderPipeline() {
+        WaitForCompilation();
         if (mHandle != VK_NULL_HANDLE) {
             mDevice->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
     }
 
-    VkPipeline RenderPipeline::GetHandle() const {
+    VkPipeline RenderPipeline::GetHandle() {
+        WaitForCompilation();
         return mHandle;
     }
 
+    void RenderPipeline::WaitForCompilation() {
+        if (mCompilation.valid()) {
+            mCompilation.get();
+            mModules = {};
+        }
+    }
+
 }}  // namespace backend::vulkan
@@ -19,6 +19,9 @@
 
 #include "common/vulkan_platform.h"
 
+#include <array>
+#include <future>
+
 namespace backend { namespace vulkan {
 
     class Device;
@@ -28,11 +31,17 @@ namespace backend { namespace vulkan {
         RenderPipeline(RenderPipelineBuilder* builder);
         ~RenderPipeline();
 
-        VkPipeline GetHandle() const;
+        // Waits for the pipeline to be compiled if it is compiled asynchronously.
+        VkPipeline GetHandle();
 
       private:
+        void WaitForCompilation();
+
         VkPipeline mHandle = VK_NULL_HANDLE;
         Device* mDevice = nullptr;
+
+        std::future<void> mCompilation;
+        std::array<Ref<ShaderModuleBase>, 2> mModules;
     };
 
 }}  // namespace backend::vulkan
@@ -15,6 +15,7 @@
 #include "backend/vulkan/TextureVk.h"
 
 #include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/FramebufferCache.h"
 #include "backend/vulkan/VulkanBackend.h"
 
 namespace backend { namespace vulkan {
@@ -312,32 +313,55 @@ namespace backend { namespace vulkan {
         return VulkanAspectMask(GetFormat());
     }
 
-    // Helper function to add a texture barrier to a command buffer. This is inefficient because we
-    // should be coalescing barriers as much as possible.
-    void Texture::RecordBarrier(VkCommandBuffer commands,
-                                nxt::TextureUsageBit currentUsage,
-                                nxt::TextureUsageBit targetUsage) const {
+    bool Texture::ComputeBarrier(nxt::TextureUsageBit currentUsage,
+                                 nxt::TextureUsageBit targetUsage,
+                                 VkPipelineStageFlags* srcStages,
+                                 VkPipelineStageFlags* dstStages,
+                                 VkImageMemoryBarrier* barrier) const {
         nxt::TextureFormat format = GetFormat();
-        VkPipelineStageFlags srcStages = VulkanPipelineStage(currentUsage, format);
-        VkPipelineStageFlags dstStages = VulkanPipelineStage(targetUsage, format);
+        VkImageLayout oldLayout = VulkanImageLayout(currentUsage, format);
+        VkImageLayout newLayout = VulkanImageLayout(targetUsage, format);
+
+        // Reads don't need to be synchronized with each other, unless the layout changes.
+        nxt::TextureUsageBit writableUsages = nxt::TextureUsageBit::TransferDst |
+                                              nxt::TextureUsageBit::Storage |
+                                              nxt::TextureUsageBit::OutputAttachment;
+        if (oldLayout == newLayout && !((currentUsage | targetUsage) & writableUsages)) {
+            return false;
+        }
 
-        VkImageMemoryBarrier barrier;
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.pNext = nullptr;
-        barrier.srcAccessMask = VulkanAccessFlags(currentUsage, format);
-        barrier.dstAccessMask = VulkanAccessFlags(targetUsage, format);
-        barrier.oldLayout = VulkanImageLayout(currentUsage, format);
-        barrier.newLayout = VulkanImageLayout(targetUsage, format);
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = mHandle;
+        *srcStages |= VulkanPipelineStage(currentUsage, format);
+        *dstStages |= VulkanPipelineStage(targetUsage, format);
+
+        barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier->pNext = nullptr;
+        barrier->srcAccessMask = VulkanAccessFlags(currentUsage, format);
+        barrier->dstAccessMask = VulkanAccessFlags(targetUsage, format);
+        barrier->oldLayout = oldLayout;
+        barrier->newLayout = newLayout;
+        barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier->image = mHandle;
         // This transitions the whole resource but assumes it is a 2D texture
         ASSERT(GetDimension() == nxt::TextureDimension::e2D);
-        barrier.subresourceRange.aspectMask = VulkanAspectMask(format);
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = GetNumMipLevels();
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
+        barrier->subresourceRange.aspectMask = VulkanAspectMask(format);
+        barrier->subresourceRange.baseMipLevel = 0;
+        barrier->subresourceRange.levelCount = GetNumMipLevels();
+        barrier->subresourceRange.baseArrayLayer = 0;
+        barrier->subresourceRange.layerCount = 1;
+
+        return true;
+    }
+
+    void Texture::RecordBarrier(VkCommandBuffer commands,
+                                nxt::TextureUsageBit currentUsage,
+                                nxt::TextureUsageBit targetUsage) const {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        VkImageMemoryBarrier barrier;
+        if (!ComputeBarrier(currentUsage, targetUsage, &srcStages, &dstStages, &barrier)) {
+            return;
+        }
 
         ToBackend(GetDevice())
             ->fn.CmdPipelineBarrier(commands, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1,
@@ -378,6 +402,7 @@ namespace backend { namespace vulkan {
         Device* device = ToBackend(GetTexture()->GetDevice());
 
         if (mHandle != VK_NULL_HANDLE) {
+            device->GetFramebufferCache()->OnImageViewDestroyed(mHandle);
             device->GetFencedDeleter()->DeleteWhenUnused(mHandle);
             mHandle = VK_NULL_HANDLE;
         }
@@ -34,6 +34,14 @@ namespace backend { namespace vulkan {
         VkImage GetHandle() const;
         VkImageAspectFlags GetVkAspectMask() const;
 
+        // Computes the barrier transitioning the texture from currentUsage to targetUsage and adds
+        // the stages it synchronizes to srcStages and dstStages. Returns false if no barrier is
+        // needed, for example between two read-only usages using the same layout.
+        bool ComputeBarrier(nxt::TextureUsageBit currentUsage,
+                            nxt::TextureUsageBit targetUsage,
+                            VkPipelineStageFlags* srcStages,
+                            VkPipelineStageFlags* dstStages,
+                            VkImageMemoryBarrier* barrier) const;
         void RecordBarrier(VkCommandBuffer commands,
                            nxt::TextureUsageBit currentUsage,
                            nxt::TextureUsageBit targetUsage) const;
@@ -15,6 +15,7 @@
 #include "backend/vulkan/VulkanBackend.h"
 
 #include "backend/Commands.h"
+#include "backend/ProcProfiler.h"
 #include "backend/vulkan/BindGroupLayoutVk.h"
 #include "backend/vulkan/BindGroupVk.h"
 #include "backend/vulkan/BlendStateVk.h"
@@ -24,8 +25,11 @@
 #include "backend/vulkan/ComputePipelineVk.h"
 #include "backend/vulkan/DepthStencilStateVk.h"
 #include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/FramebufferCache.h"
 #include "backend/vulkan/InputStateVk.h"
+#include "backend/vulkan/MemoryAllocator.h"
 #include "backend/vulkan/NativeSwapChainImplVk.h"
+#include "backend/vulkan/PipelineCache.h"
 #include "backend/vulkan/PipelineLayoutVk.h"
 #include "backend/vulkan/RenderPassCache.h"
 #include "backend/vulkan/RenderPassDescriptorVk.h"
@@ -36,6 +40,8 @@
 #include "backend/vulkan/TextureVk.h"
 #include "common/Platform.h"
 #include "common/SwapChainUtils.h"
+#include "common/Trace.h"
+#include "common/WorkerPool.h"
 
 #include <spirv-cross/spirv_cross.hpp>
 
@@ -53,11 +59,12 @@ namespace backend { namespace vulkan {
 
     nxtProcTable GetNonValidatingProcs();
     nxtProcTable GetValidatingProcs();
+    nxtProcTable GetProfilingProcs();
 
     void Init(nxtProcTable* procs,
               nxtDevice* device,
               const std::vector<const char*>& requiredInstanceExtensions) {
-        *procs = GetValidatingProcs();
+        *procs = IsProcProfilingEnabled() ? GetProfilingProcs() : GetValidatingProcs();
         *device = reinterpret_cast<nxtDevice>(new Device(requiredInstanceExtensions));
     }
 
@@ -66,6 +73,85 @@ namespace backend { namespace vulkan {
         return backendDevice->GetInstance();
     }
 
+    void SetPipelineCachePath(nxtDevice device, const char* path) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        backendDevice->SetPipelineCachePath(path);
+    }
+
+    void SetAsyncPipelineCompilation(nxtDevice device, bool enabled) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        backendDevice->SetAsyncPipelineCompilation(enabled);
+    }
+
+    void SetParallelCommandRecording(nxtDevice device, bool enabled) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        backendDevice->SetParallelCommandRecording(enabled);
+    }
+
+    bool SetSubmitCoalescing(nxtDevice device,
+                             bool enabled,
+                             uint32_t uploadCount,
+                             uint64_t uploadBytes) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        return backendDevice->SetSubmitCoalescing(enabled, uploadCount, uploadBytes);
+    }
+
+    void GetSubmitCounts(nxtDevice device, uint64_t* total, uint64_t* lastFrame) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *total = backendDevice->GetSubmitCount();
+        *lastFrame = backendDevice->GetSubmitCountLastFrame();
+    }
+
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *lastSubmitted = backendDevice->GetLastSubmittedSerial();
+        *completed = backendDevice->GetCompletedSerial();
+    }
+
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        return backendDevice->WaitForSerial(serial, timeoutNs);
+    }
+
+    bool GetMemoryHeapStats(nxtDevice device,
+                            uint32_t heapIndex,
+                            uint64_t* allocatedBytes,
+                            uint64_t* usedBytes,
+                            float* fragmentation) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        if (heapIndex >= backendDevice->GetDeviceInfo().memoryHeaps.size()) {
+            return false;
+        }
+
+        MemoryAllocator::HeapStats stats =
+            backendDevice->GetMemoryAllocator()->GetHeapStats(heapIndex);
+        *allocatedBytes = stats.allocatedBytes;
+        *usedBytes = stats.usedBytes;
+        *fragmentation = stats.fragmentation;
+        return true;
+    }
+
+    void GetFramebufferCacheCounts(nxtDevice device, uint64_t* hits, uint64_t* misses) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *hits = backendDevice->GetFramebufferCache()->GetHitCount();
+        *misses = backendDevice->GetFramebufferCache()->GetMissCount();
+    }
+
+    void GetRenderPassCacheCounts(nxtDevice device,
+                                  uint64_t* hits,
+                                  uint64_t* misses,
+                                  uint64_t* evictions) {
+        Device* backendDevice = reinterpret_cast<Device*>(device);
+        *hits = backendDevice->GetRenderPassCache()->GetHitCount();
+        *misses = backendDevice->GetRenderPassCache()->GetMissCount();
+        *evictions = backendDevice->GetRenderPassCache()->GetEvictionCount();
+    }
+
+    uint32_t GetPipelineBarrierCount(nxtCommandBuffer commandBuffer) {
+        CommandBuffer* backendCommandBuffer = reinterpret_cast<CommandBuffer*>(commandBuffer);
+        return backendCommandBuffer->GetPipelineBarrierCount();
+    }
+
     nxtSwapChainImplementation CreateNativeSwapChainImpl(nxtDevice device, VkSurfaceKHR surface) {
         Device* backendDevice = reinterpret_cast<Device*>(device);
         return CreateSwapChainImplementation(new NativeSwapChainImpl(backendDevice, surface));
@@ -144,14 +230,30 @@ namespace backend { namespace vulkan {
 
         mBufferUploader = new BufferUploader(this);
         mDeleter = new FencedDeleter(this);
+        mFramebufferCache = new FramebufferCache(this);
         mMapRequestTracker = new MapRequestTracker(this);
         mMemoryAllocator = new MemoryAllocator(this);
+        mPipelineCache = new PipelineCache(this);
         mRenderPassCache = new RenderPassCache(this);
+
+        // Create the render passes most applications use now instead of during the first frames.
+        mRenderPassCache->Prewarm(GetCommonRenderPassQueries());
     }
 
     Device::~Device() {
+        // All pipelines are destroyed and waited on their compilation so the pool is idle.
+        delete mPipelineCompilationPool;
+        mPipelineCompilationPool = nullptr;
+
+        // Queue::Submit waits for its recordings so the pool is idle.
+        delete mCommandRecordingPool;
+        mCommandRecordingPool = nullptr;
+
         // Immediately forget about all pending commands so we don't try to submit them in Tick
-        FreeCommands(&mPendingCommands);
+        for (auto& commands : mPendingCommands) {
+            FreeCommands(&commands);
+        }
+        mPendingCommands.clear();
 
         if (fn.QueueWaitIdle(mQueue) != VK_SUCCESS) {
             ASSERT(false);
@@ -178,8 +280,16 @@ namespace backend { namespace vulkan {
         }
         mUnusedFences.clear();
 
+        // All the texture views are dead so the framebuffer cache is empty, each of them evicted
+        // the framebuffers referencing it.
+        delete mFramebufferCache;
+        mFramebufferCache = nullptr;
+
+        // The uploader releases its staging ring through the deleter, all commands are complete so
+        // it can be deleted immediately.
         delete mBufferUploader;
         mBufferUploader = nullptr;
+        mDeleter->Tick(mCompletedSerial);
 
         delete mDeleter;
         mDeleter = nullptr;
@@ -190,6 +300,12 @@ namespace backend { namespace vulkan {
         delete mMemoryAllocator;
         mMemoryAllocator = nullptr;
 
+        if (!mPipelineCachePath.empty()) {
+            mPipelineCache->StoreToFile(mPipelineCachePath);
+        }
+        delete mPipelineCache;
+        mPipelineCache = nullptr;
+
         // The VkRenderPasses in the cache can be destroyed immediately since all commands referring
         // to them are guaranteed to be finished executing.
         delete mRenderPassCache;
@@ -275,12 +391,16 @@ namespace backend { namespace vulkan {
 
         mMapRequestTracker->Tick(mCompletedSerial);
         mBufferUploader->Tick(mCompletedSerial);
-        mMemoryAllocator->Tick(mCompletedSerial);
 
+        // Resources are deleted before the memory freed on the same serial can be reused, because
+        // memory must not be released while a resource is still bound to it.
         mDeleter->Tick(mCompletedSerial);
+        mMemoryAllocator->Tick(mCompletedSerial);
 
-        if (mPendingCommands.pool != VK_NULL_HANDLE) {
-            SubmitPendingCommands();
+        if (!mPendingCommands.empty()) {
+            if (ShouldSubmitOnTick()) {
+                SubmitPendingCommands();
+            }
         } else if (mCompletedSerial == mNextSerial - 1) {
             // If there's no GPU work in flight we still need to artificially increment the serial
             // so that CPU operations waiting on GPU completion can know they don't have to wait.
@@ -329,6 +449,14 @@ namespace backend { namespace vulkan {
         return mDeleter;
     }
 
+    FramebufferCache* Device::GetFramebufferCache() const {
+        return mFramebufferCache;
+    }
+
+    PipelineCache* Device::GetPipelineCache() const {
+        return mPipelineCache;
+    }
+
     RenderPassCache* Device::GetRenderPassCache() const {
         return mRenderPassCache;
     }
@@ -337,44 +465,90 @@ namespace backend { namespace vulkan {
         return mNextSerial;
     }
 
-    VkCommandBuffer Device::GetPendingCommandBuffer() {
-        if (mPendingCommands.pool == VK_NULL_HANDLE) {
-            mPendingCommands = GetUnusedCommands();
+    Serial Device::GetLastSubmittedSerial() const {
+        return mNextSerial - 1;
+    }
 
-            VkCommandBufferBeginInfo beginInfo;
-            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            beginInfo.pNext = nullptr;
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            beginInfo.pInheritanceInfo = nullptr;
+    Serial Device::GetCompletedSerial() const {
+        return mCompletedSerial;
+    }
 
-            if (fn.BeginCommandBuffer(mPendingCommands.commandBuffer, &beginInfo) != VK_SUCCESS) {
-                ASSERT(false);
+    bool Device::WaitForSerial(Serial serial, uint64_t timeoutNs) {
+        CheckPassedFences();
+        if (serial <= mCompletedSerial) {
+            return true;
+        }
+
+        // Waiting on the pending serial requires its commands to be submitted first.
+        if (serial == mNextSerial && !mPendingCommands.empty()) {
+            SubmitPendingCommands();
+        }
+
+        // Fences are in serial order so the first one at or after serial covers its work.
+        for (const auto& fenceAndSerial : mFencesInFlight) {
+            if (fenceAndSerial.second < serial) {
+                continue;
             }
+
+            VkResult result =
+                fn.WaitForFences(mVkDevice, 1, &fenceAndSerial.first, VK_TRUE, timeoutNs);
+            ASSERT(result == VK_SUCCESS || result == VK_TIMEOUT);
+            break;
+        }
+
+        CheckPassedFences();
+        return serial <= mCompletedSerial;
+    }
+
+    VkCommandBuffer Device::GetPendingCommandBuffer() {
+        if (mPendingCommands.empty()) {
+            return GetNewPendingCommandBuffer();
         }
 
-        return mPendingCommands.commandBuffer;
+        return mPendingCommands.back().commandBuffer;
+    }
+
+    VkCommandBuffer Device::GetNewPendingCommandBuffer() {
+        CommandPoolAndBuffer commands = GetUnusedCommands();
+
+        VkCommandBufferBeginInfo beginInfo;
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.pNext = nullptr;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = nullptr;
+
+        if (fn.BeginCommandBuffer(commands.commandBuffer, &beginInfo) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+
+        mPendingCommands.push_back(commands);
+        return commands.commandBuffer;
     }
 
     void Device::SubmitPendingCommands() {
-        if (mPendingCommands.pool == VK_NULL_HANDLE) {
+        if (mPendingCommands.empty()) {
             return;
         }
 
-        if (fn.EndCommandBuffer(mPendingCommands.commandBuffer) != VK_SUCCESS) {
-            ASSERT(false);
+        mSubmitCommandBuffers.clear();
+        for (const auto& commands : mPendingCommands) {
+            if (fn.EndCommandBuffer(commands.commandBuffer) != VK_SUCCESS) {
+                ASSERT(false);
+            }
+            mSubmitCommandBuffers.push_back(commands.commandBuffer);
         }
 
-        std::vector<VkPipelineStageFlags> dstStageMasks(mWaitSemaphores.size(),
-                                                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        mSubmitWaitDstStageMasks.assign(mWaitSemaphores.size(),
+                                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
         VkSubmitInfo submitInfo;
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.pNext = nullptr;
         submitInfo.waitSemaphoreCount = static_cast<uint32_t>(mWaitSemaphores.size());
         submitInfo.pWaitSemaphores = mWaitSemaphores.data();
-        submitInfo.pWaitDstStageMask = dstStageMasks.data();
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &mPendingCommands.commandBuffer;
+        submitInfo.pWaitDstStageMask = mSubmitWaitDstStageMasks.data();
+        submitInfo.commandBufferCount = static_cast<uint32_t>(mSubmitCommandBuffers.size());
+        submitInfo.pCommandBuffers = mSubmitCommandBuffers.data();
         submitInfo.signalSemaphoreCount = 0;
         submitInfo.pSignalSemaphores = 0;
 
@@ -382,19 +556,111 @@ namespace backend { namespace vulkan {
         if (fn.QueueSubmit(mQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
             ASSERT(false);
         }
+        mSubmitCount++;
 
-        mCommandsInFlight.Enqueue(mPendingCommands, mNextSerial);
-        mPendingCommands = CommandPoolAndBuffer();
-        mFencesInFlight.emplace(fence, mNextSerial);
+        for (const auto& commands : mPendingCommands) {
+            mCommandsInFlight.Enqueue(commands, mNextSerial);
+        }
+        mPendingCommands.clear();
+        mFencesInFlight.emplace_back(fence, mNextSerial);
 
         for (VkSemaphore semaphore : mWaitSemaphores) {
             mDeleter->DeleteWhenUnused(semaphore);
         }
         mWaitSemaphores.clear();
 
+        mSubmitRequested = false;
+        mPendingUploadCount = 0;
+        mPendingUploadBytes = 0;
+
         mNextSerial++;
     }
 
+    void Device::RequestSubmit() {
+        mSubmitRequested = true;
+    }
+
+    void Device::AddPendingUpload(uint64_t size) {
+        mPendingUploadCount++;
+        mPendingUploadBytes += size;
+    }
+
+    bool Device::SetSubmitCoalescing(bool enabled, uint32_t uploadCount, uint64_t uploadBytes) {
+        // Without any threshold Tick would never submit the uploads.
+        if (enabled && uploadCount == 0 && uploadBytes == 0) {
+            return false;
+        }
+
+        mCoalesceSubmits = enabled;
+        mCoalescedUploadCount = uploadCount;
+        mCoalescedUploadBytes = uploadBytes;
+        return true;
+    }
+
+    void Device::EndFrame() {
+        mSubmitCountLastFrame = mSubmitCount - mSubmitCountAtFrameStart;
+        mSubmitCountAtFrameStart = mSubmitCount;
+    }
+
+    uint64_t Device::GetSubmitCount() const {
+        return mSubmitCount;
+    }
+
+    uint64_t Device::GetSubmitCountLastFrame() const {
+        return mSubmitCountLastFrame;
+    }
+
+    bool Device::ShouldSubmitOnTick() const {
+        if (!mCoalesceSubmits || mSubmitRequested) {
+            return true;
+        }
+
+        return (mCoalescedUploadCount != 0 && mPendingUploadCount >= mCoalescedUploadCount) ||
+               (mCoalescedUploadBytes != 0 && mPendingUploadBytes >= mCoalescedUploadBytes);
+    }
+
+    void Device::SetPipelineCachePath(const std::string& path) {
+        // Merging in the pipeline cache requires that no pipeline is being compiled with it.
+        WaitForPipelineCompilations();
+
+        mPipelineCachePath = path;
+        mPipelineCache->LoadFromFile(path);
+    }
+
+    void Device::SetAsyncPipelineCompilation(bool enabled) {
+        if (enabled && mPipelineCompilationPool == nullptr) {
+            mPipelineCompilationPool = new WorkerPool();
+        } else if (!enabled && mPipelineCompilationPool != nullptr) {
+            // Pipelines waiting on their compilation keep futures that stay valid after the pool
+            // is destroyed because it runs the remaining tasks first.
+            delete mPipelineCompilationPool;
+            mPipelineCompilationPool = nullptr;
+        }
+    }
+
+    WorkerPool* Device::GetPipelineCompilationPool() const {
+        return mPipelineCompilationPool;
+    }
+
+    void Device::WaitForPipelineCompilations() {
+        if (mPipelineCompilationPool != nullptr) {
+            mPipelineCompilationPool->WaitIdle();
+        }
+    }
+
+    void Device::SetParallelCommandRecording(bool enabled) {
+        if (enabled && mCommandRecordingPool == nullptr) {
+            mCommandRecordingPool = new WorkerPool();
+        } else if (!enabled && mCommandRecordingPool != nullptr) {
+            delete mCommandRecordingPool;
+            mCommandRecordingPool = nullptr;
+        }
+    }
+
+    WorkerPool* Device::GetCommandRecordingPool() const {
+        return mCommandRecordingPool;
+    }
+
     void Device::AddWaitSemaphore(VkSemaphore semaphore) {
         mWaitSemaphores.push_back(semaphore);
     }
@@ -613,7 +879,7 @@ namespace backend { namespace vulkan {
             }
             mUnusedFences.push_back(fence);
 
-            mFencesInFlight.pop();
+            mFencesInFlight.pop_front();
 
             ASSERT(fenceSerial > mCompletedSerial);
             mCompletedSerial = fenceSerial;
@@ -683,11 +949,35 @@ namespace backend { namespace vulkan {
     }
 
     void Queue::Submit(uint32_t numCommands, CommandBuffer* const* commands) {
+        NXT_TRACE_SCOPE("Queue::Submit");
         Device* device = ToBackend(GetDevice());
 
-        VkCommandBuffer commandBuffer = device->GetPendingCommandBuffer();
+        // Choosing the usage transitions depends on the usages left by the previous command
+        // buffers, and the device caches aren't thread-safe, so this is resolved serially first.
+        mRecordingTargets.clear();
         for (uint32_t i = 0; i < numCommands; ++i) {
-            commands[i]->RecordCommands(commandBuffer);
+            commands[i]->PrepareRecording();
+            mRecordingTargets.push_back(device->GetNewPendingCommandBuffer());
+        }
+
+        // Then each command buffer only writes to its own VkCommandBuffer and VkCommandPool so
+        // they can be recorded concurrently. They are still submitted in order.
+        WorkerPool* pool = device->GetCommandRecordingPool();
+        if (pool == nullptr || numCommands == 1) {
+            for (uint32_t i = 0; i < numCommands; ++i) {
+                commands[i]->RecordCommands(mRecordingTargets[i]);
+            }
+        } else {
+            mRecordings.clear();
+            for (uint32_t i = 0; i < numCommands; ++i) {
+                CommandBuffer* commandBuffer = commands[i];
+                VkCommandBuffer target = mRecordingTargets[i];
+                mRecordings.push_back(pool->PostTask(
+                    [commandBuffer, target]() { commandBuffer->RecordCommands(target); }));
+            }
+            for (std::future<void>& recording : mRecordings) {
+                recording.get();
+            }
         }
 
         device->SubmitPendingCommands();
@@ -26,7 +26,12 @@
 #include "common/Serial.h"
 #include "common/SerialQueue.h"
 
-#include <queue>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+class WorkerPool;
 
 namespace backend { namespace vulkan {
 
@@ -52,8 +57,10 @@ namespace backend { namespace vulkan {
 
     class BufferUploader;
     class FencedDeleter;
+    class FramebufferCache;
     class MapRequestTracker;
     class MemoryAllocator;
+    class PipelineCache;
     class RenderPassCache;
 
     struct VulkanBackendTraits {
@@ -100,16 +107,57 @@ namespace backend { namespace vulkan {
 
         BufferUploader* GetBufferUploader() const;
         FencedDeleter* GetFencedDeleter() const;
+        FramebufferCache* GetFramebufferCache() const;
         MapRequestTracker* GetMapRequestTracker() const;
         MemoryAllocator* GetMemoryAllocator() const;
+        PipelineCache* GetPipelineCache() const;
         RenderPassCache* GetRenderPassCache() const;
 
         Serial GetSerial() const;
 
+        // Returns the last of the command buffers that will be submitted with the next submit,
+        // starting one if there are none.
         VkCommandBuffer GetPendingCommandBuffer();
+        // Starts a new command buffer that executes after the pending ones, it is returned by
+        // GetPendingCommandBuffer until the next submit or call to this function. Each NXT
+        // command buffer is recorded in its own VkCommandBuffer, allocated from its own
+        // VkCommandPool, so that they can be recorded concurrently.
+        VkCommandBuffer GetNewPendingCommandBuffer();
+        // Submits all the pending command buffers in a single vkQueueSubmit.
         void SubmitPendingCommands();
+        // Makes the next Tick submit the pending commands even when submits are coalesced, for
+        // operations that wait on the pending serial.
+        void RequestSubmit();
+        // Records that an upload of size bytes was added to the pending commands.
+        void AddPendingUpload(uint64_t size);
+
+        // By default Tick submits the pending commands every time. When coalescing, Tick only
+        // submits once uploadCount uploads or uploadBytes bytes of uploads are pending, a
+        // threshold of 0 being ignored. Queue submits, presents and requested submits still
+        // happen immediately or on the next Tick. Returns false and leaves the setting unchanged
+        // when enabling it with both thresholds at 0.
+        bool SetSubmitCoalescing(bool enabled, uint32_t uploadCount, uint64_t uploadBytes);
+
+        // Marks the end of a frame for the submit counters, called when presenting.
+        void EndFrame();
+        uint64_t GetSubmitCount() const;
+        uint64_t GetSubmitCountLastFrame() const;
         void AddWaitSemaphore(VkSemaphore semaphore);
 
+        // Loads the pipeline cache from path and saves it back there when the device is destroyed.
+        void SetPipelineCachePath(const std::string& path);
+
+        // When enabled, pipelines are compiled on a pool of worker threads and using them waits for
+        // their compilation. GetPipelineCompilationPool returns nullptr when disabled.
+        void SetAsyncPipelineCompilation(bool enabled);
+        WorkerPool* GetPipelineCompilationPool() const;
+        void WaitForPipelineCompilations();
+
+        // When enabled, Queue::Submit records its command buffers concurrently on a pool of
+        // worker threads. GetCommandRecordingPool returns nullptr when disabled.
+        void SetParallelCommandRecording(bool enabled);
+        WorkerPool* GetCommandRecordingPool() const;
+
         // NXT API
         BindGroupBase* CreateBindGroup(BindGroupBuilder* builder) override;
         BindGroupLayoutBase* CreateBindGroupLayout(BindGroupLayoutBuilder* builder) override;
@@ -132,6 +180,9 @@ namespace backend { namespace vulkan {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        Serial GetLastSubmittedSerial() const override;
+        Serial GetCompletedSerial() const override;
+        bool WaitForSerial(Serial serial, uint64_t timeoutNs) override;
 
       private:
         bool CreateInstance(VulkanGlobalKnobs* usedKnobs,
@@ -168,8 +219,13 @@ namespace backend { namespace vulkan {
 
         BufferUploader* mBufferUploader = nullptr;
         FencedDeleter* mDeleter = nullptr;
+        FramebufferCache* mFramebufferCache = nullptr;
         MapRequestTracker* mMapRequestTracker = nullptr;
         MemoryAllocator* mMemoryAllocator = nullptr;
+        PipelineCache* mPipelineCache = nullptr;
+        std::string mPipelineCachePath;
+        WorkerPool* mPipelineCompilationPool = nullptr;
+        WorkerPool* mCommandRecordingPool = nullptr;
         RenderPassCache* mRenderPassCache = nullptr;
 
         VkFence GetUnusedFence();
@@ -179,7 +235,7 @@ namespace backend { namespace vulkan {
         // This works only because we have a single queue. Each submit to a queue is associated
         // to a serial and a fence, such that when the fence is "ready" we know the operations
         // have finished.
-        std::queue<std::pair<VkFence, Serial>> mFencesInFlight;
+        std::deque<std::pair<VkFence, Serial>> mFencesInFlight;
         std::vector<VkFence> mUnusedFences;
         Serial mNextSerial = 1;
         Serial mCompletedSerial = 0;
@@ -195,8 +251,27 @@ namespace backend { namespace vulkan {
 
         SerialQueue<CommandPoolAndBuffer> mCommandsInFlight;
         std::vector<CommandPoolAndBuffer> mUnusedCommands;
-        CommandPoolAndBuffer mPendingCommands;
+        // Each pending command buffer has its own pool so that recording in one doesn't require
+        // synchronizing with the others.
+        std::vector<CommandPoolAndBuffer> mPendingCommands;
         std::vector<VkSemaphore> mWaitSemaphores;
+
+        bool ShouldSubmitOnTick() const;
+
+        // Kept between submits so that building a VkSubmitInfo doesn't allocate.
+        std::vector<VkCommandBuffer> mSubmitCommandBuffers;
+        std::vector<VkPipelineStageFlags> mSubmitWaitDstStageMasks;
+
+        bool mSubmitRequested = false;
+        bool mCoalesceSubmits = false;
+        uint32_t mCoalescedUploadCount = 0;
+        uint64_t mCoalescedUploadBytes = 0;
+        uint32_t mPendingUploadCount = 0;
+        uint64_t mPendingUploadBytes = 0;
+
+        uint64_t mSubmitCount = 0;
+        uint64_t mSubmitCountAtFrameStart = 0;
+        uint64_t mSubmitCountLastFrame = 0;
     };
 
     class Queue : public QueueBase {
@@ -206,6 +281,11 @@ namespace backend { namespace vulkan {
 
         // NXT API
         void Submit(uint32_t numCommands, CommandBuffer* const* commands);
+
+      private:
+        // Kept between submits so that recording doesn't allocate.
+        std::vector<VkCommandBuffer> mRecordingTargets;
+        std::vector<std::future<void>> mRecordings;
     };
 
 }}  // namespace backend::vulkan
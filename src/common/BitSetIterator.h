@@ -16,13 +16,19 @@
 #define COMMON_BITSETITERATOR_H_
 
 #include "common/Assert.h"
+#include "common/Compiler.h"
 #include "common/Math.h"
 
 #include <bitset>
+#include <cstdint>
 #include <limits>
 
-// This is ANGLE's BitSetIterator class with a customizable return type
-// TODO(cwallez@chromium.org): it could be optimized, in particular when N <= 64
+#if defined(NXT_COMPILER_MSVC)
+#    include <intrin.h>
+#endif
+
+// This is ANGLE's BitSetIterator class with a customizable return type, and a faster version for
+// bitsets that fit in a uint64_t, which are all the bitsets in NXT.
 
 template <typename T>
 T roundUp(const T value, const T alignment) {
@@ -30,8 +36,82 @@ T roundUp(const T value, const T alignment) {
     return temp - temp % alignment;
 }
 
+namespace detail {
+
+    // Returns the index of the lowest set bit, bits must not be 0. Defined inline, contrary to
+    // ScanForward, because it is used in the increment of the iterator.
+    inline uint32_t ScanForward64(uint64_t bits) {
+        NXT_ASSERT(bits != 0);
+#if defined(NXT_COMPILER_MSVC)
+        unsigned long firstBitIndex = 0ul;
+#    if defined(_WIN64)
+        _BitScanForward64(&firstBitIndex, bits);
+#    else
+        if (!_BitScanForward(&firstBitIndex, static_cast<uint32_t>(bits))) {
+            _BitScanForward(&firstBitIndex, static_cast<uint32_t>(bits >> 32));
+            firstBitIndex += 32;
+        }
+#    endif
+        return firstBitIndex;
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+
+}  // namespace detail
+
+template <size_t N, typename T, bool kFitsInUint64 = (N <= 64)>
+class BitSetIterator;
+
+// Iterates over the set bits of a bitset of at most 64 bits by keeping them in a uint64_t. Each
+// step is a count trailing zeros to get the bit and a clear of the lowest set bit (BLSR on x86).
+template <size_t N, typename T>
+class BitSetIterator<N, T, true> final {
+  public:
+    BitSetIterator(const std::bitset<N>& bitset) : mBits(bitset.to_ullong()) {
+    }
+    // For masks that are already integers, bits at position N or higher must not be set.
+    constexpr BitSetIterator(uint64_t bits) : mBits(bits) {
+    }
+
+    class Iterator final {
+      public:
+        constexpr Iterator(uint64_t bits) : mBits(bits) {
+        }
+
+        Iterator& operator++() {
+            NXT_ASSERT(mBits != 0);
+            mBits &= mBits - 1;
+            return *this;
+        }
+
+        constexpr bool operator==(const Iterator& other) const {
+            return mBits == other.mBits;
+        }
+        constexpr bool operator!=(const Iterator& other) const {
+            return mBits != other.mBits;
+        }
+        T operator*() const {
+            return static_cast<T>(detail::ScanForward64(mBits));
+        }
+
+      private:
+        uint64_t mBits;
+    };
+
+    constexpr Iterator begin() const {
+        return Iterator(mBits);
+    }
+    constexpr Iterator end() const {
+        return Iterator(0);
+    }
+
+  private:
+    uint64_t mBits;
+};
+
 template <size_t N, typename T>
-class BitSetIterator final {
+class BitSetIterator<N, T, false> final {
   public:
     BitSetIterator(const std::bitset<N>& bitset);
     BitSetIterator(const BitSetIterator& other);
@@ -69,21 +149,21 @@ class BitSetIterator final {
 };
 
 template <size_t N, typename T>
-BitSetIterator<N, T>::BitSetIterator(const std::bitset<N>& bitset) : mBits(bitset) {
+BitSetIterator<N, T, false>::BitSetIterator(const std::bitset<N>& bitset) : mBits(bitset) {
 }
 
 template <size_t N, typename T>
-BitSetIterator<N, T>::BitSetIterator(const BitSetIterator& other) : mBits(other.mBits) {
+BitSetIterator<N, T, false>::BitSetIterator(const BitSetIterator& other) : mBits(other.mBits) {
 }
 
 template <size_t N, typename T>
-BitSetIterator<N, T>& BitSetIterator<N, T>::operator=(const BitSetIterator& other) {
+BitSetIterator<N, T, false>& BitSetIterator<N, T, false>::operator=(const BitSetIterator& other) {
     mBits = other.mBits;
     return *this;
 }
 
 template <size_t N, typename T>
-BitSetIterator<N, T>::Iterator::Iterator(const std::bitset<N>& bits)
+BitSetIterator<N, T, false>::Iterator::Iterator(const std::bitset<N>& bits)
     : mBits(bits), mCurrentBit(0), mOffset(0) {
     if (bits.any()) {
         mCurrentBit = getNextBit();
@@ -93,7 +173,8 @@ BitSetIterator<N, T>::Iterator::Iterator(const std::bitset<N>& bits)
 }
 
 template <size_t N, typename T>
-typename BitSetIterator<N, T>::Iterator& BitSetIterator<N, T>::Iterator::operator++() {
+typename BitSetIterator<N, T, false>::Iterator& BitSetIterator<N, T, false>::Iterator::
+operator++() {
     NXT_ASSERT(mBits.any());
     mBits.set(mCurrentBit - mOffset, 0);
     mCurrentBit = getNextBit();
@@ -101,17 +182,17 @@ typename BitSetIterator<N, T>::Iterator& BitSetIterator<N, T>::Iterator::operato
 }
 
 template <size_t N, typename T>
-bool BitSetIterator<N, T>::Iterator::operator==(const Iterator& other) const {
+bool BitSetIterator<N, T, false>::Iterator::operator==(const Iterator& other) const {
     return mOffset == other.mOffset && mBits == other.mBits;
 }
 
 template <size_t N, typename T>
-bool BitSetIterator<N, T>::Iterator::operator!=(const Iterator& other) const {
+bool BitSetIterator<N, T, false>::Iterator::operator!=(const Iterator& other) const {
     return !(*this == other);
 }
 
 template <size_t N, typename T>
-unsigned long BitSetIterator<N, T>::Iterator::getNextBit() {
+unsigned long BitSetIterator<N, T, false>::Iterator::getNextBit() {
     static std::bitset<N> wordMask(std::numeric_limits<uint32_t>::max());
 
     while (mOffset < N) {
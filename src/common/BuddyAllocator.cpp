@@ -0,0 +1,118 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/BuddyAllocator.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+
+#include <algorithm>
+
+constexpr uint64_t BuddyAllocator::kInvalidOffset;
+
+BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minAllocationSize)
+    : mSize(size), mMinAllocationSize(minAllocationSize) {
+    ASSERT(IsPowerOfTwo(size) && IsPowerOfTwo(minAllocationSize));
+    ASSERT(size >= minAllocationSize);
+
+    size_t maxOrder = 0;
+    while (OrderSize(maxOrder) < size) {
+        maxOrder++;
+    }
+
+    mFreeRanges.resize(maxOrder + 1);
+    mFreeRanges[maxOrder].insert(0);
+}
+
+uint64_t BuddyAllocator::Allocate(uint64_t size, uint64_t alignment) {
+    ASSERT(IsPowerOfTwo(alignment));
+
+    // Ranges are aligned on their size so the alignment is honored by allocating at least that.
+    uint64_t requiredSize = std::max(size, alignment);
+    if (requiredSize > mSize) {
+        return kInvalidOffset;
+    }
+
+    size_t order = 0;
+    while (OrderSize(order) < requiredSize) {
+        order++;
+    }
+
+    // Find the smallest free range that can contain the allocation.
+    size_t freeOrder = order;
+    while (freeOrder < mFreeRanges.size() && mFreeRanges[freeOrder].empty()) {
+        freeOrder++;
+    }
+    if (freeOrder == mFreeRanges.size()) {
+        return kInvalidOffset;
+    }
+
+    uint64_t offset = *mFreeRanges[freeOrder].begin();
+    mFreeRanges[freeOrder].erase(mFreeRanges[freeOrder].begin());
+
+    // Split it, putting the second halves back in the free lists, until it has the right size.
+    while (freeOrder > order) {
+        freeOrder--;
+        mFreeRanges[freeOrder].insert(offset + OrderSize(freeOrder));
+    }
+
+    mAllocatedOrders[offset] = order;
+    mUsedSize += OrderSize(order);
+    return offset;
+}
+
+void BuddyAllocator::Free(uint64_t offset) {
+    auto it = mAllocatedOrders.find(offset);
+    ASSERT(it != mAllocatedOrders.end());
+
+    size_t order = it->second;
+    mAllocatedOrders.erase(it);
+    mUsedSize -= OrderSize(order);
+
+    // Merge with the buddy for as long as it is free.
+    while (order + 1 < mFreeRanges.size()) {
+        uint64_t buddy = offset ^ OrderSize(order);
+        auto buddyIt = mFreeRanges[order].find(buddy);
+        if (buddyIt == mFreeRanges[order].end()) {
+            break;
+        }
+
+        mFreeRanges[order].erase(buddyIt);
+        offset = std::min(offset, buddy);
+        order++;
+    }
+
+    mFreeRanges[order].insert(offset);
+}
+
+uint64_t BuddyAllocator::GetSize() const {
+    return mSize;
+}
+
+uint64_t BuddyAllocator::GetUsedSize() const {
+    return mUsedSize;
+}
+
+uint64_t BuddyAllocator::GetLargestFreeRangeSize() const {
+    for (size_t order = mFreeRanges.size(); order > 0; --order) {
+        if (!mFreeRanges[order - 1].empty()) {
+            return OrderSize(order - 1);
+        }
+    }
+    return 0;
+}
+
+uint64_t BuddyAllocator::OrderSize(size_t order) const {
+    return mMinAllocationSize << order;
+}
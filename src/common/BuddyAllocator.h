@@ -0,0 +1,55 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_BUDDYALLOCATOR_H_
+#define COMMON_BUDDYALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+// Allocates ranges of a memory region of power-of-two size. Ranges are power-of-two sized and
+// aligned on their size, a free range is merged with its buddy (the other half of the range it was
+// split from) when the buddy is free too.
+class BuddyAllocator {
+  public:
+    static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+
+    // size and minAllocationSize must be powers of two, size >= minAllocationSize.
+    BuddyAllocator(uint64_t size, uint64_t minAllocationSize);
+
+    // Returns the offset of the range or kInvalidOffset if there is no space left. alignment must
+    // be a power of two.
+    uint64_t Allocate(uint64_t size, uint64_t alignment = 1);
+    void Free(uint64_t offset);
+
+    uint64_t GetSize() const;
+    uint64_t GetUsedSize() const;
+    uint64_t GetLargestFreeRangeSize() const;
+
+  private:
+    uint64_t OrderSize(size_t order) const;
+
+    uint64_t mSize;
+    uint64_t mMinAllocationSize;
+    uint64_t mUsedSize = 0;
+
+    // Offsets of the free ranges for each order, order N ranges are mMinAllocationSize << N bytes.
+    std::vector<std::set<uint64_t>> mFreeRanges;
+    std::map<uint64_t, size_t> mAllocatedOrders;
+};
+
+#endif  // COMMON_BUDDYALLOCATOR_H_
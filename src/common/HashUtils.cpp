@@ -0,0 +1,91 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/HashUtils.h"
+
+#include <cstring>
+
+namespace {
+
+    // Unaligned little endian reads, the hashes only need to be stable in a process so it is
+    // fine that big endian platforms compute different values.
+    uint64_t Read8(const uint8_t* data) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint64_t Read4(const uint8_t* data) {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+}  // anonymous namespace
+
+// This is the wyhash algorithm: the data is consumed 48 bytes at a time in three independent
+// lanes, then 16 bytes at a time, and the last 16 bytes (possibly overlapping the previous ones)
+// are mixed with the length.
+size_t HashBytes(const void* data, size_t size, size_t seed) {
+    using detail::HashMix;
+    using detail::HashMultiply;
+    using detail::kHashSecret0;
+    using detail::kHashSecret1;
+    using detail::kHashSecret2;
+    using detail::kHashSecret3;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t state = seed ^ HashMix(seed ^ kHashSecret0, kHashSecret1);
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    if (size <= 16) {
+        if (size >= 4) {
+            size_t middle = (size >> 3) << 2;
+            a = (Read4(bytes) << 32) | Read4(bytes + middle);
+            b = (Read4(bytes + size - 4) << 32) | Read4(bytes + size - 4 - middle);
+        } else if (size > 0) {
+            a = (static_cast<uint64_t>(bytes[0]) << 16) |
+                (static_cast<uint64_t>(bytes[size >> 1]) << 8) | bytes[size - 1];
+        }
+    } else {
+        size_t remaining = size;
+        if (remaining > 48) {
+            uint64_t state1 = state;
+            uint64_t state2 = state;
+            do {
+                state = HashMix(Read8(bytes) ^ kHashSecret1, Read8(bytes + 8) ^ state);
+                state1 = HashMix(Read8(bytes + 16) ^ kHashSecret2, Read8(bytes + 24) ^ state1);
+                state2 = HashMix(Read8(bytes + 32) ^ kHashSecret3, Read8(bytes + 40) ^ state2);
+                bytes += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            state ^= state1 ^ state2;
+        }
+
+        while (remaining > 16) {
+            state = HashMix(Read8(bytes) ^ kHashSecret1, Read8(bytes + 8) ^ state);
+            bytes += 16;
+            remaining -= 16;
+        }
+
+        a = Read8(bytes + remaining - 16);
+        b = Read8(bytes + remaining - 8);
+    }
+
+    a ^= kHashSecret1;
+    b ^= state;
+    HashMultiply(&a, &b);
+    return static_cast<size_t>(HashMix(a ^ kHashSecret0 ^ size, b ^ kHashSecret1));
+}
@@ -15,17 +15,132 @@
 #ifndef COMMON_HASHUTILS_H_
 #define COMMON_HASHUTILS_H_
 
+#include "common/Compiler.h"
 #include "common/Platform.h"
 
+#include <bitset>
+#include <cstdint>
 #include <functional>
+#include <type_traits>
 
-// Wrapper around std::hash to make it a templated function instead of a functor. It is marginally
-// nicer, and avoids adding to the std namespace to add hashing of other types.
+#if defined(NXT_COMPILER_MSVC) && defined(NXT_PLATFORM_64_BIT)
+#    include <intrin.h>
+#endif
+
+// The hashes are built on the multiply and fold mixing function of wyhash: the 128 bit product of
+// two 64 bit values is folded with a xor, so that each bit of the inputs affects all the bits of
+// the result. This is much better than std::hash, which is the identity for integers on most
+// standard libraries, when the hashes of masks or enums are used as unordered_set buckets.
+namespace detail {
+
+    constexpr uint64_t kHashSecret0 = 0xa0761d6478bd642full;
+    constexpr uint64_t kHashSecret1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t kHashSecret2 = 0x8ebc6af09c88c6e3ull;
+    constexpr uint64_t kHashSecret3 = 0x589965cc75374cc3ull;
+
+    // Computes the 128 bit product of a and b, storing the low bits in a and the high bits in b.
+    inline void HashMultiply(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(*a) * *b;
+        *a = static_cast<uint64_t>(product);
+        *b = static_cast<uint64_t>(product >> 64);
+#elif defined(NXT_COMPILER_MSVC) && defined(NXT_PLATFORM_64_BIT)
+        *a = _umul128(*a, *b, b);
+#else
+        uint64_t aHigh = *a >> 32;
+        uint64_t aLow = static_cast<uint32_t>(*a);
+        uint64_t bHigh = *b >> 32;
+        uint64_t bLow = static_cast<uint32_t>(*b);
+
+        uint64_t low = aLow * bLow;
+        uint64_t middle0 = aHigh * bLow;
+        uint64_t middle1 = aLow * bHigh;
+        uint64_t cross = (low >> 32) + static_cast<uint32_t>(middle0) + middle1;
+
+        *a = (cross << 32) | static_cast<uint32_t>(low);
+        *b = aHigh * bHigh + (middle0 >> 32) + (cross >> 32);
+#endif
+    }
+
+    inline uint64_t HashMix(uint64_t a, uint64_t b) {
+        HashMultiply(&a, &b);
+        return a ^ b;
+    }
+
+    inline size_t HashWord(uint64_t word) {
+        return static_cast<size_t>(HashMix(word ^ kHashSecret0, kHashSecret1));
+    }
+
+    // Integers, enums and pointers are hashed by mixing their value, other types use std::hash.
+    template <typename T>
+    using IsHashedAsWord = std::integral_constant<bool,
+                                                  std::is_integral<T>::value ||
+                                                      std::is_enum<T>::value ||
+                                                      std::is_pointer<T>::value>;
+
+    template <typename T>
+    uint64_t ToHashWord(const T& value, std::false_type /* isPointer */) {
+        return static_cast<uint64_t>(value);
+    }
+
+    template <typename T>
+    uint64_t ToHashWord(const T& value, std::true_type /* isPointer */) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+    }
+
+    template <typename T>
+    size_t HashValue(const T& value, std::true_type /* isHashedAsWord */) {
+        return HashWord(ToHashWord(value, std::is_pointer<T>()));
+    }
+
+    template <typename T>
+    size_t HashValue(const T& value, std::false_type /* isHashedAsWord */) {
+        return std::hash<T>()(value);
+    }
+
+    template <size_t N>
+    size_t HashBitSet(const std::bitset<N>& bits, std::true_type /* fitsInUint64 */) {
+        return HashWord(bits.to_ullong());
+    }
+
+    template <size_t N>
+    size_t HashBitSet(const std::bitset<N>& bits, std::false_type /* fitsInUint64 */) {
+        return HashWord(std::hash<std::bitset<N>>()(bits));
+    }
+
+}  // namespace detail
+
+// Wrapper around the hashing of values to make it a templated function instead of a functor. It
+// is marginally nicer, and avoids adding to the std namespace to add hashing of other types.
 template <typename T>
 size_t Hash(const T& value) {
-    return std::hash<T>()(value);
+    return detail::HashValue(value, detail::IsHashedAsWord<T>());
+}
+
+template <size_t N>
+size_t Hash(const std::bitset<N>& bits) {
+    return detail::HashBitSet(bits, std::integral_constant<bool, (N <= 64)>());
 }
 
+namespace detail {
+
+    // HashCombine mixes integers, enums and pointers directly instead of hashing them first.
+    template <typename T>
+    uint64_t CombinedWord(const T& value, std::true_type /* isHashedAsWord */) {
+        return ToHashWord(value, std::is_pointer<T>());
+    }
+
+    template <typename T>
+    uint64_t CombinedWord(const T& value, std::false_type /* isHashedAsWord */) {
+        return Hash(value);
+    }
+
+}  // namespace detail
+
+// Hashes size bytes starting at data, continuing the hash given as seed if any. Use it for
+// arrays of plain values instead of combining the hashes of the elements one by one.
+size_t HashBytes(const void* data, size_t size, size_t seed = 0);
+
 // When hashing sparse structures we want to iteratively build a hash value with only parts of the
 // data. HashCombine "hashes" together an existing hash and hashable values.
 //
@@ -36,14 +151,10 @@ size_t Hash(const T& value) {
 //    return hash;
 template <typename T>
 void HashCombine(size_t* hash, const T& value) {
-#if defined(NXT_PLATFORM_64_BIT)
-    const size_t offset = 0x9e3779b97f4a7c16;
-#elif defined(NXT_PLATFORM_32_BIT)
-    const size_t offset = 0x9e3779b9;
-#else
-#    error "Unsupported platform"
-#endif
-    *hash ^= Hash(value) + offset + (*hash << 6) + (*hash >> 2);
+    *hash = static_cast<size_t>(
+        detail::HashMix(*hash ^ detail::kHashSecret2,
+                        detail::CombinedWord(value, detail::IsHashedAsWord<T>()) ^
+                            detail::kHashSecret3));
 }
 
 template <typename T, typename... Args>
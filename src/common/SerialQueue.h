@@ -19,71 +19,61 @@
 #include "common/Serial.h"
 
 #include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 
+// A queue of values tagged with increasing serials, used to release objects once the GPU is done
+// with the serial they were last used in. Values are stored contiguously in a ring buffer and the
+// serials in a second ring buffer that records where the values of each serial end. Both rings
+// are indexed with monotonically increasing positions that are wrapped with a mask on access, and
+// grow by doubling so that in steady state enqueuing and clearing values don't allocate.
 template <typename T>
 class SerialQueue {
   private:
-    using SerialPair = std::pair<Serial, std::vector<T>>;
-    using Storage = std::vector<SerialPair>;
-    using StorageIterator = typename Storage::iterator;
-    using ConstStorageIterator = typename Storage::const_iterator;
-
-  public:
-    class Iterator {
+    template <typename U>
+    class IteratorBase {
       public:
-        Iterator(StorageIterator start);
-        Iterator& operator++();
+        IteratorBase(U* values, size_t mask, size_t position);
+        IteratorBase& operator++();
 
-        bool operator==(const Iterator& other) const;
-        bool operator!=(const Iterator& other) const;
-        T& operator*() const;
+        bool operator==(const IteratorBase& other) const;
+        bool operator!=(const IteratorBase& other) const;
+        U& operator*() const;
 
       private:
-        StorageIterator mStorageIterator;
-        // Special case the mSerialIterator when it should be equal to mStorageIterator.begin()
-        // otherwise we could ask mStorageIterator.begin() when mStorageIterator is mStorage.end()
-        // which is invalid. mStorageIterator.begin() is tagged with a nullptr.
-        T* mSerialIterator;
+        U* mValues;
+        size_t mMask;
+        size_t mPosition;
     };
 
-    class ConstIterator {
+    template <typename U>
+    class BeginEndBase {
       public:
-        ConstIterator(ConstStorageIterator start);
-        ConstIterator& operator++();
+        BeginEndBase(U* values, size_t mask, size_t start, size_t end);
 
-        bool operator==(const ConstIterator& other) const;
-        bool operator!=(const ConstIterator& other) const;
-        const T& operator*() const;
+        IteratorBase<U> begin() const;
+        IteratorBase<U> end() const;
 
       private:
-        ConstStorageIterator mStorageIterator;
-        const T* mSerialIterator;
+        U* mValues;
+        size_t mMask;
+        size_t mStart;
+        size_t mEnd;
     };
 
-    class BeginEnd {
-      public:
-        BeginEnd(StorageIterator start, StorageIterator end);
-
-        Iterator begin() const;
-        Iterator end() const;
-
-      private:
-        StorageIterator mStartIt;
-        StorageIterator mEndIt;
-    };
-
-    class ConstBeginEnd {
-      public:
-        ConstBeginEnd(ConstStorageIterator start, ConstStorageIterator end);
+  public:
+    using Iterator = IteratorBase<T>;
+    using ConstIterator = IteratorBase<const T>;
+    using BeginEnd = BeginEndBase<T>;
+    using ConstBeginEnd = BeginEndBase<const T>;
 
-        ConstIterator begin() const;
-        ConstIterator end() const;
+    SerialQueue() = default;
+    ~SerialQueue();
 
-      private:
-        ConstStorageIterator mStartIt;
-        ConstStorageIterator mEndIt;
-    };
+    SerialQueue(const SerialQueue& other) = delete;
+    SerialQueue& operator=(const SerialQueue& other) = delete;
 
     // The serial must be given in (not strictly) increasing order.
     void Enqueue(const T& value, Serial serial);
@@ -107,229 +97,248 @@ class SerialQueue {
     Serial FirstSerial() const;
 
   private:
-    // Returns the first StorageIterator that a serial bigger than serial.
-    ConstStorageIterator FindUpTo(Serial serial) const;
-    StorageIterator FindUpTo(Serial serial);
-    Storage mStorage;
+    // The values of serial are at the positions before end that are after the end of the
+    // previous serial.
+    struct SerialEnd {
+        Serial serial;
+        size_t end;
+    };
+
+    // Makes room for one more value and returns the position at which it must be constructed,
+    // also records the serial of the value.
+    size_t PrepareEnqueue(Serial serial);
+    void GrowValues();
+    void GrowSerials();
+
+    // Returns the position of the first value with a serial bigger than serial, and the position
+    // of its SerialEnd in serialPosition.
+    size_t FindUpTo(Serial serial, size_t* serialPosition) const;
+    // Destroys the values before the position end.
+    void DestroyValuesUpTo(size_t end);
+
+    T* mValues = nullptr;
+    size_t mValuesCapacity = 0;
+    size_t mValuesBegin = 0;
+    size_t mValuesEnd = 0;
+
+    std::vector<SerialEnd> mSerials;
+    size_t mSerialsBegin = 0;
+    size_t mSerialsEnd = 0;
 };
 
 // SerialQueue
 
 template <typename T>
-void SerialQueue<T>::Enqueue(const T& value, Serial serial) {
-    NXT_ASSERT(Empty() || mStorage.back().first <= serial);
-
-    if (Empty() || mStorage.back().first < serial) {
-        mStorage.emplace_back(SerialPair(serial, {}));
+SerialQueue<T>::~SerialQueue() {
+    Clear();
+    if (mValues != nullptr) {
+        std::allocator<T>().deallocate(mValues, mValuesCapacity);
     }
-    mStorage.back().second.emplace_back(value);
 }
 
 template <typename T>
-void SerialQueue<T>::Enqueue(T&& value, Serial serial) {
-    NXT_ASSERT(Empty() || mStorage.back().first <= serial);
+void SerialQueue<T>::Enqueue(const T& value, Serial serial) {
+    size_t position = PrepareEnqueue(serial);
+    new (&mValues[position & (mValuesCapacity - 1)]) T(value);
+}
 
-    if (Empty() || mStorage.back().first < serial) {
-        mStorage.emplace_back(SerialPair(serial, {}));
-    }
-    mStorage.back().second.emplace_back(value);
+template <typename T>
+void SerialQueue<T>::Enqueue(T&& value, Serial serial) {
+    size_t position = PrepareEnqueue(serial);
+    new (&mValues[position & (mValuesCapacity - 1)]) T(std::move(value));
 }
 
 template <typename T>
 void SerialQueue<T>::Enqueue(const std::vector<T>& values, Serial serial) {
     NXT_ASSERT(values.size() > 0);
-    NXT_ASSERT(Empty() || mStorage.back().first <= serial);
-    mStorage.emplace_back(SerialPair(serial, {values}));
+    for (const T& value : values) {
+        Enqueue(value, serial);
+    }
 }
 
 template <typename T>
 void SerialQueue<T>::Enqueue(std::vector<T>&& values, Serial serial) {
     NXT_ASSERT(values.size() > 0);
-    NXT_ASSERT(Empty() || mStorage.back().first <= serial);
-    mStorage.emplace_back(SerialPair(serial, {values}));
+    for (T& value : values) {
+        Enqueue(std::move(value), serial);
+    }
 }
 
 template <typename T>
 bool SerialQueue<T>::Empty() const {
-    return mStorage.empty();
+    return mValuesBegin == mValuesEnd;
 }
 
 template <typename T>
 typename SerialQueue<T>::ConstBeginEnd SerialQueue<T>::IterateAll() const {
-    return {mStorage.begin(), mStorage.end()};
+    return {mValues, mValuesCapacity - 1, mValuesBegin, mValuesEnd};
 }
 
 template <typename T>
 typename SerialQueue<T>::ConstBeginEnd SerialQueue<T>::IterateUpTo(Serial serial) const {
-    return {mStorage.begin(), FindUpTo(serial)};
+    size_t serialPosition;
+    return {mValues, mValuesCapacity - 1, mValuesBegin, FindUpTo(serial, &serialPosition)};
 }
 
 template <typename T>
 typename SerialQueue<T>::BeginEnd SerialQueue<T>::IterateAll() {
-    return {mStorage.begin(), mStorage.end()};
+    return {mValues, mValuesCapacity - 1, mValuesBegin, mValuesEnd};
 }
 
 template <typename T>
 typename SerialQueue<T>::BeginEnd SerialQueue<T>::IterateUpTo(Serial serial) {
-    return {mStorage.begin(), FindUpTo(serial)};
+    size_t serialPosition;
+    return {mValues, mValuesCapacity - 1, mValuesBegin, FindUpTo(serial, &serialPosition)};
 }
 
 template <typename T>
 void SerialQueue<T>::Clear() {
-    mStorage.clear();
+    DestroyValuesUpTo(mValuesEnd);
+    mSerialsBegin = mSerialsEnd;
 }
 
 template <typename T>
 void SerialQueue<T>::ClearUpTo(Serial serial) {
-    mStorage.erase(mStorage.begin(), FindUpTo(serial));
+    size_t serialPosition;
+    DestroyValuesUpTo(FindUpTo(serial, &serialPosition));
+    mSerialsBegin = serialPosition;
 }
 
 template <typename T>
 Serial SerialQueue<T>::FirstSerial() const {
     NXT_ASSERT(!Empty());
-    return mStorage.front().first;
+    return mSerials[mSerialsBegin & (mSerials.size() - 1)].serial;
 }
 
 template <typename T>
-typename SerialQueue<T>::ConstStorageIterator SerialQueue<T>::FindUpTo(Serial serial) const {
-    auto it = mStorage.begin();
-    while (it != mStorage.end() && it->first <= serial) {
-        it++;
+size_t SerialQueue<T>::PrepareEnqueue(Serial serial) {
+    if (mValuesEnd - mValuesBegin == mValuesCapacity) {
+        GrowValues();
     }
-    return it;
-}
-
-template <typename T>
-typename SerialQueue<T>::StorageIterator SerialQueue<T>::FindUpTo(Serial serial) {
-    auto it = mStorage.begin();
-    while (it != mStorage.end() && it->first <= serial) {
-        it++;
+    size_t position = mValuesEnd++;
+
+    if (mSerialsBegin != mSerialsEnd) {
+        SerialEnd& last = mSerials[(mSerialsEnd - 1) & (mSerials.size() - 1)];
+        NXT_ASSERT(last.serial <= serial);
+        if (last.serial == serial) {
+            last.end = mValuesEnd;
+            return position;
+        }
     }
-    return it;
-}
 
-// SerialQueue::BeginEnd
-
-template <typename T>
-SerialQueue<T>::BeginEnd::BeginEnd(typename SerialQueue<T>::StorageIterator start,
-                                   typename SerialQueue<T>::StorageIterator end)
-    : mStartIt(start), mEndIt(end) {
-}
-
-template <typename T>
-typename SerialQueue<T>::Iterator SerialQueue<T>::BeginEnd::begin() const {
-    return {mStartIt};
+    if (mSerialsEnd - mSerialsBegin == mSerials.size()) {
+        GrowSerials();
+    }
+    mSerials[mSerialsEnd++ & (mSerials.size() - 1)] = {serial, mValuesEnd};
+    return position;
 }
 
 template <typename T>
-typename SerialQueue<T>::Iterator SerialQueue<T>::BeginEnd::end() const {
-    return {mEndIt};
-}
-
-// SerialQueue::Iterator
+void SerialQueue<T>::GrowValues() {
+    // Positions aren't changed by growing so the values are moved from the slot their position
+    // maps to in the old ring to the slot it maps to in the new ring.
+    size_t newCapacity = mValuesCapacity == 0 ? 16 : 2 * mValuesCapacity;
+    T* newValues = std::allocator<T>().allocate(newCapacity);
+
+    for (size_t position = mValuesBegin; position != mValuesEnd; ++position) {
+        T& value = mValues[position & (mValuesCapacity - 1)];
+        new (&newValues[position & (newCapacity - 1)]) T(std::move(value));
+        value.~T();
+    }
 
-template <typename T>
-SerialQueue<T>::Iterator::Iterator(typename SerialQueue<T>::StorageIterator start)
-    : mStorageIterator(start), mSerialIterator(nullptr) {
+    if (mValues != nullptr) {
+        std::allocator<T>().deallocate(mValues, mValuesCapacity);
+    }
+    mValues = newValues;
+    mValuesCapacity = newCapacity;
 }
 
 template <typename T>
-typename SerialQueue<T>::Iterator& SerialQueue<T>::Iterator::operator++() {
-    T* vectorData = mStorageIterator->second.data();
+void SerialQueue<T>::GrowSerials() {
+    size_t oldSize = mSerials.size();
+    std::vector<SerialEnd> newSerials(oldSize == 0 ? 16 : 2 * oldSize);
 
-    if (mSerialIterator == nullptr) {
-        mSerialIterator = vectorData + 1;
-    } else {
-        mSerialIterator++;
+    for (size_t position = mSerialsBegin; position != mSerialsEnd; ++position) {
+        newSerials[position & (newSerials.size() - 1)] = mSerials[position & (oldSize - 1)];
     }
-
-    if (mSerialIterator >= vectorData + mStorageIterator->second.size()) {
-        mSerialIterator = nullptr;
-        mStorageIterator++;
-    }
-
-    return *this;
+    mSerials = std::move(newSerials);
 }
 
 template <typename T>
-bool SerialQueue<T>::Iterator::operator==(const typename SerialQueue<T>::Iterator& other) const {
-    return other.mStorageIterator == mStorageIterator && other.mSerialIterator == mSerialIterator;
-}
+size_t SerialQueue<T>::FindUpTo(Serial serial, size_t* serialPosition) const {
+    size_t valuesEnd = mValuesBegin;
+    size_t position = mSerialsBegin;
+    while (position != mSerialsEnd) {
+        const SerialEnd& serialEnd = mSerials[position & (mSerials.size() - 1)];
+        if (serialEnd.serial > serial) {
+            break;
+        }
+        valuesEnd = serialEnd.end;
+        position++;
+    }
 
-template <typename T>
-bool SerialQueue<T>::Iterator::operator!=(const typename SerialQueue<T>::Iterator& other) const {
-    return !(*this == other);
+    *serialPosition = position;
+    return valuesEnd;
 }
 
 template <typename T>
-T& SerialQueue<T>::Iterator::operator*() const {
-    if (mSerialIterator == nullptr) {
-        return *mStorageIterator->second.begin();
+void SerialQueue<T>::DestroyValuesUpTo(size_t end) {
+    for (; mValuesBegin != end; ++mValuesBegin) {
+        mValues[mValuesBegin & (mValuesCapacity - 1)].~T();
     }
-    return *mSerialIterator;
 }
 
-// SerialQueue::ConstBeginEnd
+// SerialQueue::BeginEndBase
 
 template <typename T>
-SerialQueue<T>::ConstBeginEnd::ConstBeginEnd(typename SerialQueue<T>::ConstStorageIterator start,
-                                             typename SerialQueue<T>::ConstStorageIterator end)
-    : mStartIt(start), mEndIt(end) {
+template <typename U>
+SerialQueue<T>::BeginEndBase<U>::BeginEndBase(U* values, size_t mask, size_t start, size_t end)
+    : mValues(values), mMask(mask), mStart(start), mEnd(end) {
 }
 
 template <typename T>
-typename SerialQueue<T>::ConstIterator SerialQueue<T>::ConstBeginEnd::begin() const {
-    return {mStartIt};
+template <typename U>
+typename SerialQueue<T>::template IteratorBase<U> SerialQueue<T>::BeginEndBase<U>::begin() const {
+    return {mValues, mMask, mStart};
 }
 
 template <typename T>
-typename SerialQueue<T>::ConstIterator SerialQueue<T>::ConstBeginEnd::end() const {
-    return {mEndIt};
+template <typename U>
+typename SerialQueue<T>::template IteratorBase<U> SerialQueue<T>::BeginEndBase<U>::end() const {
+    return {mValues, mMask, mEnd};
 }
 
-// SerialQueue::ConstIterator
+// SerialQueue::IteratorBase
 
 template <typename T>
-SerialQueue<T>::ConstIterator::ConstIterator(typename SerialQueue<T>::ConstStorageIterator start)
-    : mStorageIterator(start), mSerialIterator(nullptr) {
+template <typename U>
+SerialQueue<T>::IteratorBase<U>::IteratorBase(U* values, size_t mask, size_t position)
+    : mValues(values), mMask(mask), mPosition(position) {
 }
 
 template <typename T>
-typename SerialQueue<T>::ConstIterator& SerialQueue<T>::ConstIterator::operator++() {
-    const T* vectorData = mStorageIterator->second.data();
-
-    if (mSerialIterator == nullptr) {
-        mSerialIterator = vectorData + 1;
-    } else {
-        mSerialIterator++;
-    }
-
-    if (mSerialIterator >= vectorData + mStorageIterator->second.size()) {
-        mSerialIterator = nullptr;
-        mStorageIterator++;
-    }
-
+template <typename U>
+typename SerialQueue<T>::template IteratorBase<U>& SerialQueue<T>::IteratorBase<U>::operator++() {
+    mPosition++;
     return *this;
 }
 
 template <typename T>
-bool SerialQueue<T>::ConstIterator::operator==(
-    const typename SerialQueue<T>::ConstIterator& other) const {
-    return other.mStorageIterator == mStorageIterator && other.mSerialIterator == mSerialIterator;
+template <typename U>
+bool SerialQueue<T>::IteratorBase<U>::operator==(const IteratorBase& other) const {
+    return mPosition == other.mPosition;
 }
 
 template <typename T>
-bool SerialQueue<T>::ConstIterator::operator!=(
-    const typename SerialQueue<T>::ConstIterator& other) const {
-    return !(*this == other);
+template <typename U>
+bool SerialQueue<T>::IteratorBase<U>::operator!=(const IteratorBase& other) const {
+    return mPosition != other.mPosition;
 }
 
 template <typename T>
-const T& SerialQueue<T>::ConstIterator::operator*() const {
-    if (mSerialIterator == nullptr) {
-        return *mStorageIterator->second.begin();
-    }
-    return *mSerialIterator;
+template <typename U>
+U& SerialQueue<T>::IteratorBase<U>::operator*() const {
+    return mValues[mPosition & mMask];
 }
 
 #endif  // COMMON_SERIALQUEUE_H_
@@ -0,0 +1,119 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/Trace.h"
+
+#include <array>
+#include <chrono>
+
+std::atomic<bool> gTracingEnabled(false);
+
+namespace {
+
+    struct TraceEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Single-producer single-consumer ring of events. The recording thread is the only one
+    // writing events and advancing written, the flush is the only one advancing read.
+    struct ThreadTraceBuffer {
+        static constexpr uint64_t kCapacity = 16384;
+
+        std::array<TraceEvent, kCapacity> events;
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> read{0};
+        uint32_t threadId = 0;
+        ThreadTraceBuffer* next = nullptr;
+    };
+
+    // Buffers are never freed so that the events of threads that exited can still be flushed.
+    // They are kept in a list that threads push to without locking.
+    std::atomic<ThreadTraceBuffer*> gBuffers(nullptr);
+    std::atomic<uint32_t> gNextThreadId(1);
+
+    thread_local ThreadTraceBuffer* tBuffer = nullptr;
+
+    ThreadTraceBuffer* GetThreadBuffer() {
+        if (tBuffer == nullptr) {
+            ThreadTraceBuffer* buffer = new ThreadTraceBuffer;
+            buffer->threadId = gNextThreadId.fetch_add(1, std::memory_order_relaxed);
+
+            buffer->next = gBuffers.load(std::memory_order_relaxed);
+            while (!gBuffers.compare_exchange_weak(buffer->next, buffer,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+            }
+            tBuffer = buffer;
+        }
+        return tBuffer;
+    }
+
+    const auto kTraceEpoch = std::chrono::steady_clock::now();
+
+    // Chrome trace timestamps are in microseconds.
+    void WriteMicroseconds(std::ostream& stream, uint64_t ns) {
+        char fraction[4] = {static_cast<char>('0' + (ns / 100) % 10),
+                            static_cast<char>('0' + (ns / 10) % 10),
+                            static_cast<char>('0' + ns % 10), '\0'};
+        stream << ns / 1000 << "." << fraction;
+    }
+
+}  // anonymous namespace
+
+void StartTracing() {
+    gTracingEnabled.store(true, std::memory_order_relaxed);
+}
+
+void StopTracing() {
+    gTracingEnabled.store(false, std::memory_order_relaxed);
+}
+
+uint64_t GetTraceTimestampNs() {
+    auto sinceEpoch = std::chrono::steady_clock::now() - kTraceEpoch;
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+}
+
+void RecordTraceEvent(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadTraceBuffer* buffer = GetThreadBuffer();
+
+    uint64_t written = buffer->written.load(std::memory_order_relaxed);
+    if (written - buffer->read.load(std::memory_order_acquire) == ThreadTraceBuffer::kCapacity) {
+        return;
+    }
+
+    buffer->events[written % ThreadTraceBuffer::kCapacity] = {name, startNs, endNs};
+    buffer->written.store(written + 1, std::memory_order_release);
+}
+
+void FlushTraceEvents(std::ostream& stream) {
+    for (ThreadTraceBuffer* buffer = gBuffers.load(std::memory_order_acquire); buffer != nullptr;
+         buffer = buffer->next) {
+        uint64_t read = buffer->read.load(std::memory_order_relaxed);
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+
+        for (; read < written; ++read) {
+            const TraceEvent& event = buffer->events[read % ThreadTraceBuffer::kCapacity];
+            stream << "{\"name\":\"" << event.name << "\",\"cat\":\"nxt\",\"ph\":\"X\",\"ts\":";
+            WriteMicroseconds(stream, event.startNs);
+            stream << ",\"dur\":";
+            WriteMicroseconds(stream, event.endNs - event.startNs);
+            stream << ",\"pid\":1,\"tid\":" << buffer->threadId << "},\n";
+        }
+
+        buffer->read.store(written, std::memory_order_release);
+    }
+}
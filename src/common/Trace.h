@@ -0,0 +1,72 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_TRACE_H_
+#define COMMON_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Lightweight tracing of scopes to the Chrome trace event format (chrome://tracing).
+//
+// NXT_TRACE_SCOPE(name) records a complete event covering the rest of the enclosing scope in a
+// buffer local to the calling thread. When tracing is disabled it only costs a relaxed atomic
+// load. Names must be string literals that don't need escaping in JSON.
+#define NXT_TRACE_SCOPE(name) NXT_TRACE_SCOPE_IMPL(name, __LINE__)
+#define NXT_TRACE_SCOPE_IMPL(name, line) NXT_TRACE_SCOPE_IMPL2(name, line)
+#define NXT_TRACE_SCOPE_IMPL2(name, line) TraceScope traceScope##line(name)
+
+void StartTracing();
+void StopTracing();
+
+// Appends the events recorded since the last flush to stream, as JSON objects each followed by
+// a comma. Writing "[" before the first flush makes a file chrome://tracing can load, as it
+// doesn't require the closing bracket. Recording threads are never blocked but flushes must not
+// run concurrently with each other. Events recorded while a thread's buffer is full are dropped.
+void FlushTraceEvents(std::ostream& stream);
+
+extern std::atomic<bool> gTracingEnabled;
+
+inline bool IsTracingEnabled() {
+    return gTracingEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t GetTraceTimestampNs();
+void RecordTraceEvent(const char* name, uint64_t startNs, uint64_t endNs);
+
+class TraceScope {
+  public:
+    TraceScope(const char* name) {
+        if (IsTracingEnabled()) {
+            mName = name;
+            mStartNs = GetTraceTimestampNs();
+        }
+    }
+
+    ~TraceScope() {
+        if (mName != nullptr) {
+            RecordTraceEvent(mName, mStartNs, GetTraceTimestampNs());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    const char* mName = nullptr;
+    uint64_t mStartNs = 0;
+};
+
+#endif  // COMMON_TRACE_H_
@@ -0,0 +1,92 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/WorkerPool.h"
+
+#include "common/Assert.h"
+
+WorkerPool::WorkerPool(uint32_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    // hardware_concurrency can return 0 when it cannot compute the number of threads.
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        mThreads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mTaskPosted.notify_all();
+
+    for (std::thread& thread : mThreads) {
+        thread.join();
+    }
+    ASSERT(mTasks.empty());
+}
+
+std::future<void> WorkerPool::PostTask(std::function<void()> task) {
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::future<void> future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ASSERT(!mStopping);
+        mTasks.push_back(std::move(packagedTask));
+    }
+    mTaskPosted.notify_one();
+
+    return future;
+}
+
+void WorkerPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this] { return mTasks.empty() && mRunningTasks == 0; });
+}
+
+uint32_t WorkerPool::GetThreadCount() const {
+    return static_cast<uint32_t>(mThreads.size());
+}
+
+void WorkerPool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        // Tasks still in the queue are run before stopping so that their futures become ready.
+        mTaskPosted.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+        if (mTasks.empty()) {
+            ASSERT(mStopping);
+            return;
+        }
+
+        std::packaged_task<void()> task = std::move(mTasks.front());
+        mTasks.pop_front();
+        mRunningTasks++;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        mRunningTasks--;
+        if (mTasks.empty() && mRunningTasks == 0) {
+            mIdle.notify_all();
+        }
+    }
+}
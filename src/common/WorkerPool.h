@@ -0,0 +1,56 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_WORKERPOOL_H_
+#define COMMON_WORKERPOOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads running posted tasks in FIFO order. The destructor waits for all the
+// posted tasks to be finished.
+class WorkerPool {
+  public:
+    // threadCount == 0 uses one thread per hardware thread.
+    WorkerPool(uint32_t threadCount = 0);
+    ~WorkerPool();
+
+    // The returned future is ready once the task has run.
+    std::future<void> PostTask(std::function<void()> task);
+
+    // Waits until all the tasks posted so far have run.
+    void WaitIdle();
+
+    uint32_t GetThreadCount() const;
+
+  private:
+    void WorkerLoop();
+
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mTaskPosted;
+    std::condition_variable mIdle;
+    std::deque<std::packaged_task<void()>> mTasks;
+    uint32_t mRunningTasks = 0;
+    bool mStopping = false;
+};
+
+#endif  // COMMON_WORKERPOOL_H_
@@ -44,18 +44,18 @@ class VkNonDispatchableHandle {
     VkNonDispatchableHandle& operator=(const VkNonDispatchableHandle<Tag>&) = default;
 
     // Comparisons between handles
-    bool operator==(VkNonDispatchableHandle<Tag> other) {
+    bool operator==(VkNonDispatchableHandle<Tag> other) const {
         return mHandle == other.mHandle;
     }
-    bool operator!=(VkNonDispatchableHandle<Tag> other) {
+    bool operator!=(VkNonDispatchableHandle<Tag> other) const {
         return mHandle != other.mHandle;
     }
 
     // Comparisons between handles and VK_NULL_HANDLE
-    bool operator==(std::nullptr_t) {
+    bool operator==(std::nullptr_t) const {
         return mHandle == 0;
     }
-    bool operator!=(std::nullptr_t) {
+    bool operator!=(std::nullptr_t) const {
         return mHandle != 0;
     }
 
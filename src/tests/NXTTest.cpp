@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include "GLFW/glfw3.h"
+
 namespace {
 
     utils::BackendType ParamToBackendType(BackendType type) {
@@ -226,7 +227,22 @@ std::ostringstream& NXTTest::AddTextureExpectation(const char* file, int line, c
 
 void NXTTest::WaitABit() {
     device.Tick();
-    utils::USleep(100);
+
+    // Block until the GPU work submitted so far completes instead of polling, unless the backend
+    // doesn't track serials or has nothing in flight.
+    uint64_t lastSubmittedSerial = 0;
+    uint64_t completedSerial = 0;
+    if (mBinding->GetSerials(&lastSubmittedSerial, &completedSerial) &&
+        lastSubmittedSerial > completedSerial) {
+        constexpr uint64_t kWaitTimeoutNs = 100 * 1000 * 1000;
+        mBinding->WaitForSerial(lastSubmittedSerial, kWaitTimeoutNs);
+    } else {
+        utils::USleep(100);
+    }
+}
+
+utils::BackendBinding* NXTTest::GetBinding() const {
+    return mBinding;
 }
 
 void NXTTest::SwapBuffersForCapture() {
@@ -91,6 +91,9 @@ class NXTTest : public ::testing::TestWithParam<BackendType> {
 
         void SwapBuffersForCapture();
 
+        // The binding of the backend being tested, used to query statistics of the backend.
+        utils::BackendBinding* GetBinding() const;
+
     private:
         // MapRead buffers used to get data for the expectations
         struct ReadbackSlot {
@@ -0,0 +1,65 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/BitSetIterator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr size_t kSetCount = 256;
+
+    // Random bitsets with roughly density / 64 bits set, generated once per size and density.
+    template <size_t N>
+    std::vector<std::bitset<N>> MakeBitSets(uint32_t density) {
+        std::mt19937 generator(N + density);
+        std::uniform_int_distribution<uint32_t> distribution(0, 63);
+
+        std::vector<std::bitset<N>> sets(kSetCount);
+        for (auto& set : sets) {
+            for (size_t i = 0; i < N; ++i) {
+                set[i] = distribution(generator) < density;
+            }
+        }
+        return sets;
+    }
+
+    // Sums the indices of the set bits so that the loop can't be optimized out. kFitsInUint64
+    // forces the iterator implementation so both can be compared on the same bitsets.
+    template <size_t N, bool kFitsInUint64>
+    void BM_IterateBitSet(benchmark::State& state) {
+        std::vector<std::bitset<N>> sets = MakeBitSets<N>(static_cast<uint32_t>(state.range(0)));
+
+        for (auto _ : state) {
+            uint32_t sum = 0;
+            for (const auto& set : sets) {
+                for (uint32_t bit : BitSetIterator<N, uint32_t, kFitsInUint64>(set)) {
+                    sum += bit;
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * kSetCount);
+    }
+
+    // Bitsets of the size of the attribute and binding masks, sparse to full.
+    BENCHMARK_TEMPLATE(BM_IterateBitSet, 16, false)->Arg(4)->Arg(32)->Arg(64);
+    BENCHMARK_TEMPLATE(BM_IterateBitSet, 16, true)->Arg(4)->Arg(32)->Arg(64);
+    BENCHMARK_TEMPLATE(BM_IterateBitSet, 64, false)->Arg(4)->Arg(32)->Arg(64);
+    BENCHMARK_TEMPLATE(BM_IterateBitSet, 64, true)->Arg(4)->Arg(32)->Arg(64);
+
+}  // anonymous namespace
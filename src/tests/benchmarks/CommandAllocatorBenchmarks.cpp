@@ -0,0 +1,104 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/CommandAllocator.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace backend;
+
+namespace {
+
+    enum class CommandType {
+        Draw,
+        PushConstants,
+    };
+
+    struct CommandDraw {
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+    };
+
+    struct CommandPushConstants {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    constexpr uint32_t kPushConstantCount = 4;
+
+    // Allocates state.range(0) commands, alternating between draws and push constants with
+    // their data, like a render pass does.
+    void AllocateCommands(CommandAllocator* allocator, int64_t commandCount) {
+        for (int64_t i = 0; i < commandCount; ++i) {
+            if (i % 2 == 0) {
+                CommandDraw* draw = allocator->Allocate<CommandDraw>(CommandType::Draw);
+                draw->vertexCount = 3;
+                draw->instanceCount = 1;
+                draw->firstVertex = 0;
+                draw->firstInstance = 0;
+            } else {
+                CommandPushConstants* pushConstants =
+                    allocator->Allocate<CommandPushConstants>(CommandType::PushConstants);
+                pushConstants->offset = 0;
+                pushConstants->count = kPushConstantCount;
+
+                uint32_t* data = allocator->AllocateData<uint32_t>(kPushConstantCount);
+                for (uint32_t j = 0; j < kPushConstantCount; ++j) {
+                    data[j] = j;
+                }
+            }
+        }
+    }
+
+}  // anonymous namespace
+
+static void BM_CommandAllocatorAllocate(benchmark::State& state) {
+    for (auto _ : state) {
+        CommandAllocator allocator;
+        AllocateCommands(&allocator, state.range(0));
+
+        CommandIterator iterator(std::move(allocator));
+        iterator.DataWasDestroyed();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CommandAllocatorAllocate)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_CommandAllocatorAllocateAndIterate(benchmark::State& state) {
+    for (auto _ : state) {
+        CommandAllocator allocator;
+        AllocateCommands(&allocator, state.range(0));
+
+        CommandIterator iterator(std::move(allocator));
+        uint32_t sum = 0;
+        CommandType type;
+        while (iterator.NextCommandId(&type)) {
+            if (type == CommandType::Draw) {
+                sum += iterator.NextCommand<CommandDraw>()->vertexCount;
+            } else {
+                CommandPushConstants* pushConstants = iterator.NextCommand<CommandPushConstants>();
+                uint32_t* data = iterator.NextData<uint32_t>(pushConstants->count);
+                sum += data[pushConstants->count - 1];
+            }
+        }
+        iterator.DataWasDestroyed();
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CommandAllocatorAllocateAndIterate)->Arg(16)->Arg(1024)->Arg(65536);
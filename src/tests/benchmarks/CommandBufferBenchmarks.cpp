@@ -0,0 +1,368 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmarks/NullDevice.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// Measures the recording of each type of command, the validation of command buffers done in
+// CommandBufferBuilder::ValidateGetResult, and Queue::Submit.
+
+namespace {
+
+    constexpr uint32_t kCommandsPerBuffer = 64;
+
+    // The pass the recorded commands are wrapped in.
+    enum class PassType {
+        None,
+        Compute,
+        Render,
+    };
+
+    struct RecordingObjects {
+        nxt::Buffer source;
+        nxt::Buffer destination;
+        nxt::Buffer transitioned;
+        nxt::Buffer indices;
+        nxt::Texture sourceTexture;
+        nxt::Texture destinationTexture;
+        nxt::RenderPassDescriptor renderPass;
+        nxt::RenderPipeline renderPipeline;
+        nxt::ComputePipeline computePipeline;
+        nxt::BindGroup bindGroups[2];
+        nxt::Queue queue;
+    };
+
+    nxt::Buffer CreateFrozenBuffer(nxt::BufferUsageBit usage) {
+        nxt::Buffer buffer = GetNullDevice()
+                                 .CreateBufferBuilder()
+                                 .SetAllowedUsage(usage)
+                                 .SetSize(1024)
+                                 .GetResult();
+        buffer.FreezeUsage(usage);
+        return buffer;
+    }
+
+    nxt::Texture CreateFrozenTexture(nxt::TextureUsageBit usage) {
+        nxt::Texture texture = GetNullDevice()
+                                   .CreateTextureBuilder()
+                                   .SetDimension(nxt::TextureDimension::e2D)
+                                   .SetExtent(16, 16, 1)
+                                   .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                                   .SetMipLevels(1)
+                                   .SetAllowedUsage(usage)
+                                   .GetResult();
+        texture.FreezeUsage(usage);
+        return texture;
+    }
+
+    RecordingObjects* GetRecordingObjects() {
+        static RecordingObjects* objects = [] {
+            const nxt::Device& device = GetNullDevice();
+
+            RecordingObjects* result = new RecordingObjects;
+            result->source = CreateFrozenBuffer(nxt::BufferUsageBit::TransferSrc);
+            result->destination = CreateFrozenBuffer(nxt::BufferUsageBit::TransferDst);
+            result->transitioned =
+                device.CreateBufferBuilder()
+                    .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc |
+                                     nxt::BufferUsageBit::TransferDst)
+                    .SetSize(1024)
+                    .GetResult();
+            result->sourceTexture = CreateFrozenTexture(nxt::TextureUsageBit::TransferSrc);
+            result->destinationTexture = CreateFrozenTexture(nxt::TextureUsageBit::TransferDst);
+
+            nxt::Texture attachment =
+                CreateFrozenTexture(nxt::TextureUsageBit::OutputAttachment);
+            result->renderPass =
+                device.CreateRenderPassDescriptorBuilder()
+                    .SetColorAttachment(0, attachment.CreateTextureView(), nxt::LoadOp::Clear)
+                    .GetResult();
+
+            // The pipelines are compiled with shaderc at runtime, like in the validation tests.
+            nxt::BindGroupLayout bindGroupLayout =
+                device.CreateBindGroupLayoutBuilder()
+                    .SetBindingsType(nxt::ShaderStageBit::Vertex, nxt::BindingType::UniformBuffer,
+                                     0, 1)
+                    .GetResult();
+            nxt::PipelineLayout renderLayout = device.CreatePipelineLayoutBuilder()
+                                                   .SetBindGroupLayout(0, bindGroupLayout)
+                                                   .GetResult();
+
+            nxt::ShaderModule vsModule =
+                utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                layout(set = 0, binding = 0) uniform Uniforms {
+                    vec4 offset;
+                };
+                layout(push_constant) uniform PushConstants {
+                    float scale;
+                };
+                void main() {
+                    gl_Position = vec4(0.0, 0.0, 0.0, 1.0) * scale + offset;
+                })");
+            nxt::ShaderModule fsModule =
+                utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.0, 1.0, 0.0, 1.0);
+                })");
+            result->renderPipeline =
+                device.CreateRenderPipelineBuilder()
+                    .SetColorAttachmentFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                    .SetLayout(renderLayout)
+                    .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                    .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                    .SetPrimitiveTopology(nxt::PrimitiveTopology::TriangleList)
+                    .GetResult();
+
+            nxt::ShaderModule csModule =
+                utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+                #version 450
+                layout(local_size_x = 1) in;
+                void main() {
+                })");
+            result->computePipeline =
+                device.CreateComputePipelineBuilder()
+                    .SetLayout(device.CreatePipelineLayoutBuilder().GetResult())
+                    .SetStage(nxt::ShaderStage::Compute, csModule, "main")
+                    .GetResult();
+
+            for (nxt::BindGroup& bindGroup : result->bindGroups) {
+                nxt::BufferView view = CreateFrozenBuffer(nxt::BufferUsageBit::Uniform)
+                                           .CreateBufferViewBuilder()
+                                           .SetExtent(0, 16)
+                                           .GetResult();
+                bindGroup = device.CreateBindGroupBuilder()
+                                .SetLayout(bindGroupLayout)
+                                .SetUsage(nxt::BindGroupUsage::Frozen)
+                                .SetBufferViews(0, 1, &view)
+                                .GetResult();
+            }
+            result->indices = CreateFrozenBuffer(nxt::BufferUsageBit::Index);
+
+            result->queue = device.CreateQueueBuilder().GetResult();
+            return result;
+        }();
+        return objects;
+    }
+
+    // Records one command, or a pair of commands for passes. The index lets recorders alternate
+    // between values so that the validation sees changes.
+    using RecordFunction = void (*)(const nxt::CommandBufferBuilder& builder,
+                                    const RecordingObjects* objects,
+                                    uint32_t index);
+
+    void RecordCopyBufferToBuffer(const nxt::CommandBufferBuilder& builder,
+                                  const RecordingObjects* objects,
+                                  uint32_t) {
+        builder.CopyBufferToBuffer(objects->source, 0, objects->destination, 0, 4);
+    }
+
+    void RecordCopyBufferToTexture(const nxt::CommandBufferBuilder& builder,
+                                   const RecordingObjects* objects,
+                                   uint32_t) {
+        builder.CopyBufferToTexture(objects->source, 0, 256, objects->destinationTexture, 0, 0, 0,
+                                    4, 4, 1, 0);
+    }
+
+    void RecordCopyTextureToBuffer(const nxt::CommandBufferBuilder& builder,
+                                   const RecordingObjects* objects,
+                                   uint32_t) {
+        builder.CopyTextureToBuffer(objects->sourceTexture, 0, 0, 0, 4, 4, 1, 0,
+                                    objects->destination, 0, 256);
+    }
+
+    void RecordTransitionBufferUsage(const nxt::CommandBufferBuilder& builder,
+                                     const RecordingObjects* objects,
+                                     uint32_t index) {
+        nxt::BufferUsageBit usage = index % 2 == 0 ? nxt::BufferUsageBit::TransferSrc
+                                                   : nxt::BufferUsageBit::TransferDst;
+        builder.TransitionBufferUsage(objects->transitioned, usage);
+    }
+
+    void RecordComputePass(const nxt::CommandBufferBuilder& builder,
+                           const RecordingObjects*,
+                           uint32_t) {
+        builder.BeginComputePass().EndComputePass();
+    }
+
+    void RecordRenderPass(const nxt::CommandBufferBuilder& builder,
+                          const RecordingObjects* objects,
+                          uint32_t) {
+        builder.BeginRenderPass(objects->renderPass).EndRenderPass();
+    }
+
+    void RecordSetRenderPipeline(const nxt::CommandBufferBuilder& builder,
+                                 const RecordingObjects* objects,
+                                 uint32_t) {
+        builder.SetRenderPipeline(objects->renderPipeline);
+    }
+
+    void RecordSetComputePipeline(const nxt::CommandBufferBuilder& builder,
+                                  const RecordingObjects* objects,
+                                  uint32_t) {
+        builder.SetComputePipeline(objects->computePipeline);
+    }
+
+    void RecordSetBindGroup(const nxt::CommandBufferBuilder& builder,
+                            const RecordingObjects* objects,
+                            uint32_t index) {
+        if (index == 0) {
+            builder.SetRenderPipeline(objects->renderPipeline);
+        }
+        builder.SetBindGroup(0, objects->bindGroups[index % 2]);
+    }
+
+    void RecordSetPushConstants(const nxt::CommandBufferBuilder& builder,
+                                const RecordingObjects*,
+                                uint32_t index) {
+        builder.SetPushConstants(nxt::ShaderStageBit::Vertex, 0, 1, &index);
+    }
+
+    // Draws need the pipeline and its bind group to be set, which is done before the first one.
+    void RecordDrawArrays(const nxt::CommandBufferBuilder& builder,
+                          const RecordingObjects* objects,
+                          uint32_t index) {
+        if (index == 0) {
+            builder.SetRenderPipeline(objects->renderPipeline)
+                .SetBindGroup(0, objects->bindGroups[0]);
+        }
+        builder.DrawArrays(3, 1, 0, 0);
+    }
+
+    void RecordDrawElements(const nxt::CommandBufferBuilder& builder,
+                            const RecordingObjects* objects,
+                            uint32_t index) {
+        if (index == 0) {
+            builder.SetRenderPipeline(objects->renderPipeline)
+                .SetBindGroup(0, objects->bindGroups[0])
+                .SetIndexBuffer(objects->indices, 0);
+        }
+        builder.DrawElements(3, 1, 0, 0);
+    }
+
+    void RecordCommands(const nxt::CommandBufferBuilder& builder,
+                        const RecordingObjects* objects,
+                        RecordFunction record,
+                        PassType pass = PassType::None) {
+        switch (pass) {
+            case PassType::Compute:
+                builder.BeginComputePass();
+                break;
+            case PassType::Render:
+                builder.BeginRenderPass(objects->renderPass);
+                break;
+            case PassType::None:
+                break;
+        }
+
+        for (uint32_t i = 0; i < kCommandsPerBuffer; ++i) {
+            record(builder, objects, i);
+        }
+
+        switch (pass) {
+            case PassType::Compute:
+                builder.EndComputePass();
+                break;
+            case PassType::Render:
+                builder.EndRenderPass();
+                break;
+            case PassType::None:
+                break;
+        }
+    }
+
+}  // anonymous namespace
+
+// The builders are destroyed without calling GetResult so that only the recording is measured.
+template <RecordFunction Record, PassType Pass = PassType::None>
+static void BM_RecordCommands(benchmark::State& state) {
+    RecordingObjects* objects = GetRecordingObjects();
+
+    for (auto _ : state) {
+        nxt::CommandBufferBuilder builder = GetNullDevice().CreateCommandBufferBuilder();
+        RecordCommands(builder, objects, Record, Pass);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kCommandsPerBuffer);
+}
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordCopyBufferToBuffer);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordCopyBufferToTexture);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordCopyTextureToBuffer);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordTransitionBufferUsage);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordComputePass);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordRenderPass);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordSetRenderPipeline, PassType::Render);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordSetComputePipeline, PassType::Compute);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordSetBindGroup, PassType::Render);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordSetPushConstants, PassType::Render);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordDrawArrays, PassType::Render);
+BENCHMARK_TEMPLATE(BM_RecordCommands, RecordDrawElements, PassType::Render);
+
+// The recording isn't timed, only GetResult which runs ValidateGetResult on all the commands.
+template <RecordFunction Record, PassType Pass = PassType::None>
+static void BM_ValidateGetResult(benchmark::State& state) {
+    RecordingObjects* objects = GetRecordingObjects();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        nxt::CommandBufferBuilder builder = GetNullDevice().CreateCommandBufferBuilder();
+        RecordCommands(builder, objects, Record, Pass);
+        state.ResumeTiming();
+
+        nxt::CommandBuffer commands = builder.GetResult();
+        benchmark::DoNotOptimize(commands.Get());
+    }
+
+    state.SetItemsProcessed(state.iterations() * kCommandsPerBuffer);
+}
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordCopyBufferToBuffer);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordCopyBufferToTexture);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordCopyTextureToBuffer);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordTransitionBufferUsage);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordComputePass);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordRenderPass);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordSetRenderPipeline, PassType::Render);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordSetComputePipeline, PassType::Compute);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordSetBindGroup, PassType::Render);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordSetPushConstants, PassType::Render);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordDrawArrays, PassType::Render);
+BENCHMARK_TEMPLATE(BM_ValidateGetResult, RecordDrawElements, PassType::Render);
+
+// Submits state.range(0) command buffers of copies at once. The same command buffers are submitted
+// at every iteration, which is fine because the null backend only skips over the commands.
+static void BM_QueueSubmit(benchmark::State& state) {
+    RecordingObjects* objects = GetRecordingObjects();
+
+    std::vector<nxt::CommandBuffer> commandBuffers;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        nxt::CommandBufferBuilder builder = GetNullDevice().CreateCommandBufferBuilder();
+        RecordCommands(builder, objects, RecordCopyBufferToBuffer);
+        commandBuffers.push_back(builder.GetResult());
+    }
+
+    for (auto _ : state) {
+        objects->queue.Submit(static_cast<uint32_t>(commandBuffers.size()),
+                              commandBuffers.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueueSubmit)->Arg(1)->Arg(8);
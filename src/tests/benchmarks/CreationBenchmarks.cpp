@@ -0,0 +1,197 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmarks/NullDevice.h"
+
+#include <benchmark/benchmark.h>
+
+// Measures the creation of each type of object. Buffer views, texture views and bind groups are
+// created both through their builders and through the builder-free entry points.
+
+namespace {
+
+    constexpr uint32_t kBindingCount = 4;
+
+    struct CreationObjects {
+        nxt::Buffer buffer;
+        nxt::Texture texture;
+        nxt::BindGroupLayout layout;
+        nxt::BufferView bufferViews[kBindingCount];
+        nxt::Sampler samplers[kBindingCount];
+        nxt::TextureView textureViews[kBindingCount];
+    };
+
+    CreationObjects* GetCreationObjects() {
+        static CreationObjects* objects = [] {
+            const nxt::Device& device = GetNullDevice();
+
+            CreationObjects* result = new CreationObjects;
+            result->buffer = device.CreateBufferBuilder()
+                                 .SetAllowedUsage(nxt::BufferUsageBit::Uniform)
+                                 .SetInitialUsage(nxt::BufferUsageBit::Uniform)
+                                 .SetSize(kBindingCount * 256)
+                                 .GetResult();
+            result->texture = device.CreateTextureBuilder()
+                                  .SetDimension(nxt::TextureDimension::e2D)
+                                  .SetExtent(64, 64, 1)
+                                  .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                                  .SetMipLevels(1)
+                                  .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+                                  .GetResult();
+            result->layout = device.CreateBindGroupLayoutBuilder()
+                                 .SetBindingsType(nxt::ShaderStageBit::Vertex,
+                                                  nxt::BindingType::UniformBuffer, 0, kBindingCount)
+                                 .GetResult();
+            for (uint32_t i = 0; i < kBindingCount; ++i) {
+                result->bufferViews[i] = result->buffer.CreateBufferView(i * 256, 256);
+            }
+            return result;
+        }();
+        return objects;
+    }
+
+}  // anonymous namespace
+
+static void BM_CreateBuffer(benchmark::State& state) {
+    for (auto _ : state) {
+        nxt::Buffer buffer = GetNullDevice()
+                                 .CreateBufferBuilder()
+                                 .SetAllowedUsage(nxt::BufferUsageBit::Uniform)
+                                 .SetInitialUsage(nxt::BufferUsageBit::Uniform)
+                                 .SetSize(256)
+                                 .GetResult();
+        benchmark::DoNotOptimize(buffer.Get());
+    }
+}
+BENCHMARK(BM_CreateBuffer);
+
+static void BM_CreateTexture(benchmark::State& state) {
+    for (auto _ : state) {
+        nxt::Texture texture = GetNullDevice()
+                                   .CreateTextureBuilder()
+                                   .SetDimension(nxt::TextureDimension::e2D)
+                                   .SetExtent(64, 64, 1)
+                                   .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                                   .SetMipLevels(1)
+                                   .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+                                   .GetResult();
+        benchmark::DoNotOptimize(texture.Get());
+    }
+}
+BENCHMARK(BM_CreateTexture);
+
+static void BM_CreateSampler(benchmark::State& state) {
+    for (auto _ : state) {
+        nxt::Sampler sampler = GetNullDevice()
+                                   .CreateSamplerBuilder()
+                                   .SetFilterMode(nxt::FilterMode::Linear,
+                                                  nxt::FilterMode::Linear,
+                                                  nxt::FilterMode::Linear)
+                                   .GetResult();
+        benchmark::DoNotOptimize(sampler.Get());
+    }
+}
+BENCHMARK(BM_CreateSampler);
+
+static void BM_CreateBindGroupLayout(benchmark::State& state) {
+    // The objects keep a layout with the same bindings alive so this measures a cache hit.
+    GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::BindGroupLayout layout =
+            GetNullDevice()
+                .CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Vertex, nxt::BindingType::UniformBuffer, 0,
+                                 kBindingCount)
+                .GetResult();
+        benchmark::DoNotOptimize(layout.Get());
+    }
+}
+BENCHMARK(BM_CreateBindGroupLayout);
+
+static void BM_CreateEmptyCommandBuffer(benchmark::State& state) {
+    for (auto _ : state) {
+        nxt::CommandBuffer commands = GetNullDevice().CreateCommandBufferBuilder().GetResult();
+        benchmark::DoNotOptimize(commands.Get());
+    }
+}
+BENCHMARK(BM_CreateEmptyCommandBuffer);
+
+static void BM_CreateBufferViewWithBuilder(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::BufferView view =
+            objects->buffer.CreateBufferViewBuilder().SetExtent(0, 256).GetResult();
+        benchmark::DoNotOptimize(view.Get());
+    }
+}
+BENCHMARK(BM_CreateBufferViewWithBuilder);
+
+static void BM_CreateBufferView(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::BufferView view = objects->buffer.CreateBufferView(0, 256);
+        benchmark::DoNotOptimize(view.Get());
+    }
+}
+BENCHMARK(BM_CreateBufferView);
+
+static void BM_CreateTextureViewWithBuilder(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::TextureView view = objects->texture.CreateTextureViewBuilder().GetResult();
+        benchmark::DoNotOptimize(view.Get());
+    }
+}
+BENCHMARK(BM_CreateTextureViewWithBuilder);
+
+static void BM_CreateTextureView(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::TextureView view = objects->texture.CreateTextureView();
+        benchmark::DoNotOptimize(view.Get());
+    }
+}
+BENCHMARK(BM_CreateTextureView);
+
+static void BM_CreateBindGroupWithBuilder(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::BindGroup bindGroup = GetNullDevice()
+                                       .CreateBindGroupBuilder()
+                                       .SetLayout(objects->layout)
+                                       .SetUsage(nxt::BindGroupUsage::Frozen)
+                                       .SetBufferViews(0, kBindingCount, objects->bufferViews)
+                                       .GetResult();
+        benchmark::DoNotOptimize(bindGroup.Get());
+    }
+}
+BENCHMARK(BM_CreateBindGroupWithBuilder);
+
+static void BM_CreateBindGroup(benchmark::State& state) {
+    CreationObjects* objects = GetCreationObjects();
+
+    for (auto _ : state) {
+        nxt::BindGroup bindGroup = objects->layout.CreateBindGroup(
+            nxt::BindGroupUsage::Frozen, kBindingCount, objects->bufferViews, objects->samplers,
+            objects->textureViews);
+        benchmark::DoNotOptimize(bindGroup.Get());
+    }
+}
+BENCHMARK(BM_CreateBindGroup);
@@ -0,0 +1,158 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/BitSetIterator.h"
+#include "common/Constants.h"
+#include "common/HashUtils.h"
+
+#include "nxt/nxtcpp.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+    // The key of the bind group layout cache.
+    struct BindGroupLayoutKey {
+        std::bitset<kMaxBindingsPerGroup> mask;
+        std::array<nxt::ShaderStageBit, kMaxBindingsPerGroup> visibilities;
+        std::array<nxt::BindingType, kMaxBindingsPerGroup> types;
+    };
+
+    bool operator==(const BindGroupLayoutKey& a, const BindGroupLayoutKey& b) {
+        if (a.mask != b.mask) {
+            return false;
+        }
+        for (uint32_t binding : IterateBitSet(a.mask)) {
+            if (a.visibilities[binding] != b.visibilities[binding] ||
+                a.types[binding] != b.types[binding]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Keys like the ones applications create: a few bindings at the start of the group, with
+    // random visibilities and types.
+    std::vector<BindGroupLayoutKey> MakeKeys() {
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<uint32_t> visibility(1, 7);
+        std::uniform_int_distribution<uint32_t> type(0, 3);
+        std::uniform_int_distribution<uint32_t> bindingCount(1, 6);
+
+        std::vector<BindGroupLayoutKey> keys(4096);
+        for (auto& key : keys) {
+            uint32_t count = bindingCount(generator);
+            for (uint32_t binding = 0; binding < count; ++binding) {
+                key.mask.set(binding);
+                key.visibilities[binding] = static_cast<nxt::ShaderStageBit>(visibility(generator));
+                key.types[binding] = static_cast<nxt::BindingType>(type(generator));
+            }
+        }
+        return keys;
+    }
+
+    // The hash used before HashUtils was built on wyhash, a boost-style combine over std::hash.
+    template <typename T>
+    void LegacyHashCombine(size_t* hash, const T& value) {
+        *hash ^= std::hash<T>()(value) + 0x9e3779b97f4a7c16 + (*hash << 6) + (*hash >> 2);
+    }
+
+    struct LegacyKeyHash {
+        size_t operator()(const BindGroupLayoutKey& key) const {
+            size_t hash = std::hash<std::bitset<kMaxBindingsPerGroup>>()(key.mask);
+            for (uint32_t binding : IterateBitSet(key.mask)) {
+                LegacyHashCombine(&hash, key.visibilities[binding]);
+                LegacyHashCombine(&hash, key.types[binding]);
+            }
+            return hash;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const BindGroupLayoutKey& key) const {
+            size_t hash = Hash(key.mask);
+            for (uint32_t binding : IterateBitSet(key.mask)) {
+                HashCombine(&hash, key.visibilities[binding], key.types[binding]);
+            }
+            return hash;
+        }
+    };
+
+    // Inserts the keys in a hash set like the cache does. Reports how many keys share their
+    // bucket with a previous one in the set, which uses a prime number of buckets, and in a table
+    // of 4096 buckets indexed with the low bits of the hash like power of two sized tables do.
+    template <typename Hasher>
+    void BM_CacheKeys(benchmark::State& state) {
+        std::vector<BindGroupLayoutKey> keys = MakeKeys();
+
+        for (auto _ : state) {
+            std::unordered_set<BindGroupLayoutKey, Hasher> set;
+            for (const auto& key : keys) {
+                set.insert(key);
+            }
+            benchmark::DoNotOptimize(set.size());
+        }
+        state.SetItemsProcessed(state.iterations() * keys.size());
+
+        std::unordered_set<BindGroupLayoutKey, Hasher> set(keys.begin(), keys.end());
+        size_t collisions = 0;
+        for (size_t bucket = 0; bucket < set.bucket_count(); ++bucket) {
+            if (set.bucket_size(bucket) > 1) {
+                collisions += set.bucket_size(bucket) - 1;
+            }
+        }
+
+        std::vector<bool> lowBitsBuckets(4096, false);
+        size_t lowBitsCollisions = 0;
+        for (const auto& key : set) {
+            size_t bucket = Hasher()(key) & 4095;
+            if (lowBitsBuckets[bucket]) {
+                lowBitsCollisions++;
+            }
+            lowBitsBuckets[bucket] = true;
+        }
+
+        state.counters["uniqueKeys"] = set.size();
+        state.counters["collisions"] = collisions;
+        state.counters["lowBitsCollisions"] = lowBitsCollisions;
+    }
+    BENCHMARK_TEMPLATE(BM_CacheKeys, LegacyKeyHash);
+    BENCHMARK_TEMPLATE(BM_CacheKeys, KeyHash);
+
+    void BM_HashBytes(benchmark::State& state) {
+        std::vector<uint8_t> bytes(state.range(0), 42);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(HashBytes(bytes.data(), bytes.size()));
+        }
+        state.SetBytesProcessed(state.iterations() * bytes.size());
+    }
+    BENCHMARK(BM_HashBytes)->Arg(8)->Arg(32)->Arg(256)->Arg(4096);
+
+    // std::hash of strings is the only standard way to hash bytes.
+    void BM_StdHashString(benchmark::State& state) {
+        std::string bytes(state.range(0), 42);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(std::hash<std::string>()(bytes));
+        }
+        state.SetBytesProcessed(state.iterations() * bytes.size());
+    }
+    BENCHMARK(BM_StdHashString)->Arg(8)->Arg(32)->Arg(256)->Arg(4096);
+
+}  // anonymous namespace
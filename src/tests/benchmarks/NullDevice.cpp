@@ -0,0 +1,37 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmarks/NullDevice.h"
+
+namespace backend {
+    namespace null {
+        void Init(nxtProcTable* procs, nxtDevice* device);
+    }
+}
+
+void CreateNullDevice(nxtProcTable* procs, nxtDevice* device) {
+    backend::null::Init(procs, device);
+}
+
+const nxt::Device& GetNullDevice() {
+    static nxt::Device* device = [] {
+        nxtProcTable procs;
+        nxtDevice cDevice;
+        CreateNullDevice(&procs, &cDevice);
+        nxtSetProcs(&procs);
+
+        return new nxt::Device(nxt::Device::Acquire(cDevice));
+    }();
+    return *device;
+}
@@ -0,0 +1,28 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESTS_BENCHMARKS_NULLDEVICE_H_
+#define TESTS_BENCHMARKS_NULLDEVICE_H_
+
+#include "nxt/nxtcpp.h"
+
+// Returns a device of the null backend shared by all the benchmarks. It is created on first use
+// and never destroyed so that the procs stay valid until the process exits.
+const nxt::Device& GetNullDevice();
+
+// Creates another device of the null backend without making its procs the global procs, for
+// benchmarks like the wire server ones that call the procs directly.
+void CreateNullDevice(nxtProcTable* procs, nxtDevice* device);
+
+#endif  // TESTS_BENCHMARKS_NULLDEVICE_H_
@@ -0,0 +1,93 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmarks/NullDevice.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+    constexpr uint32_t kCopiesPerCommandBuffer = 16;
+
+    // Objects shared by all the threads of the benchmarks, they are created once and never
+    // destroyed like the device.
+    struct SharedObjects {
+        nxt::Device device;
+        nxt::Buffer source;
+        nxt::Buffer destination;
+    };
+
+    SharedObjects* GetSharedObjects() {
+        static SharedObjects* objects = [] {
+            SharedObjects* result = new SharedObjects;
+            result->device = GetNullDevice().Clone();
+            result->source = result->device.CreateBufferBuilder()
+                                 .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc)
+                                 .SetInitialUsage(nxt::BufferUsageBit::TransferSrc)
+                                 .SetSize(1024)
+                                 .GetResult();
+            result->destination = result->device.CreateBufferBuilder()
+                                      .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+                                      .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                                      .SetSize(1024)
+                                      .GetResult();
+            return result;
+        }();
+        return objects;
+    }
+
+    // Runs the benchmarks with 1, 2, 4, ... threads up to the number of hardware threads.
+    void ApplyThreadCounts(benchmark::internal::Benchmark* bench) {
+        int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int threads = 1; threads < maxThreads; threads *= 2) {
+            bench->Threads(threads);
+        }
+        bench->Threads(maxThreads);
+    }
+
+}  // anonymous namespace
+
+// Each thread records its own command buffers against the shared device and buffers, which is
+// the use case the thread-safe reference counting and caches are for.
+static void BM_RecordCommandBuffers(benchmark::State& state) {
+    SharedObjects* objects = GetSharedObjects();
+
+    for (auto _ : state) {
+        nxt::CommandBufferBuilder builder = objects->device.CreateCommandBufferBuilder();
+        for (uint32_t i = 0; i < kCopiesPerCommandBuffer; ++i) {
+            builder.CopyBufferToBuffer(objects->source, 0, objects->destination, 0, 4);
+        }
+        nxt::CommandBuffer commands = builder.GetResult();
+        benchmark::DoNotOptimize(commands.Get());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RecordCommandBuffers)->Apply(ApplyThreadCounts)->UseRealTime();
+
+// Measures the cost of the atomic reference counting when all threads hammer the same object.
+static void BM_ReferenceSharedObject(benchmark::State& state) {
+    SharedObjects* objects = GetSharedObjects();
+
+    for (auto _ : state) {
+        nxt::Buffer copy = objects->source.Clone();
+        benchmark::DoNotOptimize(copy.Get());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReferenceSharedObject)->Apply(ApplyThreadCounts)->UseRealTime();
@@ -0,0 +1,104 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/SerialQueue.h"
+
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // The previous storage of SerialQueue, a vector of serials each with its own vector of
+    // values, reduced to the operations used by the benchmarks.
+    template <typename T>
+    class VectorSerialQueue {
+      public:
+        void Enqueue(const T& value, Serial serial) {
+            if (mStorage.empty() || mStorage.back().first < serial) {
+                mStorage.emplace_back(serial, std::vector<T>());
+            }
+            mStorage.back().second.emplace_back(value);
+        }
+
+        template <typename F>
+        void IterateUpTo(Serial serial, F f) {
+            for (auto it = mStorage.begin(); it != mStorage.end() && it->first <= serial; ++it) {
+                for (T& value : it->second) {
+                    f(value);
+                }
+            }
+        }
+
+        void ClearUpTo(Serial serial) {
+            auto it = mStorage.begin();
+            while (it != mStorage.end() && it->first <= serial) {
+                it++;
+            }
+            mStorage.erase(mStorage.begin(), it);
+        }
+
+      private:
+        std::vector<std::pair<Serial, std::vector<T>>> mStorage;
+    };
+
+    // The number of serials in flight, like frames that the GPU hasn't finished yet.
+    constexpr Serial kSerialsInFlight = 3;
+
+    // Each iteration enqueues state.range(0) values for a new serial, then iterates and clears
+    // the values of the serial that completed, which is what the fenced deleters do every frame.
+    void BM_SerialQueue(benchmark::State& state) {
+        SerialQueue<uint64_t> queue;
+        uint64_t valueCount = static_cast<uint64_t>(state.range(0));
+        Serial serial = kSerialsInFlight;
+
+        for (auto _ : state) {
+            for (uint64_t i = 0; i < valueCount; ++i) {
+                queue.Enqueue(i, serial);
+            }
+
+            uint64_t sum = 0;
+            for (uint64_t value : queue.IterateUpTo(serial - kSerialsInFlight)) {
+                sum += value;
+            }
+            queue.ClearUpTo(serial - kSerialsInFlight);
+            benchmark::DoNotOptimize(sum);
+            serial++;
+        }
+        state.SetItemsProcessed(state.iterations() * valueCount);
+    }
+    BENCHMARK(BM_SerialQueue)->Arg(1)->Arg(16)->Arg(256);
+
+    void BM_VectorSerialQueue(benchmark::State& state) {
+        VectorSerialQueue<uint64_t> queue;
+        uint64_t valueCount = static_cast<uint64_t>(state.range(0));
+        Serial serial = kSerialsInFlight;
+
+        for (auto _ : state) {
+            for (uint64_t i = 0; i < valueCount; ++i) {
+                queue.Enqueue(i, serial);
+            }
+
+            uint64_t sum = 0;
+            queue.IterateUpTo(serial - kSerialsInFlight, [&sum](uint64_t value) { sum += value; });
+            queue.ClearUpTo(serial - kSerialsInFlight);
+            benchmark::DoNotOptimize(sum);
+            serial++;
+        }
+        state.SetItemsProcessed(state.iterations() * valueCount);
+    }
+    BENCHMARK(BM_VectorSerialQueue)->Arg(1)->Arg(16)->Arg(256);
+
+}  // anonymous namespace
@@ -0,0 +1,256 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/NXTHelpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace backend { namespace vulkan {
+    void Init(nxtProcTable* procs,
+              nxtDevice* device,
+              const std::vector<const char*>& requiredInstanceExtensions);
+    void SetPipelineCachePath(nxtDevice device, const char* path);
+}}  // namespace backend::vulkan
+
+// Measures the creation of the examples' pipelines at startup with an empty pipeline cache and
+// with a pipeline cache loaded from disk. Unlike the null backend benchmarks these need a Vulkan
+// device. Compiling the GLSL and destroying the device aren't part of the measured time.
+
+namespace {
+
+    constexpr char kPipelineCachePath[] = "nxt_vulkan_startup_benchmarks_pipeline_cache.bin";
+
+    nxt::Device CreateVulkanDevice() {
+        nxtProcTable procs;
+        nxtDevice cDevice;
+        backend::vulkan::Init(&procs, &cDevice, {});
+        nxtSetProcs(&procs);
+        return nxt::Device::Acquire(cDevice);
+    }
+
+    struct ExampleShaders {
+        nxt::ShaderModule helloTriangleVS;
+        nxt::ShaderModule helloTriangleFS;
+        nxt::ShaderModule animometerVS;
+        nxt::ShaderModule animometerFS;
+        nxt::ShaderModule computeBoidsVS;
+        nxt::ShaderModule computeBoidsFS;
+        nxt::ShaderModule helloComputeCS;
+    };
+
+    // The shaders are the ones of the examples with the same names.
+    ExampleShaders CreateExampleShaders(const nxt::Device& device) {
+        ExampleShaders shaders;
+        shaders.helloTriangleVS =
+            utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                layout(location = 0) in vec4 pos;
+                void main() {
+                    gl_Position = pos;
+                })");
+        shaders.helloTriangleFS =
+            utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(set = 0, binding = 0) uniform sampler mySampler;
+                layout(set = 0, binding = 1) uniform texture2D myTexture;
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = texture(sampler2D(myTexture, mySampler),
+                                        gl_FragCoord.xy / vec2(640.0, 480.0));
+                })");
+        shaders.animometerVS = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+            #version 450
+            layout(push_constant) uniform ConstantsBlock {
+                float scale;
+                float time;
+                float offsetX;
+                float offsetY;
+                float scalar;
+                float scalarOffset;
+            } c;
+            layout(location = 0) out vec4 v_color;
+            const vec4 positions[3] = vec4[3](
+                vec4( 0.0f,  0.1f, 0.0f, 1.0f),
+                vec4(-0.1f, -0.1f, 0.0f, 1.0f),
+                vec4( 0.1f, -0.1f, 0.0f, 1.0f)
+            );
+            const vec4 colors[3] = vec4[3](
+                vec4(1.0f, 0.0f, 0.0f, 1.0f),
+                vec4(0.0f, 1.0f, 0.0f, 1.0f),
+                vec4(0.0f, 0.0f, 1.0f, 1.0f)
+            );
+            void main() {
+                vec4 position = positions[gl_VertexIndex];
+                vec4 color = colors[gl_VertexIndex];
+                float fade = mod(c.scalarOffset + c.time * c.scalar / 10.0, 1.0);
+                if (fade < 0.5) {
+                    fade = fade * 2.0;
+                } else {
+                    fade = (1.0 - fade) * 2.0;
+                }
+                float xpos = position.x * c.scale;
+                float ypos = position.y * c.scale;
+                float angle = 3.14159 * 2.0 * fade;
+                float xrot = xpos * cos(angle) - ypos * sin(angle);
+                float yrot = xpos * sin(angle) + ypos * cos(angle);
+                xpos = xrot + c.offsetX;
+                ypos = yrot + c.offsetY;
+                v_color = vec4(fade, 1.0 - fade, 0.0, 1.0) + color;
+                gl_Position = vec4(xpos, ypos, 0.0, 1.0);
+            })");
+        shaders.animometerFS = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+            #version 450
+            layout(location = 0) out vec4 fragColor;
+            layout(location = 0) in vec4 v_color;
+            void main() {
+                fragColor = v_color;
+            })");
+        shaders.computeBoidsVS = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+            #version 450
+            layout(location = 0) in vec2 a_particlePos;
+            layout(location = 1) in vec2 a_particleVel;
+            layout(location = 2) in vec2 a_pos;
+            void main() {
+                float angle = -atan(a_particleVel.x, a_particleVel.y);
+                vec2 pos = vec2(a_pos.x * cos(angle) - a_pos.y * sin(angle),
+                                a_pos.x * sin(angle) + a_pos.y * cos(angle));
+                gl_Position = vec4(pos + a_particlePos, 0, 1);
+            })");
+        shaders.computeBoidsFS =
+            utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(1.0);
+                })");
+        shaders.helloComputeCS = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+            #version 450
+            layout(set = 0, binding = 0) buffer myBlock {
+                int a;
+                float b;
+            } myStorage;
+            void main() {
+                myStorage.a = (myStorage.a + 1) % 256;
+                myStorage.b = mod((myStorage.b + 0.02), 1.0);
+            })");
+        return shaders;
+    }
+
+    void CreateExamplePipelines(const nxt::Device& device, const ExampleShaders& shaders) {
+        nxt::BindGroupLayout textureLayout =
+            device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Fragment, nxt::BindingType::Sampler, 0, 1)
+                .SetBindingsType(nxt::ShaderStageBit::Fragment, nxt::BindingType::SampledTexture,
+                                 1, 1)
+                .GetResult();
+        nxt::PipelineLayout helloTriangleLayout =
+            device.CreatePipelineLayoutBuilder().SetBindGroupLayout(0, textureLayout).GetResult();
+        nxt::InputState helloTriangleInput =
+            device.CreateInputStateBuilder()
+                .SetAttribute(0, 0, nxt::VertexFormat::FloatR32G32B32A32, 0)
+                .SetInput(0, 4 * sizeof(float), nxt::InputStepMode::Vertex)
+                .GetResult();
+        nxt::RenderPipeline helloTriangle =
+            device.CreateRenderPipelineBuilder()
+                .SetColorAttachmentFormat(0, nxt::TextureFormat::B8G8R8A8Unorm)
+                .SetDepthStencilAttachmentFormat(nxt::TextureFormat::D32FloatS8Uint)
+                .SetLayout(helloTriangleLayout)
+                .SetStage(nxt::ShaderStage::Vertex, shaders.helloTriangleVS, "main")
+                .SetStage(nxt::ShaderStage::Fragment, shaders.helloTriangleFS, "main")
+                .SetIndexFormat(nxt::IndexFormat::Uint32)
+                .SetInputState(helloTriangleInput)
+                .GetResult();
+
+        nxt::RenderPipeline animometer =
+            device.CreateRenderPipelineBuilder()
+                .SetColorAttachmentFormat(0, nxt::TextureFormat::B8G8R8A8Unorm)
+                .SetDepthStencilAttachmentFormat(nxt::TextureFormat::D32FloatS8Uint)
+                .SetStage(nxt::ShaderStage::Vertex, shaders.animometerVS, "main")
+                .SetStage(nxt::ShaderStage::Fragment, shaders.animometerFS, "main")
+                .GetResult();
+
+        nxt::InputState computeBoidsInput =
+            device.CreateInputStateBuilder()
+                .SetAttribute(0, 0, nxt::VertexFormat::FloatR32G32, 0)
+                .SetAttribute(1, 0, nxt::VertexFormat::FloatR32G32, 2 * sizeof(float))
+                .SetInput(0, 4 * sizeof(float), nxt::InputStepMode::Instance)
+                .SetAttribute(2, 1, nxt::VertexFormat::FloatR32G32, 0)
+                .SetInput(1, 2 * sizeof(float), nxt::InputStepMode::Vertex)
+                .GetResult();
+        nxt::RenderPipeline computeBoids =
+            device.CreateRenderPipelineBuilder()
+                .SetColorAttachmentFormat(0, nxt::TextureFormat::B8G8R8A8Unorm)
+                .SetDepthStencilAttachmentFormat(nxt::TextureFormat::D32FloatS8Uint)
+                .SetStage(nxt::ShaderStage::Vertex, shaders.computeBoidsVS, "main")
+                .SetStage(nxt::ShaderStage::Fragment, shaders.computeBoidsFS, "main")
+                .SetInputState(computeBoidsInput)
+                .GetResult();
+
+        nxt::BindGroupLayout storageLayout =
+            device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Compute, nxt::BindingType::StorageBuffer, 0,
+                                 1)
+                .GetResult();
+        nxt::PipelineLayout helloComputeLayout =
+            device.CreatePipelineLayoutBuilder().SetBindGroupLayout(0, storageLayout).GetResult();
+        nxt::ComputePipeline helloCompute =
+            device.CreateComputePipelineBuilder()
+                .SetLayout(helloComputeLayout)
+                .SetStage(nxt::ShaderStage::Compute, shaders.helloComputeCS, "main")
+                .GetResult();
+    }
+
+    void RunStartup(benchmark::State& state, const char* pipelineCachePath) {
+        for (auto _ : state) {
+            state.PauseTiming();
+            nxt::Device device = CreateVulkanDevice();
+            ExampleShaders shaders = CreateExampleShaders(device);
+            state.ResumeTiming();
+
+            // Loading the pipeline cache is part of the startup cost it saves.
+            if (pipelineCachePath != nullptr) {
+                backend::vulkan::SetPipelineCachePath(device.Get(), pipelineCachePath);
+            }
+            CreateExamplePipelines(device, shaders);
+
+            state.PauseTiming();
+            shaders = ExampleShaders();
+            device = nxt::Device();
+            state.ResumeTiming();
+        }
+    }
+
+}  // anonymous namespace
+
+static void BM_PipelineStartup_ColdCache(benchmark::State& state) {
+    RunStartup(state, nullptr);
+}
+BENCHMARK(BM_PipelineStartup_ColdCache)->Unit(benchmark::kMillisecond);
+
+static void BM_PipelineStartup_WarmCache(benchmark::State& state) {
+    // Fill the cache file once so that every iteration starts with the pipelines on disk.
+    {
+        nxt::Device device = CreateVulkanDevice();
+        ExampleShaders shaders = CreateExampleShaders(device);
+        backend::vulkan::SetPipelineCachePath(device.Get(), kPipelineCachePath);
+        CreateExamplePipelines(device, shaders);
+    }
+
+    RunStartup(state, kPipelineCachePath);
+    remove(kPipelineCachePath);
+}
+BENCHMARK(BM_PipelineStartup_WarmCache)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,168 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/benchmarks/NullDevice.h"
+
+#include "wire/Wire.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// Measures the serialization of a frame of commands by the wire client, and its decoding by the
+// wire server running on the null backend. The procs of the client are called directly because
+// the global procs are the ones of the null device used by the other benchmarks.
+
+namespace {
+
+    constexpr uint32_t kCopiesPerFrame = 16;
+
+    // Keeps the serialized commands until they are cleared, instead of sending them somewhere.
+    class BufferSerializer : public nxt::wire::CommandSerializer {
+      public:
+        void* GetCmdSpace(size_t size) override {
+            if (mOffset + size > mBuffer.size()) {
+                mBuffer.resize(2 * (mOffset + size));
+            }
+            uint8_t* result = &mBuffer[mOffset];
+            mOffset += size;
+            return result;
+        }
+
+        void Flush() override {
+        }
+
+        const uint8_t* GetCommands() const {
+            return mBuffer.data();
+        }
+        size_t GetSize() const {
+            return mOffset;
+        }
+        void Clear() {
+            mOffset = 0;
+        }
+
+      private:
+        std::vector<uint8_t> mBuffer;
+        size_t mOffset = 0;
+    };
+
+    struct WireObjects {
+        BufferSerializer clientCommands;
+        BufferSerializer serverCommands;
+        nxt::wire::CommandHandler* client = nullptr;
+        nxt::wire::CommandHandler* server = nullptr;
+
+        nxtProcTable procs;
+        nxtDevice device;
+        nxtBuffer source;
+        nxtBuffer destination;
+        nxtQueue queue;
+
+        // The commands of one frame, they leave the server in the state they found it in so
+        // they can be decoded repeatedly.
+        std::vector<uint8_t> frame;
+    };
+
+    nxtBuffer CreateFrozenBuffer(const WireObjects* objects, nxtBufferUsageBit usage) {
+        const nxtProcTable& procs = objects->procs;
+
+        nxtBufferBuilder builder = procs.deviceCreateBufferBuilder(objects->device);
+        procs.bufferBuilderSetAllowedUsage(builder, usage);
+        procs.bufferBuilderSetSize(builder, 1024);
+        nxtBuffer buffer = procs.bufferBuilderGetResult(builder);
+        procs.bufferBuilderRelease(builder);
+
+        procs.bufferFreezeUsage(buffer, usage);
+        return buffer;
+    }
+
+    // Records a command buffer of copies, submits it and releases it.
+    void SerializeFrame(const WireObjects* objects) {
+        const nxtProcTable& procs = objects->procs;
+
+        nxtCommandBufferBuilder builder = procs.deviceCreateCommandBufferBuilder(objects->device);
+        for (uint32_t i = 0; i < kCopiesPerFrame; ++i) {
+            procs.commandBufferBuilderCopyBufferToBuffer(builder, objects->source, 0,
+                                                         objects->destination, 0, 4);
+        }
+        nxtCommandBuffer commands = procs.commandBufferBuilderGetResult(builder);
+        procs.queueSubmit(objects->queue, 1, &commands);
+
+        procs.commandBufferBuilderRelease(builder);
+        procs.commandBufferRelease(commands);
+    }
+
+    WireObjects* GetWireObjects() {
+        static WireObjects* objects = [] {
+            WireObjects* result = new WireObjects;
+
+            nxtProcTable serverProcs;
+            nxtDevice serverDevice;
+            CreateNullDevice(&serverProcs, &serverDevice);
+            result->server = nxt::wire::NewServerCommandHandler(serverDevice, serverProcs,
+                                                                 &result->serverCommands);
+            result->client = nxt::wire::NewClientDevice(&result->procs, &result->device,
+                                                         &result->clientCommands);
+
+            result->source = CreateFrozenBuffer(result, NXT_BUFFER_USAGE_BIT_TRANSFER_SRC);
+            result->destination = CreateFrozenBuffer(result, NXT_BUFFER_USAGE_BIT_TRANSFER_DST);
+            nxtQueueBuilder queueBuilder = result->procs.deviceCreateQueueBuilder(result->device);
+            result->queue = result->procs.queueBuilderGetResult(queueBuilder);
+            result->procs.queueBuilderRelease(queueBuilder);
+
+            // Create the objects used by the frame on the server.
+            result->server->HandleCommands(result->clientCommands.GetCommands(),
+                                           result->clientCommands.GetSize());
+            result->clientCommands.Clear();
+
+            SerializeFrame(result);
+            result->frame.assign(result->clientCommands.GetCommands(),
+                                 result->clientCommands.GetCommands() +
+                                     result->clientCommands.GetSize());
+            result->clientCommands.Clear();
+            return result;
+        }();
+        return objects;
+    }
+
+}  // anonymous namespace
+
+static void BM_WireClientSerializeFrame(benchmark::State& state) {
+    WireObjects* objects = GetWireObjects();
+
+    for (auto _ : state) {
+        SerializeFrame(objects);
+        objects->clientCommands.Clear();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * objects->frame.size());
+}
+BENCHMARK(BM_WireClientSerializeFrame);
+
+static void BM_WireServerDecodeFrame(benchmark::State& state) {
+    WireObjects* objects = GetWireObjects();
+
+    for (auto _ : state) {
+        const uint8_t* end =
+            objects->server->HandleCommands(objects->frame.data(), objects->frame.size());
+        benchmark::DoNotOptimize(end);
+        objects->serverCommands.Clear();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * objects->frame.size());
+}
+BENCHMARK(BM_WireServerDecodeFrame);
@@ -0,0 +1,227 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/BackendBinding.h"
+#include "utils/NXTHelpers.h"
+
+// Tests of the statistics reported by the backends through utils::BackendBinding. Backends that
+// don't report a statistic make the query return false, in which case the test does nothing.
+class BackendStatisticsTests : public NXTTest {
+    protected:
+        // Sums the statistics of all the memory heaps.
+        bool GetTotalHeapBytes(uint64_t* allocatedBytes, uint64_t* usedBytes) {
+            *allocatedBytes = 0;
+            *usedBytes = 0;
+
+            uint32_t heapIndex = 0;
+            uint64_t heapAllocatedBytes = 0;
+            uint64_t heapUsedBytes = 0;
+            float fragmentation = 0.0f;
+            while (GetBinding()->GetMemoryHeapStats(heapIndex, &heapAllocatedBytes, &heapUsedBytes,
+                                                    &fragmentation)) {
+                EXPECT_LE(heapUsedBytes, heapAllocatedBytes);
+                EXPECT_GE(fragmentation, 0.0f);
+                EXPECT_LE(fragmentation, 1.0f);
+
+                *allocatedBytes += heapAllocatedBytes;
+                *usedBytes += heapUsedBytes;
+                heapIndex++;
+            }
+            return heapIndex > 0;
+        }
+
+        void SubmitRenderPass(const utils::BasicRenderPass& renderPass) {
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .BeginRenderPass(renderPass.renderPassInfo)
+                .EndRenderPass()
+                .GetResult();
+            queue.Submit(1, &commands);
+        }
+};
+
+// Test that the memory of a buffer is counted as used until the buffer is destroyed and the GPU is
+// done with it.
+TEST_P(BackendStatisticsTests, MemoryHeapStats) {
+    uint64_t allocatedBefore = 0;
+    uint64_t usedBefore = 0;
+    if (!GetTotalHeapBytes(&allocatedBefore, &usedBefore)) {
+        return;
+    }
+
+    constexpr uint32_t kBufferSize = 1024 * 1024;
+    nxt::Buffer buffer = device.CreateBufferBuilder()
+        .SetSize(kBufferSize)
+        .SetAllowedUsage(nxt::BufferUsageBit::Vertex)
+        .SetInitialUsage(nxt::BufferUsageBit::Vertex)
+        .GetResult();
+
+    uint64_t allocated = 0;
+    uint64_t used = 0;
+    ASSERT_TRUE(GetTotalHeapBytes(&allocated, &used));
+    EXPECT_GE(allocated, allocatedBefore + kBufferSize);
+    EXPECT_GE(used, usedBefore + kBufferSize);
+
+    // The memory is reused once the commands of the serial in which the buffer was destroyed are
+    // completed, which takes a few ticks.
+    buffer = nxt::Buffer();
+    for (uint32_t i = 0; i < 10 && used != usedBefore; ++i) {
+        WaitABit();
+        ASSERT_TRUE(GetTotalHeapBytes(&allocated, &used));
+    }
+    EXPECT_EQ(usedBefore, used);
+}
+
+// Test that a render pass drawing to the same attachments again reuses the framebuffer created the
+// first time.
+TEST_P(BackendStatisticsTests, FramebufferCacheCounts) {
+    uint64_t hitsBefore = 0;
+    uint64_t missesBefore = 0;
+    if (!GetBinding()->GetFramebufferCacheCounts(&hitsBefore, &missesBefore)) {
+        return;
+    }
+
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 4, 4);
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    SubmitRenderPass(renderPass);
+    ASSERT_TRUE(GetBinding()->GetFramebufferCacheCounts(&hits, &misses));
+    EXPECT_EQ(hitsBefore, hits);
+    EXPECT_EQ(missesBefore + 1, misses);
+
+    SubmitRenderPass(renderPass);
+    ASSERT_TRUE(GetBinding()->GetFramebufferCacheCounts(&hits, &misses));
+    EXPECT_EQ(hitsBefore + 1, hits);
+    EXPECT_EQ(missesBefore + 1, misses);
+}
+
+// Test that the render pass of a basic render pass was created when the device was created and is
+// reused when a render pass begins.
+TEST_P(BackendStatisticsTests, RenderPassCachePrewarmed) {
+    uint64_t hitsBefore = 0;
+    uint64_t missesBefore = 0;
+    uint64_t evictionsBefore = 0;
+    if (!GetBinding()->GetRenderPassCacheCounts(&hitsBefore, &missesBefore, &evictionsBefore)) {
+        return;
+    }
+
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 4, 4);
+    SubmitRenderPass(renderPass);
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    ASSERT_TRUE(GetBinding()->GetRenderPassCacheCounts(&hits, &misses, &evictions));
+    EXPECT_EQ(hitsBefore + 1, hits);
+    EXPECT_EQ(missesBefore, misses);
+    EXPECT_EQ(evictionsBefore, evictions);
+}
+
+// Test that the transitions needed before a copy are done with a single pipeline barrier.
+TEST_P(BackendStatisticsTests, PipelineBarriersBatched) {
+    nxt::Buffer source = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+    nxt::Buffer destination = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferSrc)
+        .GetResult();
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionBufferUsage(source, nxt::BufferUsageBit::TransferSrc)
+        .TransitionBufferUsage(destination, nxt::BufferUsageBit::TransferDst)
+        .CopyBufferToBuffer(source, 0, destination, 0, 4)
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    uint64_t barrierCount = 0;
+    if (!GetBinding()->GetPipelineBarrierCount(commands.Get(), &barrierCount)) {
+        return;
+    }
+    EXPECT_EQ(1u, barrierCount);
+}
+
+// Test that transitions between read-only usages don't need a pipeline barrier.
+TEST_P(BackendStatisticsTests, ReadOnlyTransitionsSkipped) {
+    nxt::Buffer source = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::Vertex)
+        .SetInitialUsage(nxt::BufferUsageBit::Vertex)
+        .GetResult();
+    nxt::Buffer destination = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionBufferUsage(source, nxt::BufferUsageBit::TransferSrc)
+        .CopyBufferToBuffer(source, 0, destination, 0, 4)
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    uint64_t barrierCount = 0;
+    if (!GetBinding()->GetPipelineBarrierCount(commands.Get(), &barrierCount)) {
+        return;
+    }
+    EXPECT_EQ(0u, barrierCount);
+}
+
+// Test that with submit coalescing, Tick only submits the uploads once enough of them are pending.
+TEST_P(BackendStatisticsTests, SubmitCoalescing) {
+    // Submit the commands recorded before coalescing is enabled.
+    device.Tick();
+    if (!GetBinding()->SetSubmitCoalescing(2, 0)) {
+        return;
+    }
+    // Tick would never submit the uploads without any threshold.
+    EXPECT_FALSE(GetBinding()->SetSubmitCoalescing(0, 0));
+
+    nxt::Buffer buffer = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+
+    uint64_t submitsBefore = 0;
+    uint64_t submitsLastFrame = 0;
+    ASSERT_TRUE(GetBinding()->GetSubmitCounts(&submitsBefore, &submitsLastFrame));
+
+    uint32_t value = 1;
+    buffer.SetSubData(0, sizeof(value), reinterpret_cast<uint8_t*>(&value));
+    device.Tick();
+
+    uint64_t submits = 0;
+    ASSERT_TRUE(GetBinding()->GetSubmitCounts(&submits, &submitsLastFrame));
+    EXPECT_EQ(submitsBefore, submits);
+
+    value = 2;
+    buffer.SetSubData(0, sizeof(value), reinterpret_cast<uint8_t*>(&value));
+    device.Tick();
+
+    ASSERT_TRUE(GetBinding()->GetSubmitCounts(&submits, &submitsLastFrame));
+    EXPECT_EQ(submitsBefore + 1, submits);
+    EXPECT_BUFFER_U32_EQ(value, buffer, 0);
+}
+
+NXT_INSTANTIATE_TEST(BackendStatisticsTests,
+                     D3D12Backend,
+                     MetalBackend,
+                     OpenGLBackend,
+                     VulkanBackend)
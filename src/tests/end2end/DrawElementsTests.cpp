@@ -106,4 +106,25 @@ TEST_P(DrawElementsTest, Uint32) {
     Test(6, 1, 0, 0, filled, filled);
 }
 
+// Test drawing with a vertex buffer created after the previous one was destroyed, backends caching
+// state per buffer handle must not reuse the state of the destroyed buffer.
+TEST_P(DrawElementsTest, RecreatedVertexBuffer) {
+    RGBA8 filled(0, 255, 0, 255);
+    RGBA8 notFilled(0, 0, 0, 0);
+
+    Test(6, 1, 0, 0, filled, filled);
+
+    // Destroy the vertex buffer before creating the new one so that its handle can be reused.
+    vertexBuffer = nxt::Buffer();
+    vertexBuffer = utils::CreateFrozenBufferFromData<float>(device, nxt::BufferUsageBit::Vertex, {
+        0.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 1.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 0.0f, 1.0f
+    });
+
+    // The quad only covers the top right quarter of the render target.
+    Test(6, 1, 0, 0, notFilled, filled);
+}
+
 NXT_INSTANTIATE_TEST(DrawElementsTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
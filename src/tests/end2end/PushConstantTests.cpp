@@ -394,4 +394,76 @@ TEST_P(PushConstantTest, SimultaneousVertexAndFragmentConstants) {
 
     EXPECT_PIXEL_RGBA8_EQ(RGBA8(1, 1, 0, 0), renderPass.color, 0, 0);
 }
+
+// Test consecutive draws that only differ by their vertex push constants, which the OpenGL backend
+// batches in a single multi-draw.
+TEST_P(PushConstantTest, ConsecutiveDrawsWithDifferentVertexConstants) {
+    utils::BasicRenderPass renderPass = utils::CreateBasicRenderPass(device, 1, 1);
+
+    nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+        #version 450
+        layout(push_constant) uniform ConstantsBlock {
+            float red;
+            float alpha;
+        } c;
+        layout(location = 0) out vec2 redAndAlpha;
+        void main() {
+            redAndAlpha = vec2(c.red, c.alpha);
+            gl_Position = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        })"
+    );
+    nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+        #version 450
+        layout(push_constant) uniform ConstantsBlock {
+            float green;
+        } c;
+        layout(location = 0) out vec4 color;
+        layout(location = 0) in vec2 redAndAlpha;
+        void main() {
+            color = vec4(redAndAlpha.x, c.green, 0.0f, redAndAlpha.y);
+        })"
+    );
+
+    nxt::BlendState blendState = device.CreateBlendStateBuilder()
+        .SetBlendEnabled(true)
+        .SetColorBlend(nxt::BlendOperation::Add, nxt::BlendFactor::One, nxt::BlendFactor::One)
+        .SetAlphaBlend(nxt::BlendOperation::Add, nxt::BlendFactor::One, nxt::BlendFactor::One)
+        .GetResult();
+
+    nxt::RenderPipeline pipeline = device.CreateRenderPipelineBuilder()
+        .SetColorAttachmentFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetLayout(MakeEmptyLayout())
+        .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+        .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+        .SetPrimitiveTopology(nxt::PrimitiveTopology::PointList)
+        .SetColorAttachmentBlendState(0, blendState)
+        .GetResult();
+
+    // Each draw adds its own red and alpha values, and the green value set once.
+    constexpr uint32_t kDrawCount = 4;
+    std::array<std::array<float, 2>, kDrawCount> vertexConstants = {{
+        {{1.0f / 255.0f, 0.0f}},
+        {{2.0f / 255.0f, 1.0f / 255.0f}},
+        {{3.0f / 255.0f, 0.0f}},
+        {{4.0f / 255.0f, 2.0f / 255.0f}},
+    }};
+    float green = 1.0f / 255.0f;
+
+    nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+    builder.BeginRenderPass(renderPass.renderPassInfo)
+        .SetRenderPipeline(pipeline)
+        .SetPushConstants(nxt::ShaderStageBit::Fragment, 0, 1,
+                          reinterpret_cast<uint32_t*>(&green));
+    for (const auto& constants : vertexConstants) {
+        builder.SetPushConstants(nxt::ShaderStageBit::Vertex, 0, 2,
+                                 reinterpret_cast<const uint32_t*>(constants.data()))
+            .DrawArrays(1, 1, 0, 0);
+    }
+    nxt::CommandBuffer commands = builder.EndRenderPass().GetResult();
+
+    queue.Submit(1, &commands);
+
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8(10, 4, 0, 3), renderPass.color, 0, 0);
+}
+
 NXT_INSTANTIATE_TEST(PushConstantTest, MetalBackend, OpenGLBackend)
@@ -0,0 +1,85 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/BackendBinding.h"
+
+class QueueSerialTests : public NXTTest {
+    protected:
+        void SubmitCopy() {
+            nxt::Buffer buffer = device.CreateBufferBuilder()
+                .SetSize(4)
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc |
+                                 nxt::BufferUsageBit::TransferDst)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+            uint32_t value = 42;
+            buffer.SetSubData(0, sizeof(value), reinterpret_cast<uint8_t*>(&value));
+
+            nxt::Buffer copyDst = device.CreateBufferBuilder()
+                .SetSize(4)
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferSrc)
+                .CopyBufferToBuffer(buffer, 0, copyDst, 0, 4)
+                .GetResult();
+            queue.Submit(1, &commands);
+        }
+};
+
+// Test that waiting on the last submitted serial returns once its work completed.
+TEST_P(QueueSerialTests, WaitForSubmittedSerial) {
+    SubmitCopy();
+
+    uint64_t lastSubmittedSerial = 0;
+    uint64_t completedSerial = 0;
+    if (!GetBinding()->GetSerials(&lastSubmittedSerial, &completedSerial)) {
+        return;
+    }
+
+    constexpr uint64_t kTimeoutNs = 1000ull * 1000 * 1000;
+    EXPECT_TRUE(GetBinding()->WaitForSerial(lastSubmittedSerial, kTimeoutNs));
+
+    uint64_t newLastSubmittedSerial = 0;
+    ASSERT_TRUE(GetBinding()->GetSerials(&newLastSubmittedSerial, &completedSerial));
+    EXPECT_GE(completedSerial, lastSubmittedSerial);
+}
+
+// Test that waiting on a serial that was never submitted times out instead of blocking.
+TEST_P(QueueSerialTests, WaitForUnsubmittedSerialTimesOut) {
+    SubmitCopy();
+
+    uint64_t lastSubmittedSerial = 0;
+    uint64_t completedSerial = 0;
+    if (!GetBinding()->GetSerials(&lastSubmittedSerial, &completedSerial)) {
+        return;
+    }
+
+    // The serial after the next one can't be pending so no work will ever complete it.
+    uint64_t serial = lastSubmittedSerial + 2;
+    EXPECT_FALSE(GetBinding()->WaitForSerial(serial, 0));
+
+    ASSERT_TRUE(GetBinding()->GetSerials(&lastSubmittedSerial, &completedSerial));
+    EXPECT_LT(completedSerial, serial);
+}
+
+NXT_INSTANTIATE_TEST(QueueSerialTests,
+                     D3D12Backend,
+                     MetalBackend,
+                     OpenGLBackend,
+                     VulkanBackend)
@@ -16,6 +16,9 @@
 
 #include "common/BitSetIterator.h"
 
+#include <set>
+#include <vector>
+
 // This is ANGLE's BitSetIterator_unittests.cpp file.
 
 class BitSetIteratorTest : public testing::Test {
@@ -82,3 +85,54 @@ TEST_F(BitSetIteratorTest, NonLValueBitset) {
 
     EXPECT_EQ((mStateBits & otherBits).count(), seenBits.size());
 }
+
+// Test the highest bit of a bitset of 64 bits, which uses the uint64_t iterator.
+TEST(BitSetIterator64, HighestBit) {
+    std::bitset<64> bits;
+    bits.set(0);
+    bits.set(31);
+    bits.set(32);
+    bits.set(63);
+
+    std::vector<uint32_t> seenBits;
+    for (uint32_t bit : IterateBitSet(bits)) {
+        seenBits.push_back(bit);
+    }
+
+    ASSERT_EQ(4u, seenBits.size());
+    EXPECT_EQ(0u, seenBits[0]);
+    EXPECT_EQ(31u, seenBits[1]);
+    EXPECT_EQ(32u, seenBits[2]);
+    EXPECT_EQ(63u, seenBits[3]);
+}
+
+// Test iterating over an integer mask.
+TEST(BitSetIterator64, IntegerMask) {
+    std::vector<uint32_t> seenBits;
+    for (uint32_t bit : BitSetIterator<64, uint32_t>(0x8000000000000005ull)) {
+        seenBits.push_back(bit);
+    }
+
+    ASSERT_EQ(3u, seenBits.size());
+    EXPECT_EQ(0u, seenBits[0]);
+    EXPECT_EQ(2u, seenBits[1]);
+    EXPECT_EQ(63u, seenBits[2]);
+}
+
+// Test a bitset larger than 64 bits, which uses the generic iterator.
+TEST(BitSetIteratorLarge, Iterator) {
+    std::bitset<100> bits;
+    bits.set(3);
+    bits.set(64);
+    bits.set(99);
+
+    std::vector<uint32_t> seenBits;
+    for (uint32_t bit : IterateBitSet(bits)) {
+        seenBits.push_back(bit);
+    }
+
+    ASSERT_EQ(3u, seenBits.size());
+    EXPECT_EQ(3u, seenBits[0]);
+    EXPECT_EQ(64u, seenBits[1]);
+    EXPECT_EQ(99u, seenBits[2]);
+}
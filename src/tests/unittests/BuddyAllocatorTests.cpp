@@ -0,0 +1,75 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/BuddyAllocator.h"
+
+// Test that allocations are split from the whole range and merged back on free.
+TEST(BuddyAllocator, SplitAndMerge) {
+    BuddyAllocator allocator(1024, 64);
+    ASSERT_EQ(1024u, allocator.GetLargestFreeRangeSize());
+
+    uint64_t a = allocator.Allocate(64);
+    uint64_t b = allocator.Allocate(64);
+    ASSERT_EQ(0u, a);
+    ASSERT_EQ(64u, b);
+    ASSERT_EQ(128u, allocator.GetUsedSize());
+    ASSERT_EQ(512u, allocator.GetLargestFreeRangeSize());
+
+    allocator.Free(a);
+    allocator.Free(b);
+    ASSERT_EQ(0u, allocator.GetUsedSize());
+    ASSERT_EQ(1024u, allocator.GetLargestFreeRangeSize());
+}
+
+// Test that sizes are rounded up to a power of two of at least the minimum allocation size.
+TEST(BuddyAllocator, SizeRounding) {
+    BuddyAllocator allocator(1024, 64);
+
+    allocator.Allocate(1);
+    ASSERT_EQ(64u, allocator.GetUsedSize());
+
+    allocator.Allocate(65);
+    ASSERT_EQ(64u + 128u, allocator.GetUsedSize());
+}
+
+// Test that the alignment requirement is honored.
+TEST(BuddyAllocator, Alignment) {
+    BuddyAllocator allocator(1024, 64);
+
+    uint64_t a = allocator.Allocate(64);
+    uint64_t b = allocator.Allocate(64, 256);
+    ASSERT_EQ(0u, a);
+    ASSERT_EQ(0u, b % 256);
+    ASSERT_NE(a, b);
+}
+
+// Test that allocation fails when there isn't a big enough free range.
+TEST(BuddyAllocator, OutOfSpace) {
+    BuddyAllocator allocator(1024, 64);
+
+    ASSERT_EQ(BuddyAllocator::kInvalidOffset, allocator.Allocate(2048));
+
+    uint64_t a = allocator.Allocate(512);
+    uint64_t b = allocator.Allocate(64);
+    ASSERT_NE(BuddyAllocator::kInvalidOffset, a);
+    ASSERT_NE(BuddyAllocator::kInvalidOffset, b);
+
+    // The other half is split so a 512 allocation doesn't fit anymore.
+    ASSERT_EQ(BuddyAllocator::kInvalidOffset, allocator.Allocate(512));
+
+    allocator.Free(b);
+    ASSERT_NE(BuddyAllocator::kInvalidOffset, allocator.Allocate(512));
+}
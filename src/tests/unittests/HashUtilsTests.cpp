@@ -0,0 +1,74 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/HashUtils.h"
+
+#include <array>
+#include <set>
+
+// Test that the hashes of consecutive integers don't all land in the same few buckets, which is
+// what happens with std::hash when it is the identity and the keys are multiples of a power of 2.
+TEST(HashUtils, IntegersAreSpreadInBuckets) {
+    constexpr size_t kBucketCount = 64;
+    std::array<uint32_t, kBucketCount> bucketSizes = {};
+
+    for (uint32_t i = 0; i < 64 * kBucketCount; ++i) {
+        bucketSizes[Hash(i * 256) % kBucketCount]++;
+    }
+
+    // On average each bucket has 64 values.
+    for (uint32_t size : bucketSizes) {
+        EXPECT_GT(size, 32u);
+        EXPECT_LT(size, 96u);
+    }
+}
+
+// Test that HashCombine depends on the order of the values
+TEST(HashUtils, HashCombineIsOrderDependent) {
+    size_t hashAB = Hash(0);
+    HashCombine(&hashAB, 1, 2);
+
+    size_t hashBA = Hash(0);
+    HashCombine(&hashBA, 2, 1);
+
+    EXPECT_NE(hashAB, hashBA);
+}
+
+// Test that HashBytes depends on every byte, the size and the seed, including around the size
+// boundaries of the algorithm (4, 16 and 48 bytes).
+TEST(HashUtils, HashBytes) {
+    std::array<uint8_t, 100> bytes = {};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    std::set<size_t> hashes;
+    for (size_t size = 0; size <= bytes.size(); ++size) {
+        size_t hash = HashBytes(bytes.data(), size);
+        EXPECT_EQ(hash, HashBytes(bytes.data(), size));
+        EXPECT_NE(hash, HashBytes(bytes.data(), size, 1));
+        hashes.insert(hash);
+
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] ^= 1;
+            hashes.insert(HashBytes(bytes.data(), size));
+            bytes[i] ^= 1;
+        }
+    }
+
+    // One hash per size and one per byte of each size.
+    EXPECT_EQ(101u + 100u * 101u / 2u, hashes.size());
+}
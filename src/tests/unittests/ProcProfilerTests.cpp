@@ -0,0 +1,87 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "backend/ProcProfiler.h"
+
+#include <thread>
+#include <vector>
+
+using namespace backend;
+
+// Test that calls and validation failures are counted
+TEST(ProcProfiler, Counters) {
+    EntryPointProfile profile("nxtTestEntryPoint");
+    ASSERT_EQ(profile.GetCallCount(), 0u);
+    ASSERT_EQ(profile.GetPercentileTimeNs(50.0), 0u);
+
+    profile.RecordCall(10, false);
+    profile.RecordCall(20, true);
+    profile.RecordCall(30, false);
+
+    ASSERT_EQ(profile.GetCallCount(), 3u);
+    ASSERT_EQ(profile.GetValidationFailureCount(), 1u);
+    ASSERT_EQ(profile.GetTotalTimeNs(), 60u);
+}
+
+// Test that percentiles are the upper bound of the power of two bucket containing them
+TEST(ProcProfiler, Percentiles) {
+    EntryPointProfile profile("nxtTestEntryPoint");
+
+    for (uint32_t i = 0; i < 90; ++i) {
+        profile.RecordCall(100, false);
+    }
+    for (uint32_t i = 0; i < 10; ++i) {
+        profile.RecordCall(5000, false);
+    }
+
+    ASSERT_EQ(profile.GetPercentileTimeNs(0.0), 127u);
+    ASSERT_EQ(profile.GetPercentileTimeNs(50.0), 127u);
+    ASSERT_EQ(profile.GetPercentileTimeNs(90.0), 127u);
+    ASSERT_EQ(profile.GetPercentileTimeNs(99.0), 8191u);
+    ASSERT_EQ(profile.GetPercentileTimeNs(100.0), 8191u);
+}
+
+// Test that a zero duration gets its own bucket
+TEST(ProcProfiler, ZeroDuration) {
+    EntryPointProfile profile("nxtTestEntryPoint");
+    profile.RecordCall(0, false);
+    ASSERT_EQ(profile.GetPercentileTimeNs(100.0), 0u);
+}
+
+// Test that calls recorded concurrently on several threads are all counted
+TEST(ProcProfiler, ConcurrentCalls) {
+    constexpr uint32_t kThreadCount = 4;
+    constexpr uint32_t kCallsPerThread = 10000;
+
+    EntryPointProfile profile("nxtTestEntryPoint");
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kThreadCount; ++i) {
+        threads.emplace_back([&profile]() {
+            for (uint32_t j = 0; j < kCallsPerThread; ++j) {
+                profile.RecordCall(100, j % 2 == 0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(profile.GetCallCount(), kThreadCount * kCallsPerThread);
+    ASSERT_EQ(profile.GetValidationFailureCount(), kThreadCount * kCallsPerThread / 2);
+    ASSERT_EQ(profile.GetTotalTimeNs(), 100u * kThreadCount * kCallsPerThread);
+    ASSERT_EQ(profile.GetPercentileTimeNs(100.0), 127u);
+}
@@ -16,6 +16,9 @@
 
 #include "backend/RefCounted.h"
 
+#include <thread>
+#include <vector>
+
 using namespace backend;
 
 struct RCTest : public RefCounted {
@@ -78,6 +81,48 @@ TEST(RefCounted, AddExternalRefFromZero) {
     ASSERT_TRUE(deleted);
 }
 
+// Test that TryReferenceInternal only succeeds while the RC is alive
+TEST(RefCounted, TryReferenceInternal) {
+    bool deleted = false;
+    auto test = new RCTest(&deleted);
+
+    ASSERT_TRUE(test->TryReferenceInternal());
+    ASSERT_EQ(test->GetInternalRefs(), 2u);
+
+    test->Release();
+    ASSERT_FALSE(deleted);
+    test->ReleaseInternal();
+    ASSERT_TRUE(deleted);
+}
+
+// Test that references and releases from multiple threads are balanced
+TEST(RefCounted, MultithreadedReferences) {
+    bool deleted = false;
+    auto test = new RCTest(&deleted);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < 4; ++i) {
+        threads.emplace_back([test]() {
+            for (uint32_t j = 0; j < 10000; ++j) {
+                test->Reference();
+                test->ReferenceInternal();
+                test->ReleaseInternal();
+                test->Release();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(test->GetExternalRefs(), 1u);
+    ASSERT_EQ(test->GetInternalRefs(), 1u);
+    ASSERT_FALSE(deleted);
+
+    test->Release();
+    ASSERT_TRUE(deleted);
+}
+
 // Test Ref remove internal reference when going out of scope
 TEST(Ref, EndOfScopeRemovesInternalRef) {
     bool deleted = false;
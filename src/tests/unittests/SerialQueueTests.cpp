@@ -16,6 +16,8 @@
 
 #include "common/SerialQueue.h"
 
+#include <memory>
+
 using TestSerialQueue = SerialQueue<int>;
 
 // A number of basic tests for SerialQueue that are difficult to split from one another
@@ -141,3 +143,48 @@ TEST(SerialQueue, FirstSerial) {
     queue.Enqueue(vector1, 6);
     EXPECT_EQ(queue.FirstSerial(), 6);
 }
+
+// Test that values stay in order when the ring buffer wraps around and grows while it isn't empty
+TEST(SerialQueue, WrapAroundAndGrow) {
+    TestSerialQueue queue;
+
+    int nextValue = 0;
+    int nextExpectedValue = 0;
+    for (Serial serial = 0; serial < 100; ++serial) {
+        // Enqueue a growing number of values per serial and retire the oldest serials so that
+        // the front of the ring moves forward between the growths.
+        for (int i = 0; i < static_cast<int>(serial % 7) + 1; ++i) {
+            queue.Enqueue(nextValue++, serial);
+        }
+
+        if (serial >= 3) {
+            for (int value : queue.IterateUpTo(serial - 3)) {
+                EXPECT_EQ(nextExpectedValue++, value);
+            }
+            queue.ClearUpTo(serial - 3);
+            EXPECT_EQ(serial - 2, queue.FirstSerial());
+        }
+    }
+
+    for (int value : queue.IterateAll()) {
+        EXPECT_EQ(nextExpectedValue++, value);
+    }
+    EXPECT_EQ(nextValue, nextExpectedValue);
+}
+
+// Test that clearing values destroys them
+TEST(SerialQueue, ClearDestroysValues) {
+    SerialQueue<std::shared_ptr<int>> queue;
+    std::shared_ptr<int> value = std::make_shared<int>(0);
+
+    queue.Enqueue(value, 0);
+    queue.Enqueue(value, 1);
+    queue.Enqueue(value, 2);
+    EXPECT_EQ(4, value.use_count());
+
+    queue.ClearUpTo(1);
+    EXPECT_EQ(2, value.use_count());
+
+    queue.Clear();
+    EXPECT_EQ(1, value.use_count());
+}
@@ -0,0 +1,144 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "backend/RefCounted.h"
+#include "backend/SlabAllocator.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace backend;
+
+// Test that freed slots are reused and that the live count is tracked
+TEST(SlabAllocator, ReuseAndLiveCount) {
+    SlabAllocator allocator("Test");
+
+    void* first = allocator.Allocate(24);
+    void* second = allocator.Allocate(24);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(allocator.GetStats().liveCount, 2u);
+
+    allocator.Deallocate(first, 24);
+    ASSERT_EQ(allocator.GetStats().liveCount, 1u);
+    ASSERT_EQ(allocator.Allocate(24), first);
+
+    allocator.Deallocate(first, 24);
+    allocator.Deallocate(second, 24);
+
+    SlabAllocatorStats stats = allocator.GetStats();
+    ASSERT_EQ(stats.liveCount, 0u);
+    ASSERT_EQ(stats.allocationCount, 3u);
+    ASSERT_EQ(stats.slabCount, 1u);
+}
+
+// Test that different sizes don't share slots and that new slabs are allocated when full
+TEST(SlabAllocator, SizeClassesAndGrowth) {
+    SlabAllocator allocator("Test");
+
+    std::vector<void*> small;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        small.push_back(allocator.Allocate(16));
+        memset(small.back(), 0xFF, 16);
+    }
+    void* large = allocator.Allocate(500);
+    memset(large, 0, 500);
+
+    // The large allocation didn't overwrite the small ones.
+    for (void* ptr : small) {
+        ASSERT_EQ(*static_cast<uint8_t*>(ptr), 0xFF);
+        ASSERT_NE(ptr, large);
+    }
+    ASSERT_GT(allocator.GetStats().slabCount, 2u);
+
+    for (void* ptr : small) {
+        allocator.Deallocate(ptr, 16);
+    }
+    allocator.Deallocate(large, 500);
+    ASSERT_EQ(allocator.GetStats().liveCount, 0u);
+}
+
+namespace {
+    class PooledObject : public RefCounted, public SlabAllocated<PooledObject> {
+      public:
+        static constexpr const char* kSlabAllocatorName = "PooledObjectForTest";
+    };
+
+    SlabAllocatorStats GetPooledObjectStats() {
+        for (const SlabAllocatorStats& stats : GetSlabAllocatorStats()) {
+            if (strcmp(stats.name, PooledObject::kSlabAllocatorName) == 0) {
+                return stats;
+            }
+        }
+        return {};
+    }
+}  // anonymous namespace
+
+// Test that RefCounted objects deleted by ReleaseInternal go back to their slab allocator
+TEST(SlabAllocator, RefCountedObjects) {
+    PooledObject* object = new PooledObject;
+    ASSERT_EQ(GetPooledObjectStats().liveCount, 1u);
+
+    object->Release();
+    ASSERT_EQ(GetPooledObjectStats().liveCount, 0u);
+
+    PooledObject* other = new PooledObject;
+    ASSERT_EQ(other, object);
+    other->Release();
+    ASSERT_EQ(GetPooledObjectStats().allocationCount, 2u);
+}
+
+// Test that objects allocated through the thread caches are distinct and that the slots cached by
+// the threads are given back when they exit
+TEST(SlabAllocator, ThreadCaches) {
+    SlabAllocator* allocator = RegisterSlabAllocator("ThreadCachesTest");
+    constexpr uint32_t kThreadCount = 4;
+    constexpr uint32_t kAllocationsPerThread = 1000;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([allocator, t]() {
+            std::vector<void*> allocations;
+            for (uint32_t i = 0; i < kAllocationsPerThread; ++i) {
+                allocations.push_back(allocator->Allocate(32));
+                memset(allocations.back(), static_cast<int>(t), 32);
+            }
+            for (void* ptr : allocations) {
+                ASSERT_EQ(*static_cast<uint8_t*>(ptr), t);
+                allocator->Deallocate(ptr, 32);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    SlabAllocatorStats stats = allocator->GetStats();
+    ASSERT_EQ(stats.liveCount, 0u);
+    ASSERT_EQ(stats.allocationCount, kThreadCount * kAllocationsPerThread);
+
+    // Each thread had this many objects live at once and the slots they kept are back in the
+    // free lists so no slab is needed for these.
+    uint64_t slabCount = stats.slabCount;
+    std::vector<void*> allocations;
+    for (uint32_t i = 0; i < kAllocationsPerThread; ++i) {
+        allocations.push_back(allocator->Allocate(32));
+    }
+    ASSERT_EQ(allocator->GetStats().slabCount, slabCount);
+    for (void* ptr : allocations) {
+        allocator->Deallocate(ptr, 32);
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/Trace.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+    size_t CountOccurences(const std::string& haystack, const std::string& needle) {
+        size_t count = 0;
+        for (size_t pos = haystack.find(needle); pos != std::string::npos;
+             pos = haystack.find(needle, pos + 1)) {
+            count++;
+        }
+        return count;
+    }
+
+    std::string Flush() {
+        std::ostringstream stream;
+        FlushTraceEvents(stream);
+        return stream.str();
+    }
+
+}  // anonymous namespace
+
+class TraceTests : public testing::Test {
+  protected:
+    void SetUp() override {
+        // Discard events left by other tests.
+        Flush();
+    }
+
+    void TearDown() override {
+        StopTracing();
+    }
+};
+
+// Test that no events are recorded while tracing is disabled
+TEST_F(TraceTests, DisabledRecordsNothing) {
+    {
+        NXT_TRACE_SCOPE("Disabled");
+    }
+    ASSERT_EQ(Flush(), "");
+}
+
+// Test that scopes produce complete events and that flushing consumes them
+TEST_F(TraceTests, ScopeEvents) {
+    StartTracing();
+    {
+        NXT_TRACE_SCOPE("Outer");
+        NXT_TRACE_SCOPE("Inner");
+    }
+    StopTracing();
+
+    std::string events = Flush();
+    ASSERT_EQ(CountOccurences(events, "\"name\":\"Outer\""), 1u);
+    ASSERT_EQ(CountOccurences(events, "\"name\":\"Inner\""), 1u);
+    ASSERT_EQ(CountOccurences(events, "\"ph\":\"X\""), 2u);
+
+    ASSERT_EQ(Flush(), "");
+}
+
+// Test that events of other threads are flushed with a different thread id
+TEST_F(TraceTests, MultipleThreads) {
+    StartTracing();
+    {
+        NXT_TRACE_SCOPE("MainThread");
+    }
+    std::thread thread([]() { NXT_TRACE_SCOPE("OtherThread"); });
+    thread.join();
+    StopTracing();
+
+    std::string events = Flush();
+    size_t mainTid = events.find("\"tid\":", events.find("MainThread"));
+    size_t otherTid = events.find("\"tid\":", events.find("OtherThread"));
+    ASSERT_NE(mainTid, std::string::npos);
+    ASSERT_NE(otherTid, std::string::npos);
+    ASSERT_NE(events.substr(mainTid, events.find('}', mainTid) - mainTid),
+              events.substr(otherTid, events.find('}', otherTid) - otherTid));
+}
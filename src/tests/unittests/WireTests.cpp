@@ -337,6 +337,42 @@ TEST_F(WireTests, ObjectsAsPointerArgument) {
     FlushClient();
 }
 
+// Test that nullptr elements of arrays of objects are sent as nullptr
+TEST_F(WireTests, NullObjectsInPointerArgument) {
+    nxtCommandBufferBuilder cmdBufBuilder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBuffer cmdBuf = nxtCommandBufferBuilderGetResult(cmdBufBuilder);
+
+    nxtCommandBufferBuilder apiCmdBufBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiCmdBufBuilder));
+
+    nxtCommandBuffer apiCmdBuf = api.GetNewCommandBuffer();
+    EXPECT_CALL(api, CommandBufferBuilderGetResult(apiCmdBufBuilder))
+        .WillOnce(Return(apiCmdBuf));
+
+    nxtQueueBuilder queueBuilder = nxtDeviceCreateQueueBuilder(device);
+    nxtQueue queue = nxtQueueBuilderGetResult(queueBuilder);
+
+    nxtQueueBuilder apiQueueBuilder = api.GetNewQueueBuilder();
+    EXPECT_CALL(api, DeviceCreateQueueBuilder(apiDevice))
+        .WillOnce(Return(apiQueueBuilder));
+
+    nxtQueue apiQueue = api.GetNewQueue();
+    EXPECT_CALL(api, QueueBuilderGetResult(apiQueueBuilder))
+        .WillOnce(Return(apiQueue));
+
+    nxtCommandBuffer cmdBufs[2] = {nullptr, cmdBuf};
+    nxtQueueSubmit(queue, 2, cmdBufs);
+
+    AreAPICmdBufs predicate;
+    predicate.apiCmdBufs[0] = nullptr;
+    predicate.apiCmdBufs[1] = apiCmdBuf;
+
+    EXPECT_CALL(api, QueueSubmit(apiQueue, 2, ResultOf(predicate, Eq(true))));
+
+    FlushClient();
+}
+
 // Test that the server doesn't forward calls to error objects or with error objects
 // Also test that when GetResult is called on an error builder, the error callback is fired
 TEST_F(WireTests, CallsSkippedAfterBuilderError) {
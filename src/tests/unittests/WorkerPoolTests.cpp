@@ -0,0 +1,54 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "common/WorkerPool.h"
+
+#include <atomic>
+
+// Test that the future returned by PostTask becomes ready after the task ran.
+TEST(WorkerPool, FutureWaitsForTask) {
+    WorkerPool pool(2);
+    ASSERT_EQ(2u, pool.GetThreadCount());
+
+    bool ran = false;
+    std::future<void> future = pool.PostTask([&ran]() { ran = true; });
+    future.wait();
+    ASSERT_TRUE(ran);
+}
+
+// Test that WaitIdle waits for all the posted tasks.
+TEST(WorkerPool, WaitIdle) {
+    WorkerPool pool(4);
+
+    std::atomic<uint32_t> count(0);
+    for (uint32_t i = 0; i < 100; ++i) {
+        pool.PostTask([&count]() { count++; });
+    }
+    pool.WaitIdle();
+    ASSERT_EQ(100u, count.load());
+}
+
+// Test that the destructor runs the tasks remaining in the queue.
+TEST(WorkerPool, DestructorRunsRemainingTasks) {
+    std::atomic<uint32_t> count(0);
+    {
+        WorkerPool pool(1);
+        for (uint32_t i = 0; i < 10; ++i) {
+            pool.PostTask([&count]() { count++; });
+        }
+    }
+    ASSERT_EQ(10u, count.load());
+}
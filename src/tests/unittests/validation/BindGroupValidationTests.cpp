@@ -103,3 +103,51 @@ TEST_F(BindGroupValidationTest, BufferViewOffset) {
             .GetResult();
     }
 }
+
+// Test the builder-free creation of bind groups from the layout
+TEST_F(BindGroupValidationTest, CreateBindGroup) {
+    auto layout = device.CreateBindGroupLayoutBuilder()
+        .SetBindingsType(nxt::ShaderStageBit::Vertex, nxt::BindingType::UniformBuffer, 0, 2)
+        .GetResult();
+
+    auto buffer = device.CreateBufferBuilder()
+        .SetAllowedUsage(nxt::BufferUsageBit::Uniform)
+        .SetInitialUsage(nxt::BufferUsageBit::Uniform)
+        .SetSize(512)
+        .GetResult();
+    nxt::BufferView bufferView = buffer.CreateBufferView(0, 256);
+
+    nxt::BufferView bufferViews[2] = {bufferView.Clone(), bufferView.Clone()};
+    nxt::Sampler samplers[2];
+    nxt::TextureView textureViews[2];
+
+    // Success when all the bindings are set
+    {
+        nxt::BindGroup bindGroup = layout.CreateBindGroup(nxt::BindGroupUsage::Frozen, 2,
+                                                          bufferViews, samplers, textureViews);
+        ASSERT_NE(bindGroup.Get(), nullptr);
+    }
+
+    // Error when a binding of the layout isn't set
+    {
+        nxt::BindGroup bindGroup;
+        ASSERT_DEVICE_ERROR(bindGroup = layout.CreateBindGroup(nxt::BindGroupUsage::Frozen, 1,
+                                                               bufferViews, samplers,
+                                                               textureViews));
+        ASSERT_EQ(bindGroup.Get(), nullptr);
+    }
+
+    // Error when a binding isn't in the layout
+    {
+        nxt::BufferView tooManyBufferViews[3] = {bufferView.Clone(), bufferView.Clone(),
+                                                 bufferView.Clone()};
+        nxt::Sampler tooManySamplers[3];
+        nxt::TextureView tooManyTextureViews[3];
+
+        nxt::BindGroup bindGroup;
+        ASSERT_DEVICE_ERROR(bindGroup = layout.CreateBindGroup(
+                                nxt::BindGroupUsage::Frozen, 3, tooManyBufferViews,
+                                tooManySamplers, tooManyTextureViews));
+        ASSERT_EQ(bindGroup.Get(), nullptr);
+    }
+}
@@ -103,6 +103,27 @@ TEST_F(BufferValidationTest, CreationSuccess) {
     }
 }
 
+// Test the builder-free creation of buffer views
+TEST_F(BufferValidationTest, CreateBufferView) {
+    nxt::Buffer buf = device.CreateBufferBuilder()
+        .SetSize(4)
+        .SetAllowedUsage(nxt::BufferUsageBit::Uniform)
+        .GetResult();
+
+    // Success
+    {
+        nxt::BufferView view = buf.CreateBufferView(0, 4);
+        ASSERT_NE(view.Get(), nullptr);
+    }
+
+    // Errors in the extent are device errors and return nullptr
+    {
+        nxt::BufferView view;
+        ASSERT_DEVICE_ERROR(view = buf.CreateBufferView(2, 4));
+        ASSERT_EQ(view.Get(), nullptr);
+    }
+}
+
 // Test failure when specifying properties multiple times
 TEST_F(BufferValidationTest, CreationDuplicates) {
     // When size is specified multiple times
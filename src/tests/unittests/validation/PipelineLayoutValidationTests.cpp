@@ -0,0 +1,59 @@
+// Copyright 2018 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+class PipelineLayoutValidationTest : public ValidationTest {
+    protected:
+        nxt::BindGroupLayout CreateBindGroupLayout(nxt::BindingType type) {
+            return device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Vertex, type, 0, 1)
+                .GetResult();
+        }
+
+        nxt::PipelineLayout CreatePipelineLayout(const nxt::BindGroupLayout& layout) {
+            return AssertWillBeSuccess(device.CreatePipelineLayoutBuilder())
+                .SetBindGroupLayout(0, layout)
+                .GetResult();
+        }
+};
+
+// Test that pipeline layouts with the same bind group layouts are the same object
+TEST_F(PipelineLayoutValidationTest, Deduplication) {
+    nxt::BindGroupLayout uniformLayout = CreateBindGroupLayout(nxt::BindingType::UniformBuffer);
+    nxt::BindGroupLayout storageLayout = CreateBindGroupLayout(nxt::BindingType::StorageBuffer);
+
+    nxt::PipelineLayout layout1 = CreatePipelineLayout(uniformLayout);
+    nxt::PipelineLayout layout2 = CreatePipelineLayout(uniformLayout);
+    nxt::PipelineLayout otherLayout = CreatePipelineLayout(storageLayout);
+
+    ASSERT_EQ(layout1.Get(), layout2.Get());
+    ASSERT_NE(layout1.Get(), otherLayout.Get());
+
+    // An empty pipeline layout is different from one with a bind group layout set.
+    nxt::PipelineLayout emptyLayout = AssertWillBeSuccess(device.CreatePipelineLayoutBuilder())
+        .GetResult();
+    ASSERT_NE(layout1.Get(), emptyLayout.Get());
+}
+
+// Test that a deduplicated pipeline layout can be created again after it is destroyed
+TEST_F(PipelineLayoutValidationTest, RecreateAfterDestruction) {
+    nxt::BindGroupLayout uniformLayout = CreateBindGroupLayout(nxt::BindingType::UniformBuffer);
+
+    {
+        nxt::PipelineLayout layout = CreatePipelineLayout(uniformLayout);
+    }
+    nxt::PipelineLayout layout = CreatePipelineLayout(uniformLayout);
+    ASSERT_NE(layout.Get(), nullptr);
+}
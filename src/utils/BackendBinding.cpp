@@ -38,6 +38,42 @@ namespace utils {
         mWindow = window;
     }
 
+    bool BackendBinding::GetBackendCallCounts(uint64_t*, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::GetMemoryHeapStats(uint32_t, uint64_t*, uint64_t*, float*) {
+        return false;
+    }
+
+    bool BackendBinding::GetFramebufferCacheCounts(uint64_t*, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::GetRenderPassCacheCounts(uint64_t*, uint64_t*, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::GetPipelineBarrierCount(nxtCommandBuffer, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::SetSubmitCoalescing(uint32_t, uint64_t) {
+        return false;
+    }
+
+    bool BackendBinding::GetSubmitCounts(uint64_t*, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::GetSerials(uint64_t*, uint64_t*) {
+        return false;
+    }
+
+    bool BackendBinding::WaitForSerial(uint64_t, uint64_t) {
+        return false;
+    }
+
     BackendBinding* CreateBinding(BackendType type) {
         switch (type) {
 #if defined(NXT_ENABLE_BACKEND_D3D12)
@@ -40,6 +40,42 @@ namespace utils {
         virtual uint64_t GetSwapChainImplementation() = 0;
         virtual nxtTextureFormat GetPreferredSwapChainTextureFormat() = 0;
 
+        // Returns the number of backend state-setting calls made and skipped since the device was
+        // created, or false if the backend doesn't track them.
+        virtual bool GetBackendCallCounts(uint64_t* issued, uint64_t* skipped);
+        // Returns the bytes of device memory allocated from the heap, the bytes of it used by
+        // resources and how fragmented its free space is, or false if the backend doesn't track
+        // them or there is no heap with this index.
+        virtual bool GetMemoryHeapStats(uint32_t heapIndex,
+                                        uint64_t* allocatedBytes,
+                                        uint64_t* usedBytes,
+                                        float* fragmentation);
+        // Returns the number of framebuffer lookups that reused a framebuffer or had to create
+        // one, or false if the backend doesn't cache framebuffers.
+        virtual bool GetFramebufferCacheCounts(uint64_t* hits, uint64_t* misses);
+        // Same as GetFramebufferCacheCounts for render passes, with the number of render passes
+        // evicted from the cache.
+        virtual bool GetRenderPassCacheCounts(uint64_t* hits,
+                                              uint64_t* misses,
+                                              uint64_t* evictions);
+        // Returns the number of pipeline barriers recorded for the last submit of commandBuffer,
+        // or false if the backend doesn't record pipeline barriers.
+        virtual bool GetPipelineBarrierCount(nxtCommandBuffer commandBuffer, uint64_t* count);
+        // Makes Tick submit the pending uploads only once uploadCount of them or uploadBytes bytes
+        // of them are pending, a threshold of 0 being ignored. Returns false if the backend
+        // doesn't coalesce submits or both thresholds are 0.
+        virtual bool SetSubmitCoalescing(uint32_t uploadCount, uint64_t uploadBytes);
+        // Returns the number of submits to the GPU queue since the device was created and during
+        // the last presented frame, or false if the backend doesn't count them.
+        virtual bool GetSubmitCounts(uint64_t* total, uint64_t* lastFrame);
+        // Returns the serial of the last submit to the GPU queue and of the last one that
+        // completed, or false if the backend doesn't track them.
+        virtual bool GetSerials(uint64_t* lastSubmitted, uint64_t* completed);
+        // Blocks until the submit with the given serial has completed on the GPU or timeoutNs
+        // nanoseconds have passed. Returns whether the serial completed, which is always false
+        // if the backend doesn't track serials.
+        virtual bool WaitForSerial(uint64_t serial, uint64_t timeoutNs);
+
         void SetWindow(GLFWwindow* window);
 
       protected:
@@ -26,6 +26,8 @@ namespace backend { namespace d3d12 {
 
     nxtSwapChainImplementation CreateNativeSwapChainImpl(nxtDevice device, HWND window);
     nxtTextureFormat GetNativeSwapChainPreferredFormat(const nxtSwapChainImplementation* swapChain);
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed);
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs);
 }}  // namespace backend::d3d12
 
 namespace utils {
@@ -55,6 +57,15 @@ namespace utils {
             return backend::d3d12::GetNativeSwapChainPreferredFormat(&mSwapchainImpl);
         }
 
+        bool GetSerials(uint64_t* lastSubmitted, uint64_t* completed) override {
+            backend::d3d12::GetSerials(mBackendDevice, lastSubmitted, completed);
+            return true;
+        }
+
+        bool WaitForSerial(uint64_t serial, uint64_t timeoutNs) override {
+            return backend::d3d12::WaitForSerial(mBackendDevice, serial, timeoutNs);
+        }
+
       private:
         nxtDevice mBackendDevice = nullptr;
         nxtSwapChainImplementation mSwapchainImpl = {};
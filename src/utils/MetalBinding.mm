@@ -29,6 +29,8 @@ namespace backend { namespace metal {
     void Init(id<MTLDevice> metalDevice, nxtProcTable* procs, nxtDevice* device);
     void SetNextDrawable(nxtDevice device, id<CAMetalDrawable> drawable);
     void Present(nxtDevice device);
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed);
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs);
 }}
 
 namespace utils {
@@ -133,6 +135,15 @@ namespace utils {
             return NXT_TEXTURE_FORMAT_B8_G8_R8_A8_UNORM;
         }
 
+        bool GetSerials(uint64_t* lastSubmitted, uint64_t* completed) override {
+            backend::metal::GetSerials(mBackendDevice, lastSubmitted, completed);
+            return true;
+        }
+
+        bool WaitForSerial(uint64_t serial, uint64_t timeoutNs) override {
+            return backend::metal::WaitForSerial(mBackendDevice, serial, timeoutNs);
+        }
+
       private:
         id<MTLDevice> mMetalDevice = nil;
         nxtDevice mBackendDevice = nullptr;
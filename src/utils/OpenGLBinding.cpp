@@ -27,6 +27,9 @@
 
 namespace backend { namespace opengl {
     void Init(void* (*getProc)(const char*), nxtProcTable* procs, nxtDevice* device);
+    void GetGLStateCallCounts(nxtDevice device, uint64_t* issued, uint64_t* skipped);
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed);
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs);
 }}  // namespace backend::opengl
 
 namespace utils {
@@ -130,6 +133,20 @@ namespace utils {
             return NXT_TEXTURE_FORMAT_R8_G8_B8_A8_UNORM;
         }
 
+        bool GetBackendCallCounts(uint64_t* issued, uint64_t* skipped) override {
+            backend::opengl::GetGLStateCallCounts(mBackendDevice, issued, skipped);
+            return true;
+        }
+
+        bool GetSerials(uint64_t* lastSubmitted, uint64_t* completed) override {
+            backend::opengl::GetSerials(mBackendDevice, lastSubmitted, completed);
+            return true;
+        }
+
+        bool WaitForSerial(uint64_t serial, uint64_t timeoutNs) override {
+            return backend::opengl::WaitForSerial(mBackendDevice, serial, timeoutNs);
+        }
+
       private:
         nxtDevice mBackendDevice = nullptr;
         nxtSwapChainImplementation mSwapchainImpl = {};
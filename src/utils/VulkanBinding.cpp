@@ -20,6 +20,8 @@
 
 #include "GLFW/glfw3.h"
 
+#include <cstdlib>
+#include <iostream>
 #include <vector>
 
 namespace backend { namespace vulkan {
@@ -28,6 +30,27 @@ namespace backend { namespace vulkan {
               const std::vector<const char*>& requiredInstanceExtensions);
 
     VkInstance GetInstance(nxtDevice device);
+    void SetPipelineCachePath(nxtDevice device, const char* path);
+    void SetAsyncPipelineCompilation(nxtDevice device, bool enabled);
+    void SetParallelCommandRecording(nxtDevice device, bool enabled);
+    bool GetMemoryHeapStats(nxtDevice device,
+                            uint32_t heapIndex,
+                            uint64_t* allocatedBytes,
+                            uint64_t* usedBytes,
+                            float* fragmentation);
+    void GetFramebufferCacheCounts(nxtDevice device, uint64_t* hits, uint64_t* misses);
+    void GetRenderPassCacheCounts(nxtDevice device,
+                                  uint64_t* hits,
+                                  uint64_t* misses,
+                                  uint64_t* evictions);
+    uint32_t GetPipelineBarrierCount(nxtCommandBuffer commandBuffer);
+    bool SetSubmitCoalescing(nxtDevice device,
+                             bool enabled,
+                             uint32_t uploadCount,
+                             uint64_t uploadBytes);
+    void GetSubmitCounts(nxtDevice device, uint64_t* total, uint64_t* lastFrame);
+    void GetSerials(nxtDevice device, uint64_t* lastSubmitted, uint64_t* completed);
+    bool WaitForSerial(nxtDevice device, uint64_t serial, uint64_t timeoutNs);
 
     nxtSwapChainImplementation CreateNativeSwapChainImpl(nxtDevice device, VkSurfaceKHR surface);
     nxtTextureFormat GetNativeSwapChainPreferredFormat(const nxtSwapChainImplementation* swapChain);
@@ -75,6 +98,30 @@ namespace utils {
 
             backend::vulkan::Init(procs, device, requiredExtensions);
             mDevice = *device;
+
+            // Reuse the compiled pipelines between runs if asked to.
+            const char* pipelineCachePath = getenv("NXT_VULKAN_PIPELINE_CACHE");
+            if (pipelineCachePath != nullptr) {
+                backend::vulkan::SetPipelineCachePath(mDevice, pipelineCachePath);
+            }
+            if (getenv("NXT_VULKAN_ASYNC_PIPELINES") != nullptr) {
+                backend::vulkan::SetAsyncPipelineCompilation(mDevice, true);
+            }
+            if (getenv("NXT_VULKAN_PARALLEL_RECORDING") != nullptr) {
+                backend::vulkan::SetParallelCommandRecording(mDevice, true);
+            }
+
+            // Submit the uploads in batches, the value is "<uploadCount>[,<uploadBytes>]".
+            const char* submitCoalescing = getenv("NXT_VULKAN_SUBMIT_COALESCING");
+            if (submitCoalescing != nullptr) {
+                char* end = nullptr;
+                uint32_t uploadCount = static_cast<uint32_t>(strtoul(submitCoalescing, &end, 10));
+                uint64_t uploadBytes = *end == ',' ? strtoull(end + 1, nullptr, 10) : 0;
+                if (!SetSubmitCoalescing(uploadCount, uploadBytes)) {
+                    std::cerr << "Ignoring NXT_VULKAN_SUBMIT_COALESCING=" << submitCoalescing
+                              << ", it needs a non-zero upload count or size" << std::endl;
+                }
+            }
         }
         uint64_t GetSwapChainImplementation() override {
             if (mSwapchainImpl.userData == nullptr) {
@@ -92,6 +139,43 @@ namespace utils {
             ASSERT(mSwapchainImpl.userData != nullptr);
             return backend::vulkan::GetNativeSwapChainPreferredFormat(&mSwapchainImpl);
         }
+        bool GetMemoryHeapStats(uint32_t heapIndex,
+                                uint64_t* allocatedBytes,
+                                uint64_t* usedBytes,
+                                float* fragmentation) override {
+            return backend::vulkan::GetMemoryHeapStats(mDevice, heapIndex, allocatedBytes,
+                                                       usedBytes, fragmentation);
+        }
+        bool GetFramebufferCacheCounts(uint64_t* hits, uint64_t* misses) override {
+            backend::vulkan::GetFramebufferCacheCounts(mDevice, hits, misses);
+            return true;
+        }
+        bool GetRenderPassCacheCounts(uint64_t* hits,
+                                      uint64_t* misses,
+                                      uint64_t* evictions) override {
+            backend::vulkan::GetRenderPassCacheCounts(mDevice, hits, misses, evictions);
+            return true;
+        }
+        bool GetPipelineBarrierCount(nxtCommandBuffer commandBuffer, uint64_t* count) override {
+            *count = backend::vulkan::GetPipelineBarrierCount(commandBuffer);
+            return true;
+        }
+        bool SetSubmitCoalescing(uint32_t uploadCount, uint64_t uploadBytes) override {
+            return backend::vulkan::SetSubmitCoalescing(mDevice, true, uploadCount, uploadBytes);
+        }
+        bool GetSubmitCounts(uint64_t* total, uint64_t* lastFrame) override {
+            backend::vulkan::GetSubmitCounts(mDevice, total, lastFrame);
+            return true;
+        }
+
+        bool GetSerials(uint64_t* lastSubmitted, uint64_t* completed) override {
+            backend::vulkan::GetSerials(mDevice, lastSubmitted, completed);
+            return true;
+        }
+
+        bool WaitForSerial(uint64_t serial, uint64_t timeoutNs) override {
+            return backend::vulkan::WaitForSerial(mDevice, serial, timeoutNs);
+        }
 
       private:
         nxtDevice mDevice;